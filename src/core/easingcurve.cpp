@@ -1,33 +1,89 @@
 #include "easingcurve.hpp"
+#include <algorithm>
+#include <cmath>
 #include <utility>
 
+#include <qcontainerfwd.h>
 #include <qeasingcurve.h>
+#include <qlist.h>
 #include <qpoint.h>
 #include <qrect.h>
 #include <qtmetamacros.h>
 #include <qtypes.h>
 
-qreal EasingCurve::valueAt(qreal x) const { return this->mCurve.valueForProgress(x); }
+qreal EasingCurve::valueAt(qreal x) const {
+	// NaN passes through clamp and can't be used as a table index
+	if (this->mLookupTable.isEmpty() || std::isnan(x)) return this->mCurve.valueForProgress(x);
+
+	// valueForProgress clamps its input, so the table has to as well.
+	auto pos = std::clamp(x, static_cast<qreal>(0), static_cast<qreal>(1)) * this->mLookupResolution;
+	auto i = static_cast<qsizetype>(pos);
+	if (i >= this->mLookupResolution) return this->mLookupTable.last();
+
+	return EasingCurve::lerp(pos - i, this->mLookupTable.at(i), this->mLookupTable.at(i + 1));
+}
+
+QList<qreal> EasingCurve::valuesAt(const QList<qreal>& x) const {
+	auto values = QList<qreal>();
+	values.reserve(x.length());
+
+	for (auto v: x) {
+		values.push_back(this->valueAt(v));
+	}
+
+	return values;
+}
 
 qreal EasingCurve::interpolate(qreal x, qreal a, qreal b) const {
-	return a + (b - a) * this->valueAt(x);
+	return EasingCurve::lerp(this->valueAt(x), a, b);
 }
 
 QPointF EasingCurve::interpolate(qreal x, const QPointF& a, const QPointF& b) const {
-	return QPointF(this->interpolate(x, a.x(), b.x()), this->interpolate(x, a.y(), b.y()));
+	return EasingCurve::lerp(this->valueAt(x), a, b);
 }
 
 QRectF EasingCurve::interpolate(qreal x, const QRectF& a, const QRectF& b) const {
+	auto y = this->valueAt(x);
+
 	return QRectF(
-	    this->interpolate(x, a.topLeft(), b.topLeft()),
-	    this->interpolate(x, a.bottomRight(), b.bottomRight())
+	    EasingCurve::lerp(y, a.topLeft(), b.topLeft()),
+	    EasingCurve::lerp(y, a.bottomRight(), b.bottomRight())
 	);
 }
 
+qreal EasingCurve::lerp(qreal y, qreal a, qreal b) { return a + (b - a) * y; }
+
+QPointF EasingCurve::lerp(qreal y, const QPointF& a, const QPointF& b) {
+	return QPointF(EasingCurve::lerp(y, a.x(), b.x()), EasingCurve::lerp(y, a.y(), b.y()));
+}
+
 QEasingCurve EasingCurve::curve() const { return this->mCurve; }
 
 void EasingCurve::setCurve(QEasingCurve curve) {
 	if (this->mCurve == curve) return;
 	this->mCurve = std::move(curve);
+	this->updateLookupTable();
 	emit this->curveChanged();
 }
+
+qint32 EasingCurve::lookupResolution() const { return this->mLookupResolution; }
+
+void EasingCurve::setLookupResolution(qint32 lookupResolution) {
+	lookupResolution = std::max(lookupResolution, 0);
+	if (lookupResolution == this->mLookupResolution) return;
+	this->mLookupResolution = lookupResolution;
+	this->updateLookupTable();
+	emit this->lookupResolutionChanged();
+}
+
+void EasingCurve::updateLookupTable() {
+	this->mLookupTable.clear();
+	if (this->mLookupResolution == 0) return;
+
+	this->mLookupTable.reserve(this->mLookupResolution + 1);
+
+	for (auto i = 0; i <= this->mLookupResolution; i++) {
+		auto x = static_cast<qreal>(i) / this->mLookupResolution;
+		this->mLookupTable.push_back(this->mCurve.valueForProgress(x));
+	}
+}
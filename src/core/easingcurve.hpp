@@ -1,19 +1,34 @@
 #pragma once
 
+#include <qcontainerfwd.h>
 #include <qeasingcurve.h>
 #include <qobject.h>
 #include <qpoint.h>
 #include <qqmlintegration.h>
 #include <qrect.h>
 #include <qtmetamacros.h>
+#include <qtypes.h>
 
 ///! Easing curve.
 /// Directly accessible easing curve as used in property animations.
 class EasingCurve: public QObject {
 	Q_OBJECT;
+	// clang-format off
 	/// Easing curve settings. Works exactly the same as
 	/// [PropertyAnimation.easing](https://doc.qt.io/qt-6/qml-qtquick-propertyanimation.html#easing-prop).
 	Q_PROPERTY(QEasingCurve curve READ curve WRITE setCurve NOTIFY curveChanged);
+	/// Number of segments in the precomputed lookup table. Defaults to 0 (disabled).
+	///
+	/// When greater than zero the curve is sampled `lookupResolution + 1` times
+	/// whenever it changes, and values are linearly interpolated from the table
+	/// instead of being recomputed by the curve. This is considerably faster for
+	/// complex curves evaluated many times per frame, at the cost of a small
+	/// approximation error which shrinks as the resolution grows.
+	///
+	/// > [!INFO] Curves with discontinuities such as bounce curves will be smoothed
+	/// > between samples. Use a higher resolution if this is noticeable.
+	Q_PROPERTY(qint32 lookupResolution READ lookupResolution WRITE setLookupResolution NOTIFY lookupResolutionChanged);
+	// clang-format on
 	QML_ELEMENT;
 
 public:
@@ -22,6 +37,11 @@ public:
 	/// Returns the Y value for the given X value on the curve
 	/// from 0.0 to 1.0.
 	Q_INVOKABLE [[nodiscard]] qreal valueAt(qreal x) const;
+	/// Returns the Y values for each of the given X values on the curve.
+	///
+	/// Equivalent to calling [valueAt](#func.valueAt) for each value, but only
+	/// crosses the javascript boundary once.
+	Q_INVOKABLE [[nodiscard]] QList<qreal> valuesAt(const QList<qreal>& x) const;
 	/// Interpolates between two values using the given X coordinate.
 	Q_INVOKABLE [[nodiscard]] qreal interpolate(qreal x, qreal a, qreal b) const;
 	/// Interpolates between two points using the given X coordinate.
@@ -32,9 +52,20 @@ public:
 	[[nodiscard]] QEasingCurve curve() const;
 	void setCurve(QEasingCurve curve);
 
+	[[nodiscard]] qint32 lookupResolution() const;
+	void setLookupResolution(qint32 lookupResolution);
+
 signals:
 	void curveChanged();
+	void lookupResolutionChanged();
 
 private:
+	void updateLookupTable();
+
+	static qreal lerp(qreal y, qreal a, qreal b);
+	static QPointF lerp(qreal y, const QPointF& a, const QPointF& b);
+
 	QEasingCurve mCurve;
+	qint32 mLookupResolution = 0;
+	QList<qreal> mLookupTable;
 };
@@ -19,20 +19,27 @@
 #include "imageprovider.hpp"
 #include "incubator.hpp"
 #include "plugin.hpp"
+#include "qmldiroverlay.hpp"
 #include "qsintercept.hpp"
 #include "reload.hpp"
 #include "scan.hpp"
 
 static QHash<QQmlEngine*, EngineGeneration*> g_generations; // NOLINT
 
-EngineGeneration::EngineGeneration(QmlScanner scanner)
+EngineGeneration::EngineGeneration(QmlScanner scanner, bool qmldirOverlay)
     : scanner(std::move(scanner))
     , interceptNetFactory(this->scanner.qmldirIntercepts)
     , engine(new QQmlEngine()) {
 	g_generations.insert(this->engine, this);
 
+	// The overlay serves qmldirs from disk, so the network path is only needed without it.
+	if (qmldirOverlay && this->qmldirOverlay.create(this->scanner)) {
+		this->urlInterceptor.overlayRoot = this->qmldirOverlay.root();
+	} else {
+		this->engine->setNetworkAccessManagerFactory(&this->interceptNetFactory);
+	}
+
 	this->engine->addUrlInterceptor(&this->urlInterceptor);
-	this->engine->setNetworkAccessManagerFactory(&this->interceptNetFactory);
 	this->engine->setIncubationController(&this->delayedIncubationController);
 
 	this->engine->addImageProvider("icon", new IconImageProvider());
@@ -8,6 +8,7 @@
 #include <qtclasshelpermacros.h>
 
 #include "incubator.hpp"
+#include "qmldiroverlay.hpp"
 #include "qsintercept.hpp"
 #include "scan.hpp"
 #include "shell.hpp"
@@ -19,7 +20,7 @@ class EngineGeneration: public QObject {
 	Q_OBJECT;
 
 public:
-	explicit EngineGeneration(QmlScanner scanner);
+	explicit EngineGeneration(QmlScanner scanner, bool qmldirOverlay = false);
 	~EngineGeneration() override;
 	Q_DISABLE_COPY_MOVE(EngineGeneration);
 
@@ -36,6 +37,7 @@ public:
 	QmlScanner scanner;
 	QsUrlInterceptor urlInterceptor;
 	QsInterceptNetworkAccessManagerFactory interceptNetFactory;
+	QsQmldirOverlay qmldirOverlay;
 	QQmlEngine* engine = nullptr;
 	ShellRoot* root = nullptr;
 	SingletonRegistry singletonRegistry;
@@ -27,6 +27,7 @@ int qs_main(int argc, char** argv) {
 	auto useQApplication = false;
 	auto nativeTextRendering = false;
 	auto desktopSettingsAware = true;
+	auto qmldirOverlay = false;
 	QHash<QString, QString> envOverrides;
 
 	{
@@ -272,6 +273,7 @@ int qs_main(int argc, char** argv) {
 				if (pragma == "UseQApplication") useQApplication = true;
 				else if (pragma == "NativeTextRendering") nativeTextRendering = true;
 				else if (pragma == "IgnoreSystemSettings") desktopSettingsAware = false;
+				else if (pragma == "UseQmldirOverlay") qmldirOverlay = true;
 				else if (pragma.startsWith("Env ")) {
 					auto envPragma = pragma.sliced(4);
 					auto splitIdx = envPragma.indexOf('=');
@@ -322,7 +324,7 @@ int qs_main(int argc, char** argv) {
 		QQuickWindow::setTextRenderType(QQuickWindow::NativeTextRendering);
 	}
 
-	auto root = RootWrapper(configFilePath);
+	auto root = RootWrapper(configFilePath, qmldirOverlay);
 	QGuiApplication::setQuitOnLastWindowClosed(false);
 
 	auto code = QGuiApplication::exec();
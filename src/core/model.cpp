@@ -0,0 +1,59 @@
+#include "model.hpp"
+
+#include <qabstractitemmodel.h>
+#include <qbytearray.h>
+#include <qhash.h>
+#include <qnamespace.h>
+#include <qobject.h>
+#include <qtypes.h>
+#include <qvariant.h>
+
+qint32 UntypedObjectModel::rowCount(const QModelIndex& parent) const {
+	if (parent != QModelIndex()) return 0;
+	return static_cast<qint32>(this->valuesList.length());
+}
+
+QVariant UntypedObjectModel::data(const QModelIndex& index, qint32 role) const {
+	if (role != Qt::UserRole || index.row() < 0 || index.row() >= this->valuesList.length()) {
+		return QVariant();
+	}
+
+	return QVariant::fromValue(this->valuesList.at(index.row()));
+}
+
+QHash<qint32, QByteArray> UntypedObjectModel::roleNames() const {
+	return {{Qt::UserRole, "modelData"}};
+}
+
+void UntypedObjectModel::insertObject(QObject* object, qsizetype index) {
+	auto iindex = index == -1 ? this->valuesList.length() : index;
+	auto intIndex = static_cast<qint32>(iindex);
+
+	this->beginInsertRows(QModelIndex(), intIndex, intIndex);
+	this->valuesList.insert(iindex, object);
+	this->endInsertRows();
+
+	emit this->valuesChanged();
+}
+
+void UntypedObjectModel::removeAt(qsizetype index) {
+	auto intIndex = static_cast<qint32>(index);
+
+	this->beginRemoveRows(QModelIndex(), intIndex, intIndex);
+	this->valuesList.removeAt(index);
+	this->endRemoveRows();
+
+	emit this->valuesChanged();
+}
+
+bool UntypedObjectModel::removeObject(const QObject* object) {
+	auto index = this->valuesList.indexOf(object);
+	if (index == -1) return false;
+
+	this->removeAt(index);
+	return true;
+}
+
+qsizetype UntypedObjectModel::indexOf(QObject* object) const {
+	return this->valuesList.indexOf(object);
+}
@@ -0,0 +1,81 @@
+#include "qmldiroverlay.hpp"
+#include <memory>
+
+#include <qdir.h>
+#include <qfile.h>
+#include <qlogging.h>
+#include <qloggingcategory.h>
+#include <qstandardpaths.h>
+#include <qtemporarydir.h>
+
+#include "qsintercept.hpp"
+#include "scan.hpp"
+
+bool QsQmldirOverlay::create(const QmlScanner& scanner) {
+	auto base = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+	if (base.isEmpty()) base = QDir::tempPath();
+
+	this->dir = std::make_unique<QTemporaryDir>(QDir(base).filePath("quickshell-overlay-XXXXXX"));
+
+	if (!this->dir->isValid()) {
+		qCWarning(logQsIntercept) << "Could not create qmldir overlay in" << base
+		                          << this->dir->errorString();
+		this->dir.reset();
+		return false;
+	}
+
+	auto fail = [this](const QString& what, const QString& path) {
+		qCWarning(logQsIntercept) << "Could not" << what << path
+		                          << "for qmldir overlay, falling back to qsintercept";
+		this->dir.reset();
+		return false;
+	};
+
+	for (const auto& path: scanner.scannedDirs) {
+		auto realDir = QDir(path);
+		auto overlayDir = QDir(this->overlayPath(path));
+
+		if (!overlayDir.mkpath(".")) return fail("create directory", overlayDir.path());
+
+		// A real qmldir is linked along with the qml files if present.
+		for (auto& entry: realDir.entryList({"*.qml", "qmldir"}, QDir::Files | QDir::Hidden)) {
+			if (!QFile::link(realDir.filePath(entry), overlayDir.filePath(entry))) {
+				return fail("link", realDir.filePath(entry));
+			}
+		}
+
+		auto qmldir = scanner.qmldirIntercepts.value(realDir.filePath("qmldir"));
+
+		if (!qmldir.isNull()) {
+			auto file = QFile(overlayDir.filePath("qmldir"));
+			if (!file.open(QFile::WriteOnly) || file.write(qmldir) != qmldir.size()) {
+				return fail("write", file.fileName());
+			}
+		}
+	}
+
+	qCDebug(logQsIntercept) << "Created qmldir overlay for" << scanner.scannedDirs.size()
+	                        << "directories at" << this->root();
+
+	return true;
+}
+
+bool QsQmldirOverlay::isActive() const { return this->dir != nullptr; }
+
+QString QsQmldirOverlay::root() const {
+	if (this->dir == nullptr) return QString();
+	return this->dir->path();
+}
+
+QString QsQmldirOverlay::overlayPath(const QString& path) const { return this->root() + path; }
+
+QString QsQmldirOverlay::sourcePath(const QString& path) const {
+	if (this->dir == nullptr) return path;
+
+	auto root = this->root();
+	if (path.length() <= root.length() || !path.startsWith(root) || path.at(root.length()) != '/') {
+		return path;
+	}
+
+	return path.sliced(root.length());
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <memory>
+
+#include <qcontainerfwd.h>
+#include <qtemporarydir.h>
+
+#include "scan.hpp"
+
+// Mirrors the directories found by a QmlScanner into a private directory, containing
+// the synthesized qmldirs and links to the real qml files. This lets the engine load the
+// config through plain file urls instead of the asynchronous qsintercept scheme.
+//
+// Paths inside the overlay are the real canonical paths prefixed with root().
+class QsQmldirOverlay {
+public:
+	// returns false if the overlay could not be created, in which case it is inactive
+	bool create(const QmlScanner& scanner);
+
+	[[nodiscard]] bool isActive() const;
+	[[nodiscard]] QString root() const;
+	[[nodiscard]] QString overlayPath(const QString& path) const;
+	// maps a path inside the overlay back to the real path, other paths are returned as is
+	[[nodiscard]] QString sourcePath(const QString& path) const;
+
+private:
+	std::unique_ptr<QTemporaryDir> dir;
+};
@@ -1,6 +1,9 @@
 #include "qsintercept.hpp"
 #include <cstring>
+#include <utility>
 
+#include <qbytearray.h>
+#include <qfileinfo.h>
 #include <qhash.h>
 #include <qiodevice.h>
 #include <qlogging.h>
@@ -17,6 +20,27 @@
 Q_LOGGING_CATEGORY(logQsIntercept, "quickshell.interceptor", QtWarningMsg);
 
 QUrl QsUrlInterceptor::intercept(const QUrl& url, QQmlAbstractUrlInterceptor::DataType type) {
+	if (!this->overlayRoot.isEmpty() && url.isLocalFile()) {
+		auto path = url.path(QUrl::FullyDecoded);
+
+		if (path.startsWith(this->overlayRoot + '/')) {
+			// Only qml files and qmldirs are mirrored into the overlay. Everything else, along with
+			// qml files from directories the scanner never saw, is loaded from its real location.
+			auto isQml = type == QQmlAbstractUrlInterceptor::QmlFile
+			          || type == QQmlAbstractUrlInterceptor::QmldirFile
+			          || (type == QQmlAbstractUrlInterceptor::UrlString && path.endsWith(".qml"));
+
+			if (!isQml || !QFileInfo::exists(path)) {
+				auto newUrl = url;
+				newUrl.setPath(path.sliced(this->overlayRoot.length()), QUrl::DecodedMode);
+				qCDebug(logQsIntercept) << "Rewrote overlay path" << url << "to" << newUrl;
+				return newUrl;
+			}
+		}
+
+		return url;
+	}
+
 	// Some types such as Image take into account where they are loading from, and force
 	// asynchronous loading over a network. qsintercept is considered to be over a network.
 	if (type == QQmlAbstractUrlInterceptor::DataType::UrlString && url.scheme() == "qsintercept") {
@@ -34,9 +58,9 @@ QUrl QsUrlInterceptor::intercept(const QUrl& url, QQmlAbstractUrlInterceptor::Da
 	return url;
 }
 
-QsInterceptDataReply::QsInterceptDataReply(const QString& qmldir, QObject* parent)
+QsInterceptDataReply::QsInterceptDataReply(QByteArray qmldir, QObject* parent)
     : QNetworkReply(parent)
-    , content(qmldir.toUtf8()) {
+    , content(std::move(qmldir)) {
 	this->setOpenMode(QIODevice::ReadOnly);
 	this->setFinished(true);
 }
@@ -50,7 +74,7 @@ qint64 QsInterceptDataReply::readData(char* data, qint64 maxSize) {
 }
 
 QsInterceptNetworkAccessManager::QsInterceptNetworkAccessManager(
-    const QHash<QString, QString>& qmldirIntercepts,
+    const QHash<QString, QByteArray>& qmldirIntercepts,
     QObject* parent
 )
     : QNetworkAccessManager(parent)
@@ -67,7 +91,7 @@ QNetworkReply* QsInterceptNetworkAccessManager::createRequest(
 		qCDebug(logQsIntercept) << "Got intercept for" << path << "contains"
 		                        << this->qmldirIntercepts.value(path);
 		auto qmldir = this->qmldirIntercepts.value(path);
-		if (qmldir != nullptr) {
+		if (!qmldir.isNull()) {
 			return new QsInterceptDataReply(qmldir, this);
 		}
 
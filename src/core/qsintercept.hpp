@@ -1,5 +1,6 @@
 #pragma once
 
+#include <qbytearray.h>
 #include <qhash.h>
 #include <qloggingcategory.h>
 #include <qnetworkaccessmanager.h>
@@ -14,13 +15,16 @@ Q_DECLARE_LOGGING_CATEGORY(logQsIntercept);
 class QsUrlInterceptor: public QQmlAbstractUrlInterceptor {
 public:
 	QUrl intercept(const QUrl& url, QQmlAbstractUrlInterceptor::DataType type) override;
+
+	// Root of the active QsQmldirOverlay, or empty if the qsintercept scheme is in use.
+	QString overlayRoot;
 };
 
 class QsInterceptDataReply: public QNetworkReply {
 	Q_OBJECT;
 
 public:
-	QsInterceptDataReply(const QString& qmldir, QObject* parent = nullptr);
+	QsInterceptDataReply(QByteArray qmldir, QObject* parent = nullptr);
 
 	qint64 readData(char* data, qint64 maxSize) override;
 
@@ -37,7 +41,7 @@ class QsInterceptNetworkAccessManager: public QNetworkAccessManager {
 
 public:
 	QsInterceptNetworkAccessManager(
-	    const QHash<QString, QString>& qmldirIntercepts,
+	    const QHash<QString, QByteArray>& qmldirIntercepts,
 	    QObject* parent = nullptr
 	);
 
@@ -49,15 +53,15 @@ protected:
 	) override;
 
 private:
-	const QHash<QString, QString>& qmldirIntercepts;
+	const QHash<QString, QByteArray>& qmldirIntercepts;
 };
 
 class QsInterceptNetworkAccessManagerFactory: public QQmlNetworkAccessManagerFactory {
 public:
-	QsInterceptNetworkAccessManagerFactory(const QHash<QString, QString>& qmldirIntercepts)
+	QsInterceptNetworkAccessManagerFactory(const QHash<QString, QByteArray>& qmldirIntercepts)
 	    : qmldirIntercepts(qmldirIntercepts) {}
 	QNetworkAccessManager* create(QObject* parent) override;
 
 private:
-	const QHash<QString, QString>& qmldirIntercepts;
+	const QHash<QString, QByteArray>& qmldirIntercepts;
 };
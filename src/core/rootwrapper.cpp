@@ -3,6 +3,7 @@
 #include <utility>
 
 #include <qdir.h>
+#include <qelapsedtimer.h>
 #include <qfileinfo.h>
 #include <qlogging.h>
 #include <qobject.h>
@@ -15,10 +16,11 @@
 #include "scan.hpp"
 #include "shell.hpp"
 
-RootWrapper::RootWrapper(QString rootPath)
+RootWrapper::RootWrapper(QString rootPath, bool qmldirOverlay)
     : QObject(nullptr)
     , rootPath(std::move(rootPath))
-    , originalWorkingDirectory(QDir::current().absolutePath()) {
+    , originalWorkingDirectory(QDir::current().absolutePath())
+    , qmldirOverlay(qmldirOverlay) {
 	// clang-format off
 	QObject::connect(QuickshellSettings::instance(), &QuickshellSettings::watchFilesChanged, this, &RootWrapper::onWatchFilesChanged);
 	// clang-format on
@@ -42,10 +44,13 @@ RootWrapper::~RootWrapper() {
 }
 
 void RootWrapper::reloadGraph(bool hard) {
+	auto timer = QElapsedTimer();
+	timer.start();
+
 	auto scanner = QmlScanner();
 	scanner.scanQmlFile(this->rootPath);
 
-	auto* generation = new EngineGeneration(std::move(scanner));
+	auto* generation = new EngineGeneration(std::move(scanner), this->qmldirOverlay);
 	generation->wrapper = this;
 
 	// todo: move into EngineGeneration
@@ -55,9 +60,15 @@ void RootWrapper::reloadGraph(bool hard) {
 
 	QDir::setCurrent(this->originalWorkingDirectory);
 
-	auto url = QUrl::fromLocalFile(this->rootPath);
-	// unless the original file comes from the qsintercept scheme
-	url.setScheme("qsintercept");
+	QUrl url;
+	if (generation->qmldirOverlay.isActive()) {
+		url = QUrl::fromLocalFile(generation->qmldirOverlay.overlayPath(this->rootPath));
+	} else {
+		url = QUrl::fromLocalFile(this->rootPath);
+		// unless the original file comes from the qsintercept scheme
+		url.setScheme("qsintercept");
+	}
+
 	auto component = QQmlComponent(generation->engine, url);
 
 	auto* obj = component.beginCreate(generation->engine->rootContext());
@@ -85,7 +96,9 @@ void RootWrapper::reloadGraph(bool hard) {
 	if (hard) delete this->generation;
 	this->generation = generation;
 
-	qInfo() << "Configuration Loaded";
+	qInfo().nospace() << "Configuration Loaded ("
+	                  << static_cast<double>(timer.nsecsElapsed()) / 1000000 << "ms"
+	                  << (this->generation->qmldirOverlay.isActive() ? ", qmldir overlay" : "") << ")";
 
 	QObject::connect(
 	    this->generation,
@@ -12,7 +12,7 @@ class RootWrapper: public QObject {
 	Q_OBJECT;
 
 public:
-	explicit RootWrapper(QString rootPath);
+	explicit RootWrapper(QString rootPath, bool qmldirOverlay = false);
 	~RootWrapper() override;
 	Q_DISABLE_COPY_MOVE(RootWrapper);
 
@@ -26,4 +26,5 @@ private:
 	QString rootPath;
 	EngineGeneration* generation = nullptr;
 	QString originalWorkingDirectory;
+	bool qmldirOverlay = false;
 };
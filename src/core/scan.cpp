@@ -53,7 +53,7 @@ void QmlScanner::scanDir(const QString& path) {
 		}
 
 		qCDebug(logQmlScanner) << "Synthesized qmldir for" << path << qPrintable("\n" + qmldir);
-		this->qmldirIntercepts.insert(QDir(path).filePath("qmldir"), qmldir);
+		this->qmldirIntercepts.insert(QDir(path).filePath("qmldir"), qmldir.toUtf8());
 	}
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <qbytearray.h>
 #include <qcontainerfwd.h>
 #include <qhash.h>
 #include <qloggingcategory.h>
@@ -16,5 +17,6 @@ public:
 
 	QVector<QString> scannedDirs;
 	QVector<QString> scannedFiles;
-	QHash<QString, QString> qmldirIntercepts;
+	// pre-encoded as utf8 so they can be served without conversion
+	QHash<QString, QByteArray> qmldirIntercepts;
 };
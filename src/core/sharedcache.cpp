@@ -0,0 +1,187 @@
+#include "sharedcache.hpp"
+#include <utility>
+
+#include <qcontainerfwd.h>
+#include <qdeadlinetimer.h>
+#include <qhash.h>
+#include <qlogging.h>
+#include <qloggingcategory.h>
+#include <qmetatype.h>
+#include <qtmetamacros.h>
+#include <qtypes.h>
+#include <qvariant.h>
+
+Q_LOGGING_CATEGORY(logSharedCache, "quickshell.sharedcache", QtWarningMsg);
+
+QVariant SharedCacheStore::value(const QString& key, const QVariant& defaultValue) {
+	auto* entry = this->find(key);
+	if (entry == nullptr) return defaultValue;
+	entry->lastUsed = ++this->useCounter;
+	return entry->value;
+}
+
+bool SharedCacheStore::contains(const QString& key) { return this->find(key) != nullptr; }
+
+void SharedCacheStore::insert(const QString& key, QVariant value, qint64 ttl) {
+	auto size = SharedCacheStore::estimateSize(value) + key.size() * 2;
+
+	this->remove(key);
+
+	if (size > this->mMaxSize) {
+		qCWarning(logSharedCache) << "Not caching" << key << "as its estimated size" << size
+		                          << "exceeds the maximum size of the cache" << this->mMaxSize;
+		return;
+	}
+
+	auto entry = Entry();
+	entry.value = std::move(value);
+	entry.size = size;
+	entry.expiry = ttl > 0 ? QDeadlineTimer(ttl) : QDeadlineTimer(QDeadlineTimer::Forever);
+	entry.lastUsed = ++this->useCounter;
+
+	this->entries.insert(key, entry);
+	this->mSize += size;
+	this->evict();
+}
+
+bool SharedCacheStore::remove(const QString& key) {
+	auto entry = this->entries.find(key);
+	if (entry == this->entries.end()) return false;
+	this->removeEntry(entry);
+	return true;
+}
+
+void SharedCacheStore::clear() {
+	this->entries.clear();
+	this->mSize = 0;
+}
+
+qint64 SharedCacheStore::size() const { return this->mSize; }
+qint64 SharedCacheStore::maxSize() const { return this->mMaxSize; }
+
+void SharedCacheStore::setMaxSize(qint64 maxSize) {
+	this->mMaxSize = maxSize;
+	this->evict();
+}
+
+SharedCacheStore::Entry* SharedCacheStore::find(const QString& key) {
+	auto entry = this->entries.find(key);
+	if (entry == this->entries.end()) return nullptr;
+
+	if (entry->expiry.hasExpired()) {
+		this->removeEntry(entry);
+		return nullptr;
+	}
+
+	return &*entry;
+}
+
+void SharedCacheStore::removeEntry(QHash<QString, Entry>::iterator entry) {
+	this->mSize -= entry->size;
+	this->entries.erase(entry);
+}
+
+void SharedCacheStore::evict() {
+	if (this->mSize <= this->mMaxSize) return;
+
+	// expired entries go first
+	this->entries.removeIf([this](QHash<QString, Entry>::iterator entry) {
+		if (!entry->expiry.hasExpired()) return false;
+		this->mSize -= entry->size;
+		return true;
+	});
+
+	while (this->mSize > this->mMaxSize && !this->entries.isEmpty()) {
+		auto oldest = this->entries.begin();
+
+		for (auto entry = this->entries.begin(); entry != this->entries.end(); entry++) {
+			if (entry->lastUsed < oldest->lastUsed) oldest = entry;
+		}
+
+		qCDebug(logSharedCache) << "Evicting" << oldest.key() << "to stay under" << this->mMaxSize
+		                        << "bytes";
+		this->removeEntry(oldest);
+	}
+}
+
+qint64 SharedCacheStore::estimateSize(const QVariant& value) { // NOLINT
+	const qint64 base = sizeof(QVariant);
+
+	switch (value.typeId()) {
+	case QMetaType::QString: return base + value.toString().size() * 2;
+	case QMetaType::QByteArray: return base + value.toByteArray().size();
+	case QMetaType::QStringList: {
+		auto size = base;
+		for (const auto& str: value.toStringList()) size += base + str.size() * 2;
+		return size;
+	}
+	case QMetaType::QVariantList: {
+		auto size = base;
+		for (const auto& item: value.toList()) size += SharedCacheStore::estimateSize(item);
+		return size;
+	}
+	case QMetaType::QVariantMap: {
+		auto size = base;
+		for (const auto [key, item]: value.toMap().asKeyValueRange()) {
+			size += key.size() * 2 + SharedCacheStore::estimateSize(item);
+		}
+		return size;
+	}
+	case QMetaType::QVariantHash: {
+		auto size = base;
+		for (const auto [key, item]: value.toHash().asKeyValueRange()) {
+			size += key.size() * 2 + SharedCacheStore::estimateSize(item);
+		}
+		return size;
+	}
+	default: return base + value.metaType().sizeOf();
+	}
+}
+
+SharedCacheStore* SharedCacheStore::forScope(const QString& scope) {
+	static QHash<QString, SharedCacheStore*> stores; // NOLINT
+
+	auto* store = stores.value(scope);
+	if (store == nullptr) {
+		store = new SharedCacheStore();
+		stores.insert(scope, store);
+	}
+
+	return store;
+}
+
+QVariant SharedCache::value(const QString& key, const QVariant& defaultValue) const {
+	return SharedCacheStore::forScope(this->mScope)->value(key, defaultValue);
+}
+
+bool SharedCache::contains(const QString& key) const {
+	return SharedCacheStore::forScope(this->mScope)->contains(key);
+}
+
+void SharedCache::insert(const QString& key, const QVariant& value, qint64 ttl) const {
+	SharedCacheStore::forScope(this->mScope)->insert(key, value, ttl);
+}
+
+bool SharedCache::remove(const QString& key) const {
+	return SharedCacheStore::forScope(this->mScope)->remove(key);
+}
+
+void SharedCache::clear() const { SharedCacheStore::forScope(this->mScope)->clear(); }
+
+QString SharedCache::scope() const { return this->mScope; }
+
+void SharedCache::setScope(QString scope) {
+	if (scope == this->mScope) return;
+	this->mScope = std::move(scope);
+	emit this->scopeChanged();
+	emit this->maxSizeChanged();
+}
+
+qint64 SharedCache::maxSize() const { return SharedCacheStore::forScope(this->mScope)->maxSize(); }
+
+void SharedCache::setMaxSize(qint64 maxSize) {
+	auto* store = SharedCacheStore::forScope(this->mScope);
+	if (maxSize == store->maxSize()) return;
+	store->setMaxSize(maxSize);
+	emit this->maxSizeChanged();
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <qcontainerfwd.h>
+#include <qdeadlinetimer.h>
+#include <qhash.h>
+#include <qloggingcategory.h>
+#include <qobject.h>
+#include <qqmlintegration.h>
+#include <qtmetamacros.h>
+#include <qtypes.h>
+#include <qvariant.h>
+
+Q_DECLARE_LOGGING_CATEGORY(logSharedCache);
+
+// Key/value store that is not owned by any engine generation and lives until quickshell exits.
+class SharedCacheStore {
+public:
+	[[nodiscard]] QVariant value(const QString& key, const QVariant& defaultValue = QVariant());
+	[[nodiscard]] bool contains(const QString& key);
+	// ttl in milliseconds, 0 for no expiry
+	void insert(const QString& key, QVariant value, qint64 ttl = 0);
+	bool remove(const QString& key);
+	void clear();
+
+	[[nodiscard]] qint64 size() const;
+	[[nodiscard]] qint64 maxSize() const;
+	void setMaxSize(qint64 maxSize);
+
+	// rough estimate of the memory used by a value
+	static qint64 estimateSize(const QVariant& value);
+	static SharedCacheStore* forScope(const QString& scope);
+
+private:
+	struct Entry {
+		QVariant value;
+		qint64 size = 0;
+		QDeadlineTimer expiry;
+		quint64 lastUsed = 0;
+	};
+
+	// returns the entry if it exists and has not expired
+	Entry* find(const QString& key);
+	void removeEntry(QHash<QString, Entry>::iterator entry);
+	void evict();
+
+	QHash<QString, Entry> entries;
+	qint64 mSize = 0;
+	qint64 mMaxSize = 16 * 1024 * 1024;
+	quint64 useCounter = 0;
+};
+
+///! Cache that persists across config reloads.
+/// Stores arbitrary values which survive config reloads, such as parsed files,
+/// command output or the results of expensive computations, so they do not have to be
+/// recomputed after every edit.
+///
+/// Caches with the same [scope](#prop.scope) share the same values, regardless of
+/// which config generation they were created in.
+///
+/// ```qml
+/// SharedCache {
+///   id: cache
+///   scope: "weather"
+/// }
+///
+/// Process {
+///   id: fetch
+///   command: [ "fetch-forecast" ]
+///   stdout: SplitParser {
+///     // keep the forecast for 10 minutes
+///     onRead: data => cache.insert("forecast", JSON.parse(data), 10 * 60 * 1000)
+///   }
+/// }
+///
+/// Timer {
+///   running: true
+///   repeat: true
+///   triggeredOnStart: true
+///   interval: 60 * 1000
+///   // only fetches on the first load, or once the cached forecast has expired
+///   onTriggered: if (!cache.contains("forecast")) fetch.running = true
+/// }
+/// ```
+///
+/// > [!INFO] Cache functions do not notify bindings when values change or expire,
+/// > so they should be called when the value is needed rather than bound to.
+///
+/// > [!INFO] Values are copied in and out of the cache. Changes made to a returned
+/// > object are not reflected in the cache until it is inserted again.
+class SharedCache: public QObject {
+	Q_OBJECT;
+	// clang-format off
+	/// The scope of the cache. Caches with the same scope share values. Defaults to `""`.
+	Q_PROPERTY(QString scope READ scope WRITE setScope NOTIFY scopeChanged);
+	/// Approximate maximum memory usage of the scope in bytes. Defaults to 16MiB.
+	///
+	/// When exceeded the least recently used values are removed. This setting
+	/// is shared by all caches with the same scope.
+	Q_PROPERTY(qint64 maxSize READ maxSize WRITE setMaxSize NOTIFY maxSizeChanged);
+	// clang-format on
+	QML_ELEMENT;
+
+public:
+	explicit SharedCache(QObject* parent = nullptr): QObject(parent) {}
+
+	/// Returns the value for `key`, or `defaultValue` if it is not present or has expired.
+	Q_INVOKABLE [[nodiscard]] QVariant
+	value(const QString& key, const QVariant& defaultValue = QVariant()) const;
+	/// Returns true if `key` is present and has not expired.
+	Q_INVOKABLE [[nodiscard]] bool contains(const QString& key) const;
+	/// Stores `value` for `key`, expiring after `ttl` milliseconds if `ttl` is greater than zero.
+	Q_INVOKABLE void insert(const QString& key, const QVariant& value, qint64 ttl = 0) const;
+	/// Removes `key` from the cache. Returns true if it was present.
+	Q_INVOKABLE bool remove(const QString& key) const;
+	/// Removes all values in this cache's scope.
+	Q_INVOKABLE void clear() const;
+
+	[[nodiscard]] QString scope() const;
+	void setScope(QString scope);
+
+	[[nodiscard]] qint64 maxSize() const;
+	void setMaxSize(qint64 maxSize);
+
+signals:
+	void scopeChanged();
+	void maxSizeChanged();
+
+private:
+	QString mScope;
+};
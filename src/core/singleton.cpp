@@ -1,15 +1,30 @@
 #include "singleton.hpp"
 
+#include <qelapsedtimer.h>
 #include <qhash.h>
 #include <qlogging.h>
+#include <qloggingcategory.h>
 #include <qobject.h>
+#include <qqmlcomponent.h>
 #include <qqmlcontext.h>
 #include <qqmlengine.h>
+#include <qtmetamacros.h>
+#include <qtypes.h>
+#include <qurl.h>
 
 #include "generation.hpp"
 #include "reload.hpp"
 
+Q_LOGGING_CATEGORY(logSingleton, "quickshell.singleton", QtWarningMsg);
+
+void Singleton::classBegin() { this->constructionTimer.start(); }
+
 void Singleton::componentComplete() {
+	if (this->constructionTimer.isValid()) {
+		this->mConstructionNs = this->constructionTimer.nsecsElapsed();
+		this->constructionTimer.invalidate();
+	}
+
 	auto* context = QQmlEngine::contextForObject(this);
 
 	if (context == nullptr) {
@@ -33,10 +48,102 @@ void Singleton::componentComplete() {
 		return;
 	}
 
+	// the overlay is recreated for each generation, and singletons are matched with their
+	// previous instance by the file they came from
+	if (generation->qmldirOverlay.isActive() && url.isLocalFile()) {
+		url = QUrl::fromLocalFile(generation->qmldirOverlay.sourcePath(url.toLocalFile()));
+	}
+
 	generation->singletonRegistry.registerSingleton(url, this);
 	this->ReloadPropagator::componentComplete();
 }
 
+qint64 Singleton::constructionNs() const { return this->mConstructionNs; }
+
+void LazySingleton::onReload(QObject* oldInstance) {
+	auto* old = qobject_cast<LazySingleton*>(oldInstance);
+
+	// If the previous generation was using the contents then this one almost certainly
+	// will too, and creating them now lets them take state from the old instance.
+	if (old != nullptr && old->mItem != nullptr) this->materialize();
+
+	if (this->mItem != nullptr) {
+		auto* oldItem = old == nullptr ? nullptr : old->mItem;
+
+		if (auto* reloadable = qobject_cast<Reloadable*>(this->mItem)) {
+			reloadable->reload(oldItem);
+		} else {
+			Reloadable::reloadRecursive(this->mItem, oldItem);
+		}
+	}
+}
+
+QObject* LazySingleton::item() {
+	this->materialize();
+	return this->mItem;
+}
+
+bool LazySingleton::isActive() const { return this->mItem != nullptr; }
+
+qint64 LazySingleton::materializationNs() const { return this->mMaterializationNs; }
+
+QQmlComponent* LazySingleton::component() const { return this->mComponent; }
+
+void LazySingleton::setComponent(QQmlComponent* component) {
+	if (component == this->mComponent) return;
+
+	if (this->mComponent != nullptr) {
+		QObject::disconnect(this->mComponent, nullptr, this, nullptr);
+	}
+
+	this->mComponent = component;
+
+	if (component != nullptr) {
+		QObject::connect(
+		    this->mComponent,
+		    &QObject::destroyed,
+		    this,
+		    &LazySingleton::onComponentDestroyed
+		);
+	}
+
+	emit this->componentChanged();
+}
+
+void LazySingleton::onComponentDestroyed() { this->mComponent = nullptr; }
+
+void LazySingleton::materialize() {
+	// guard against the component reading item during its own construction
+	if (this->mItem != nullptr || this->mComponent == nullptr || this->mMaterializing) return;
+	this->mMaterializing = true;
+
+	auto timer = QElapsedTimer();
+	timer.start();
+
+	auto* item = this->mComponent->create(QQmlEngine::contextForObject(this->mComponent));
+
+	this->mMaterializing = false;
+
+	if (item == nullptr) {
+		qCWarning(logSingleton) << "Failed to create LazySingleton contents for" << this;
+
+		for (auto& error: this->mComponent->errors()) {
+			qCWarning(logSingleton) << error;
+		}
+
+		return;
+	}
+
+	this->mMaterializationNs = timer.nsecsElapsed();
+	item->setParent(this);
+	this->mItem = item;
+
+	qCDebug(logSingleton) << "Created LazySingleton contents for" << this << "in"
+	                      << static_cast<double>(this->mMaterializationNs) / 1000000 << "ms";
+
+	emit this->itemChanged();
+}
+
 void SingletonRegistry::registerSingleton(const QUrl& url, Singleton* singleton) {
 	if (this->registry.contains(url)) {
 		qWarning() << "Tried to register singleton twice for the same file" << url;
@@ -50,6 +157,8 @@ void SingletonRegistry::onReload(SingletonRegistry* old) {
 	for (auto [url, singleton]: this->registry.asKeyValueRange()) {
 		singleton->reload(old == nullptr ? nullptr : old->registry.value(url));
 	}
+
+	if (logSingleton().isInfoEnabled()) this->reportMaterialized();
 }
 
 void SingletonRegistry::onPostReload() {
@@ -57,3 +166,32 @@ void SingletonRegistry::onPostReload() {
 		PostReloadHook::postReloadTree(singleton);
 	}
 }
+
+void SingletonRegistry::reportMaterialized() const {
+	auto ms = [](qint64 ns) { return static_cast<double>(ns) / 1000000; };
+
+	qint64 total = 0;
+	qsizetype deferred = 0;
+
+	for (auto [url, singleton]: this->registry.asKeyValueRange()) {
+		auto* lazy = qobject_cast<LazySingleton*>(singleton);
+		total += singleton->constructionNs();
+
+		if (lazy == nullptr) {
+			qCInfo(logSingleton).noquote() << "Singleton" << url.fileName() << "created in"
+			                               << ms(singleton->constructionNs()) << "ms";
+		} else if (lazy->isActive()) {
+			total += lazy->materializationNs();
+			qCInfo(logSingleton).noquote()
+			    << "LazySingleton" << url.fileName() << "created in" << ms(singleton->constructionNs())
+			    << "ms, contents in" << ms(lazy->materializationNs()) << "ms";
+		} else {
+			deferred++;
+			qCInfo(logSingleton).noquote() << "LazySingleton" << url.fileName() << "created in"
+			                               << ms(singleton->constructionNs()) << "ms, contents deferred";
+		}
+	}
+
+	qCInfo(logSingleton) << this->registry.size() << "singletons created in" << ms(total) << "ms,"
+	                     << deferred << "deferred";
+}
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <qelapsedtimer.h>
 #include <qhash.h>
+#include <qloggingcategory.h>
 #include <qobject.h>
+#include <qqmlcomponent.h>
 #include <qqmlengine.h>
 #include <qqmlintegration.h>
 #include <qtmetamacros.h>
@@ -10,6 +13,8 @@
 
 #include "reload.hpp"
 
+Q_DECLARE_LOGGING_CATEGORY(logSingleton);
+
 ///! The root component for reloadable singletons.
 /// All singletons should inherit from this type.
 class Singleton: public ReloadPropagator {
@@ -17,7 +22,79 @@ class Singleton: public ReloadPropagator {
 	QML_ELEMENT;
 
 public:
+	void classBegin() override;
 	void componentComplete() override;
+
+	// time taken between classBegin and componentComplete
+	[[nodiscard]] qint64 constructionNs() const;
+
+private:
+	QElapsedTimer constructionTimer;
+	qint64 mConstructionNs = 0;
+};
+
+///! Singleton that defers creating its contents until they are used.
+/// A singleton which does not create its contents until [item](#prop.item) is
+/// first accessed. This is useful for singletons wrapping expensive resources
+/// such as processes, sockets or service connections which may not be used
+/// by every configuration that imports them.
+///
+/// Once created the contents will be kept across reloads, and will be created
+/// immediately on reload if the previous generation had created them.
+///
+/// ```qml
+/// pragma Singleton
+///
+/// LazySingleton {
+///   // not created until `Battery.item` is read
+///   QtObject {
+///     property int percentage: 0
+///
+///     property Process proc: Process { /* ... */ }
+///   }
+/// }
+/// ```
+///
+/// Run quickshell with `QT_LOGGING_RULES="quickshell.singleton.info=true"` to see which
+/// singletons were created during loading and how long each took.
+class LazySingleton: public Singleton {
+	Q_OBJECT;
+	/// The contents of the singleton. Reading this property will create them if they
+	/// do not already exist.
+	Q_PROPERTY(QObject* item READ item NOTIFY itemChanged);
+	/// If the contents of the singleton have been created.
+	Q_PROPERTY(bool active READ isActive NOTIFY itemChanged);
+	/// The component to create on first use.
+	Q_PROPERTY(QQmlComponent* component READ component WRITE setComponent NOTIFY componentChanged);
+	Q_CLASSINFO("DefaultProperty", "component");
+	QML_ELEMENT;
+
+public:
+	void onReload(QObject* oldInstance) override;
+
+	[[nodiscard]] QObject* item();
+	[[nodiscard]] bool isActive() const;
+
+	[[nodiscard]] QQmlComponent* component() const;
+	void setComponent(QQmlComponent* component);
+
+	// time taken to create the contents, or -1 if they have not been created
+	[[nodiscard]] qint64 materializationNs() const;
+
+signals:
+	void itemChanged();
+	void componentChanged();
+
+private slots:
+	void onComponentDestroyed();
+
+private:
+	void materialize();
+
+	QObject* mItem = nullptr;
+	QQmlComponent* mComponent = nullptr;
+	qint64 mMaterializationNs = -1;
+	bool mMaterializing = false;
 };
 
 class SingletonRegistry {
@@ -29,5 +106,7 @@ public:
 	void onPostReload();
 
 private:
+	void reportMaterialized() const;
+
 	QHash<QUrl, Singleton*> registry;
 };
@@ -0,0 +1,139 @@
+#include "easingcurve.hpp"
+#include <cmath>
+#include <limits>
+
+#include <qeasingcurve.h>
+#include <qlist.h>
+#include <qpoint.h>
+#include <qrect.h>
+#include <qstring.h>
+#include <qtest.h>
+#include <qtestcase.h>
+#include <qtypes.h>
+
+#include "../easingcurve.hpp"
+
+void TestEasingCurve::lookupAccuracy_data() { // NOLINT
+	QTest::addColumn<QEasingCurve::Type>("type");
+
+	QTest::addRow("linear") << QEasingCurve::Linear;
+	QTest::addRow("inOutQuad") << QEasingCurve::InOutQuad;
+	QTest::addRow("outCubic") << QEasingCurve::OutCubic;
+	QTest::addRow("outBack") << QEasingCurve::OutBack;
+	QTest::addRow("inOutSine") << QEasingCurve::InOutSine;
+}
+
+void TestEasingCurve::lookupAccuracy() { // NOLINT
+	QFETCH(QEasingCurve::Type, type);
+
+	auto direct = EasingCurve();
+	direct.setCurve(QEasingCurve(type));
+
+	auto lookup = EasingCurve();
+	lookup.setCurve(QEasingCurve(type));
+	lookup.setLookupResolution(1024);
+
+	for (auto i = 0; i <= 1000; i++) {
+		auto x = static_cast<qreal>(i) / 1000;
+		QVERIFY2(
+		    std::abs(direct.valueAt(x) - lookup.valueAt(x)) < 1e-4,
+		    qPrintable(QString("mismatch at x=%1").arg(x))
+		);
+	}
+}
+
+void TestEasingCurve::lookupEndpoints() { // NOLINT
+	auto curve = EasingCurve();
+	curve.setCurve(QEasingCurve(QEasingCurve::InOutQuad));
+	curve.setLookupResolution(16);
+
+	QCOMPARE(curve.valueAt(0.0), 0.0);
+	QCOMPARE(curve.valueAt(1.0), 1.0);
+	QCOMPARE(curve.valueAt(-5.0), 0.0);
+	QCOMPARE(curve.valueAt(5.0), 1.0);
+
+	// non-finite input behaves as it does without a table
+	auto infinity = std::numeric_limits<qreal>::infinity();
+	QCOMPARE(curve.valueAt(-infinity), 0.0);
+	QCOMPARE(curve.valueAt(infinity), 1.0);
+
+	auto nan = std::numeric_limits<qreal>::quiet_NaN();
+	auto expected = QEasingCurve(QEasingCurve::InOutQuad).valueForProgress(nan);
+	auto actual = curve.valueAt(nan);
+	QVERIFY(actual == expected || (std::isnan(actual) && std::isnan(expected)));
+
+	// changing the curve after the resolution must rebuild the table
+	curve.setCurve(QEasingCurve(QEasingCurve::Linear));
+	QCOMPARE(curve.valueAt(0.5), 0.5);
+
+	curve.setLookupResolution(0);
+	QCOMPARE(curve.valueAt(0.25), 0.25);
+}
+
+void TestEasingCurve::interpolateRect() { // NOLINT
+	auto curve = EasingCurve();
+	curve.setCurve(QEasingCurve(QEasingCurve::OutCubic));
+
+	auto a = QRectF(0, 0, 10, 10);
+	auto b = QRectF(100, 50, 20, 40);
+	auto y = curve.valueAt(0.3);
+
+	auto expected = QRectF(
+	    QPointF(curve.interpolate(0.3, 0, 100), curve.interpolate(0.3, 0, 50)),
+	    QPointF(10 + (120 - 10) * y, 10 + (90 - 10) * y)
+	);
+
+	QCOMPARE(curve.interpolate(0.3, a, b), expected);
+}
+
+void TestEasingCurve::valuesAt() { // NOLINT
+	auto curve = EasingCurve();
+	curve.setCurve(QEasingCurve(QEasingCurve::InOutQuad));
+
+	auto x = QList<qreal>({0, 0.1, 0.5, 0.9, 1});
+	auto expected = QList<qreal>();
+	for (auto v: x) expected.push_back(curve.valueAt(v));
+
+	QCOMPARE(curve.valuesAt(x), expected);
+}
+
+void TestEasingCurve::benchmark_data() { // NOLINT
+	QTest::addColumn<qint32>("resolution");
+	QTest::addColumn<bool>("batch");
+
+	QTest::addRow("direct") << 0 << false;
+	QTest::addRow("direct-batch") << 0 << true;
+	QTest::addRow("lookup") << 256 << false;
+	QTest::addRow("lookup-batch") << 256 << true;
+}
+
+void TestEasingCurve::benchmark() { // NOLINT
+	QFETCH(qint32, resolution);
+	QFETCH(bool, batch);
+
+	auto curve = EasingCurve();
+	curve.setCurve(QEasingCurve(QEasingCurve::OutElastic));
+	curve.setLookupResolution(resolution);
+
+	auto x = QList<qreal>();
+	for (auto i = 0; i < 1000; i++) x.push_back(static_cast<qreal>(i) / 1000);
+
+	auto a = QRectF(0, 0, 10, 10);
+	auto b = QRectF(100, 50, 20, 40);
+
+	qreal sink = 0;
+
+	if (batch) {
+		QBENCHMARK {
+			for (auto y: curve.valuesAt(x)) sink += y;
+		}
+	} else {
+		QBENCHMARK {
+			for (auto v: x) sink += curve.interpolate(v, a, b).width();
+		}
+	}
+
+	QVERIFY(!std::isnan(sink));
+}
+
+QTEST_MAIN(TestEasingCurve);
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <qobject.h>
+#include <qtmetamacros.h>
+
+class TestEasingCurve: public QObject {
+	Q_OBJECT;
+
+private slots:
+	void lookupAccuracy_data(); // NOLINT
+	void lookupAccuracy();
+	void lookupEndpoints();
+	void interpolateRect();
+	void valuesAt();
+	void benchmark_data(); // NOLINT
+	void benchmark();
+};
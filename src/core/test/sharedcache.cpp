@@ -0,0 +1,72 @@
+#include "sharedcache.hpp"
+
+#include <qlist.h>
+#include <qstring.h>
+#include <qtypes.h>
+#include <qtest.h>
+#include <qtestcase.h>
+#include <qvariant.h>
+
+#include "../sharedcache.hpp"
+
+void TestSharedCache::insertReplace() { // NOLINT
+	auto store = SharedCacheStore();
+
+	store.insert("a", QVariantList({1, 2, 3}));
+	QVERIFY(store.contains("a"));
+	QCOMPARE(store.value("a"), QVariant(QVariantList({1, 2, 3})));
+
+	auto size = store.size();
+	store.insert("a", QString("replaced"));
+	QCOMPARE(store.value("a"), QVariant(QString("replaced")));
+	QVERIFY(store.size() != size);
+
+	QVERIFY(store.remove("a"));
+	QVERIFY(!store.remove("a"));
+	QCOMPARE(store.size(), static_cast<qint64>(0));
+	QCOMPARE(store.value("a", 5), QVariant(5));
+}
+
+void TestSharedCache::expiry() { // NOLINT
+	auto store = SharedCacheStore();
+
+	store.insert("short", 1, 1);
+	store.insert("forever", 2);
+	QTest::qWait(5);
+
+	QVERIFY(!store.contains("short"));
+	QVERIFY(store.contains("forever"));
+	QCOMPARE(store.size(), SharedCacheStore::estimateSize(2) + QString("forever").size() * 2);
+}
+
+void TestSharedCache::evictLeastRecentlyUsed() { // NOLINT
+	auto store = SharedCacheStore();
+	auto value = QString(100, 'x');
+	auto entrySize = SharedCacheStore::estimateSize(value) + 2;
+
+	store.setMaxSize(entrySize * 3);
+	store.insert("a", value);
+	store.insert("b", value);
+	store.insert("c", value);
+
+	// touch a so b is the least recently used
+	QVERIFY(store.value("a").isValid());
+	store.insert("d", value);
+
+	QVERIFY(store.contains("a"));
+	QVERIFY(!store.contains("b"));
+	QVERIFY(store.contains("c"));
+	QVERIFY(store.contains("d"));
+	QVERIFY(store.size() <= store.maxSize());
+}
+
+void TestSharedCache::oversized() { // NOLINT
+	auto store = SharedCacheStore();
+	store.setMaxSize(64);
+
+	store.insert("big", QString(1000, 'x'));
+	QVERIFY(!store.contains("big"));
+	QCOMPARE(store.size(), static_cast<qint64>(0));
+}
+
+QTEST_MAIN(TestSharedCache);
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <qobject.h>
+#include <qtmetamacros.h>
+
+class TestSharedCache: public QObject {
+	Q_OBJECT;
+
+private slots:
+	void insertReplace();
+	void expiry();
+	void evictLeastRecentlyUsed();
+	void oversized();
+};
@@ -1,12 +1,15 @@
 #include "dbusmenu.hpp"
 #include <algorithm>
+#include <utility>
 
 #include <qbytearray.h>
 #include <qcontainerfwd.h>
 #include <qdatetime.h>
+#include <qdbusargument.h>
 #include <qdbusconnection.h>
 #include <qdbusextratypes.h>
 #include <qdbusmetatype.h>
+#include <qdbusmessage.h>
 #include <qdbuspendingcall.h>
 #include <qdbuspendingreply.h>
 #include <qdebug.h>
@@ -29,22 +32,22 @@ Q_LOGGING_CATEGORY(logDbusMenu, "quickshell.dbus.dbusmenu", QtWarningMsg);
 
 namespace qs::dbus::dbusmenu {
 
-DBusMenuItem::DBusMenuItem(qint32 id, DBusMenu* menu, DBusMenuItem* parentMenu)
-    : QObject(menu)
-    , id(id)
-    , menu(menu)
-    , parentMenu(parentMenu) {
-	QObject::connect(
-	    &this->menu->iconThemePath,
-	    &AbstractDBusProperty::changed,
-	    this,
-	    &DBusMenuItem::iconChanged
-	);
+DBusMenuItem::DBusMenuItem(qint32 id, DBusMenu* menu): QObject(menu), id(id), menu(menu) {
+	this->updateImage();
+	this->updateEnabledChildren();
+}
+
+const DBusMenuItemData& DBusMenuItem::data() const {
+	static const auto EMPTY = DBusMenuItemData();
+
+	// items are removed from the menu before their object is deleted
+	auto iter = this->menu->items.constFind(this->id);
+	return iter == this->menu->items.constEnd() ? EMPTY : *iter;
 }
 
 void DBusMenuItem::click() {
-	if (this->displayChildren) {
-		this->setShowChildren(!this->mShowChildren);
+	if (this->data().displayChildren) {
+		this->setShowChildren(!this->data().showChildren);
 	} else {
 		this->menu->sendEvent(this->id, "clicked");
 	}
@@ -53,14 +56,46 @@ void DBusMenuItem::click() {
 void DBusMenuItem::hover() const { this->menu->sendEvent(this->id, "hovered"); }
 
 DBusMenu* DBusMenuItem::menuHandle() const { return this->menu; }
-QString DBusMenuItem::label() const { return this->mLabel; }
-QString DBusMenuItem::cleanLabel() const { return this->mCleanLabel; }
-bool DBusMenuItem::enabled() const { return this->mEnabled; }
+
+QString DBusMenuItem::label() const {
+	auto label = this->data().text;
+	//this->mnemonic = QChar();
+
+	for (auto i = 0; i < label.length() - 1;) {
+		if (label.at(i) == '_') {
+			//if (this->mnemonic == QChar()) this->mnemonic = label.at(i + 1);
+			label.remove(i, 1);
+			label.insert(i + 1, "</u>");
+			label.insert(i, "<u>");
+			i += 8;
+		} else {
+			i++;
+		}
+	}
+
+	return label;
+}
+
+QString DBusMenuItem::cleanLabel() const {
+	auto label = this->data().text;
+
+	for (auto i = 0; i < label.length() - 1; i++) {
+		if (label.at(i) == '_') {
+			label.remove(i, 1);
+		}
+	}
+
+	return label;
+}
+
+bool DBusMenuItem::enabled() const { return this->data().enabled; }
 
 QString DBusMenuItem::icon() const {
-	if (!this->iconName.isEmpty()) {
+	const auto& data = this->data();
+
+	if (!data.iconName.isEmpty()) {
 		return IconImageProvider::requestString(
-		    this->iconName,
+		    data.iconName,
 		    this->menu->iconThemePath.get().join(':')
 		);
 	} else if (this->image != nullptr) {
@@ -68,35 +103,39 @@ QString DBusMenuItem::icon() const {
 	} else return nullptr;
 }
 
-ToggleButtonType::Enum DBusMenuItem::toggleType() const { return this->mToggleType; };
-Qt::CheckState DBusMenuItem::checkState() const { return this->mCheckState; }
-bool DBusMenuItem::isSeparator() const { return this->mSeparator; }
+ToggleButtonType::Enum DBusMenuItem::toggleType() const { return this->data().toggleType; };
+Qt::CheckState DBusMenuItem::checkState() const { return this->data().checkState; }
+bool DBusMenuItem::isSeparator() const { return this->data().separator; }
 
-bool DBusMenuItem::isShowingChildren() const { return this->mShowChildren && this->childrenLoaded; }
+bool DBusMenuItem::isShowingChildren() const {
+	return this->data().showChildren && this->data().childrenLoaded;
+}
 
 void DBusMenuItem::setShowChildren(bool showChildren) {
-	if (showChildren == this->mShowChildren) return;
-	this->mShowChildren = showChildren;
-	this->childrenLoaded = false;
+	auto item = this->menu->items.find(this->id);
+	if (item == this->menu->items.end() || showChildren == item->showChildren) return;
+	item->showChildren = showChildren;
+	item->childrenLoaded = false;
 
 	if (showChildren) {
 		this->menu->prepareToShow(this->id, true);
 	} else {
+		auto children = std::exchange(item->children, {});
+
 		this->menu->sendEvent(this->id, "closed");
 		emit this->showingChildrenChanged();
 
-		if (!this->mChildren.isEmpty()) {
-			for (auto child: this->mChildren) {
+		if (!children.isEmpty()) {
+			for (auto child: children) {
 				this->menu->removeRecursive(child);
 			}
 
-			this->mChildren.clear();
 			this->onChildrenUpdated();
 		}
 	}
 }
 
-bool DBusMenuItem::hasChildren() const { return this->displayChildren; }
+bool DBusMenuItem::hasChildren() const { return this->data().displayChildren; }
 
 QQmlListProperty<DBusMenuItem> DBusMenuItem::children() {
 	return QQmlListProperty<DBusMenuItem>(
@@ -113,174 +152,51 @@ qsizetype DBusMenuItem::childrenCount(QQmlListProperty<DBusMenuItem>* property)
 
 DBusMenuItem* DBusMenuItem::childAt(QQmlListProperty<DBusMenuItem>* property, qsizetype index) {
 	auto* item = reinterpret_cast<DBusMenuItem*>(property->object); // NOLINT
-	return item->menu->items.value(item->enabledChildren.at(index));
+	return item->menu->itemObject(item->enabledChildren.at(index));
 }
 
-void DBusMenuItem::updateProperties(const QVariantMap& properties, const QStringList& removed) {
-	// Some programs appear to think sending an empty map does not mean "reset everything"
-	// and instead means "do nothing". oh well...
-	if (properties.isEmpty() && removed.isEmpty()) {
-		qCDebug(logDbusMenu) << "Ignoring empty property update for" << this;
-		return;
-	}
-
-	auto originalLabel = this->mLabel;
-	//auto originalMnemonic = this->mnemonic;
-	auto originalEnabled = this->mEnabled;
-	auto originalVisible = this->visible;
-	auto originalIconName = this->iconName;
-	auto* originalImage = this->image;
-	auto originalIsSeparator = this->mSeparator;
-	auto originalToggleType = this->mToggleType;
-	auto originalToggleState = this->mCheckState;
-	auto originalDisplayChildren = this->displayChildren;
-
-	auto label = properties.value("label");
-	if (label.canConvert<QString>()) {
-		auto text = label.value<QString>();
-		this->mLabel = text;
-		this->mCleanLabel = text;
-		//this->mnemonic = QChar();
-
-		for (auto i = 0; i < this->mLabel.length() - 1;) {
-			if (this->mLabel.at(i) == '_') {
-				//if (this->mnemonic == QChar()) this->mnemonic = this->mLabel.at(i + 1);
-				this->mLabel.remove(i, 1);
-				this->mLabel.insert(i + 1, "</u>");
-				this->mLabel.insert(i, "<u>");
-				i += 8;
-			} else {
-				i++;
-			}
-		}
-
-		for (auto i = 0; i < this->mCleanLabel.length() - 1; i++) {
-			if (this->mCleanLabel.at(i) == '_') {
-				this->mCleanLabel.remove(i, 1);
-			}
-		}
-	} else if (removed.isEmpty() || removed.contains("label")) {
-		this->mLabel = "";
-		//this->mnemonic = QChar();
-	}
-
-	auto enabled = properties.value("enabled");
-	if (enabled.canConvert<bool>()) {
-		this->mEnabled = enabled.value<bool>();
-	} else if (removed.isEmpty() || removed.contains("enabled")) {
-		this->mEnabled = true;
-	}
-
-	auto visible = properties.value("visible");
-	if (visible.canConvert<bool>()) {
-		this->visible = visible.value<bool>();
-	} else if (removed.isEmpty() || removed.contains("visible")) {
-		this->visible = true;
-	}
-
-	auto iconName = properties.value("icon-name");
-	if (iconName.canConvert<QString>()) {
-		this->iconName = iconName.value<QString>();
-	} else if (removed.isEmpty() || removed.contains("icon-name")) {
-		this->iconName = "";
-	}
-
-	auto iconData = properties.value("icon-data");
-	if (iconData.canConvert<QByteArray>()) {
-		auto data = iconData.value<QByteArray>();
-		if (data.isEmpty()) {
-			this->image = nullptr;
-		} else if (this->image == nullptr || this->image->data != data) {
-			this->image = new DBusMenuPngImage(data, this);
-		}
-	} else if (removed.isEmpty() || removed.contains("icon-data")) {
-		this->image = nullptr;
-	}
-
-	auto type = properties.value("type");
-	if (type.canConvert<QString>()) {
-		this->mSeparator = type.value<QString>() == "separator";
-	} else if (removed.isEmpty() || removed.contains("type")) {
-		this->mSeparator = false;
-	}
-
-	auto toggleType = properties.value("toggle-type");
-	if (toggleType.canConvert<QString>()) {
-		auto toggleTypeStr = toggleType.value<QString>();
-
-		if (toggleTypeStr == "") this->mToggleType = ToggleButtonType::None;
-		else if (toggleTypeStr == "checkmark") this->mToggleType = ToggleButtonType::CheckBox;
-		else if (toggleTypeStr == "radio") this->mToggleType = ToggleButtonType::RadioButton;
-		else {
-			qCWarning(logDbusMenu) << "Unrecognized toggle type" << toggleTypeStr << "for" << this;
-			this->mToggleType = ToggleButtonType::None;
-		}
-	} else if (removed.isEmpty() || removed.contains("toggle-type")) {
-		this->mToggleType = ToggleButtonType::None;
-	}
-
-	auto toggleState = properties.value("toggle-state");
-	if (toggleState.canConvert<qint32>()) {
-		auto toggleStateInt = toggleState.value<qint32>();
-
-		if (toggleStateInt == 0) this->mCheckState = Qt::Unchecked;
-		else if (toggleStateInt == 1) this->mCheckState = Qt::Checked;
-		else this->mCheckState = Qt::PartiallyChecked;
-	} else if (removed.isEmpty() || removed.contains("toggle-state")) {
-		this->mCheckState = Qt::PartiallyChecked;
-	}
-
-	auto childrenDisplay = properties.value("children-display");
-	if (childrenDisplay.canConvert<QString>()) {
-		auto childrenDisplayStr = childrenDisplay.value<QString>();
-
-		if (childrenDisplayStr == "") this->displayChildren = false;
-		else if (childrenDisplayStr == "submenu") this->displayChildren = true;
-		else {
-			qCWarning(logDbusMenu) << "Unrecognized children-display mode" << childrenDisplayStr << "for"
-			                       << this;
-			this->displayChildren = false;
-		}
-	} else if (removed.isEmpty() || removed.contains("children-display")) {
-		this->displayChildren = false;
-	}
+void DBusMenuItem::onDataUpdated(const DBusMenuItemData& original) {
+	const auto& data = this->data();
+
+	auto labelChanged = data.text != original.text;
+	auto enabledChanged = data.enabled != original.enabled;
+	auto toggleTypeChanged = data.toggleType != original.toggleType;
+	auto checkStateChanged = data.checkState != original.checkState;
+	auto separatorChanged = data.separator != original.separator;
+	auto hasChildrenChanged = data.displayChildren != original.displayChildren;
+	auto iconChanged = data.iconName != original.iconName || data.iconData != original.iconData;
+
+	if (data.iconData != original.iconData) this->updateImage();
+
+	if (labelChanged) emit this->labelChanged();
+	if (enabledChanged) emit this->enabledChanged();
+	if (toggleTypeChanged) emit this->toggleTypeChanged();
+	if (checkStateChanged) emit this->checkStateChanged();
+	if (separatorChanged) emit this->separatorChanged();
+	if (hasChildrenChanged) emit this->hasChildrenChanged();
+	if (iconChanged) emit this->iconChanged();
+}
 
-	if (this->mLabel != originalLabel) emit this->labelChanged();
-	//if (this->mnemonic != originalMnemonic) emit this->labelChanged();
-	if (this->mEnabled != originalEnabled) emit this->enabledChanged();
-	if (this->visible != originalVisible && this->parentMenu != nullptr)
-		this->parentMenu->onChildrenUpdated();
-	if (this->mToggleType != originalToggleType) emit this->toggleTypeChanged();
-	if (this->mCheckState != originalToggleState) emit this->checkStateChanged();
-	if (this->mSeparator != originalIsSeparator) emit this->separatorChanged();
-	if (this->displayChildren != originalDisplayChildren) emit this->hasChildrenChanged();
-
-	if (this->iconName != originalIconName || this->image != originalImage) {
-		if (this->image != originalImage) {
-			delete originalImage;
-		}
+void DBusMenuItem::updateImage() {
+	const auto& data = this->data().iconData;
 
-		emit this->iconChanged();
-	}
+	if (this->image != nullptr && this->image->data == data) return;
 
-	qCDebug(logDbusMenu).nospace() << "Updated properties of " << this << " { label=" << this->mLabel
-	                               << ", enabled=" << this->mEnabled << ", visible=" << this->visible
-	                               << ", iconName=" << this->iconName << ", iconData=" << this->image
-	                               << ", separator=" << this->mSeparator
-	                               << ", toggleType=" << this->mToggleType
-	                               << ", toggleState=" << this->mCheckState
-	                               << ", displayChildren=" << this->displayChildren << " }";
+	delete this->image;
+	this->image = data.isEmpty() ? nullptr : new DBusMenuPngImage(data, this);
 }
 
 void DBusMenuItem::onChildrenUpdated() {
+	this->updateEnabledChildren();
+	emit this->childrenChanged();
+}
+
+void DBusMenuItem::updateEnabledChildren() {
 	this->enabledChildren.clear();
 
-	for (auto child: this->mChildren) {
-		auto* item = this->menu->items.value(child);
-		if (item->visible) this->enabledChildren.push_back(child);
+	for (auto child: this->data().children) {
+		if (this->menu->items.value(child).visible) this->enabledChildren.push_back(child);
 	}
-
-	emit this->childrenChanged();
 }
 
 QDebug operator<<(QDebug debug, DBusMenuItem* item) {
@@ -291,7 +207,7 @@ QDebug operator<<(QDebug debug, DBusMenuItem* item) {
 
 	auto saver = QDebugStateSaver(debug);
 	debug.nospace() << "DBusMenuItem(" << static_cast<void*>(item) << ", id=" << item->id
-	                << ", label=" << item->mLabel << ", menu=" << item->menu << ")";
+	                << ", label=" << item->data().text << ", menu=" << item->menu << ")";
 	return debug;
 }
 
@@ -330,6 +246,10 @@ DBusMenu::DBusMenu(const QString& service, const QString& path, QObject* parent)
 	    &DBusMenu::onLayoutUpdated
 	);
 
+	// clang-format off
+	QObject::connect(&this->properties, &DBusPropertyGroup::changed, this, &DBusMenu::onPropertiesChanged);
+	// clang-format on
+
 	this->properties.setInterface(this->interface);
 	this->properties.updateAllViaGetAll();
 }
@@ -359,14 +279,21 @@ void DBusMenu::updateLayout(qint32 parent, qint32 depth) {
 	auto* call = new QDBusPendingCallWatcher(pending, this);
 
 	auto responseCallback = [this, parent, depth](QDBusPendingCallWatcher* call) {
-		const QDBusPendingReply<uint, DBusMenuLayout> reply = *call;
-
-		if (reply.isError()) {
+		if (call->isError()) {
 			qCWarning(logDbusMenu) << "Error updating layout for menu" << parent << "of" << this
-			                       << reply.error();
+			                       << call->error();
 		} else {
-			auto layout = reply.argumentAt<1>();
-			this->updateLayoutRecursive(layout, this->items.value(parent), depth);
+			// deep layouts are the largest replies a menu gets
+			auto message = call->reply();
+			auto decode = [message]() {
+				return qdbus_cast<DBusMenuLayout>(message.arguments().value(1));
+			};
+
+			auto apply = [this, depth](const DBusMenuLayout& layout) {
+				this->updateLayoutRecursive(layout, depth);
+			};
+
+			dbus::demarshallAsync(this, decode, apply);
 		}
 
 		delete call;
@@ -375,29 +302,141 @@ void DBusMenu::updateLayout(qint32 parent, qint32 depth) {
 	QObject::connect(call, &QDBusPendingCallWatcher::finished, this, responseCallback);
 }
 
-void DBusMenu::updateLayoutRecursive(
-    const DBusMenuLayout& layout,
-    DBusMenuItem* parent,
-    qint32 depth
+void DBusMenu::updateItemProperties(
+    qint32 id,
+    const QVariantMap& properties,
+    const QStringList& removed
 ) {
-	auto* item = this->items.value(layout.id);
-	if (item == nullptr) {
-		// there is an actual nullptr in the map and not no entry
-		if (this->items.contains(layout.id)) {
-			item = new DBusMenuItem(layout.id, this, parent);
-			this->items.insert(layout.id, item);
+	auto item = this->items.find(id);
+	if (item == this->items.end()) return;
+
+	// Some programs appear to think sending an empty map does not mean "reset everything"
+	// and instead means "do nothing". oh well...
+	if (properties.isEmpty() && removed.isEmpty()) {
+		qCDebug(logDbusMenu) << "Ignoring empty property update for item" << id << "of" << this;
+		return;
+	}
+
+	auto original = *item;
+
+	auto label = properties.value("label");
+	if (label.canConvert<QString>()) {
+		item->text = label.value<QString>();
+	} else if (removed.isEmpty() || removed.contains("label")) {
+		item->text = "";
+	}
+
+	auto enabled = properties.value("enabled");
+	if (enabled.canConvert<bool>()) {
+		item->enabled = enabled.value<bool>();
+	} else if (removed.isEmpty() || removed.contains("enabled")) {
+		item->enabled = true;
+	}
+
+	auto visible = properties.value("visible");
+	if (visible.canConvert<bool>()) {
+		item->visible = visible.value<bool>();
+	} else if (removed.isEmpty() || removed.contains("visible")) {
+		item->visible = true;
+	}
+
+	auto iconName = properties.value("icon-name");
+	if (iconName.canConvert<QString>()) {
+		item->iconName = iconName.value<QString>();
+	} else if (removed.isEmpty() || removed.contains("icon-name")) {
+		item->iconName = "";
+	}
+
+	auto iconData = properties.value("icon-data");
+	if (iconData.canConvert<QByteArray>()) {
+		item->iconData = iconData.value<QByteArray>();
+	} else if (removed.isEmpty() || removed.contains("icon-data")) {
+		item->iconData.clear();
+	}
+
+	auto type = properties.value("type");
+	if (type.canConvert<QString>()) {
+		item->separator = type.value<QString>() == "separator";
+	} else if (removed.isEmpty() || removed.contains("type")) {
+		item->separator = false;
+	}
+
+	auto toggleType = properties.value("toggle-type");
+	if (toggleType.canConvert<QString>()) {
+		auto toggleTypeStr = toggleType.value<QString>();
+
+		if (toggleTypeStr == "") item->toggleType = ToggleButtonType::None;
+		else if (toggleTypeStr == "checkmark") item->toggleType = ToggleButtonType::CheckBox;
+		else if (toggleTypeStr == "radio") item->toggleType = ToggleButtonType::RadioButton;
+		else {
+			qCWarning(logDbusMenu) << "Unrecognized toggle type" << toggleTypeStr << "for item" << id
+			                       << "of" << this;
+			item->toggleType = ToggleButtonType::None;
+		}
+	} else if (removed.isEmpty() || removed.contains("toggle-type")) {
+		item->toggleType = ToggleButtonType::None;
+	}
+
+	auto toggleState = properties.value("toggle-state");
+	if (toggleState.canConvert<qint32>()) {
+		auto toggleStateInt = toggleState.value<qint32>();
+
+		if (toggleStateInt == 0) item->checkState = Qt::Unchecked;
+		else if (toggleStateInt == 1) item->checkState = Qt::Checked;
+		else item->checkState = Qt::PartiallyChecked;
+	} else if (removed.isEmpty() || removed.contains("toggle-state")) {
+		item->checkState = Qt::PartiallyChecked;
+	}
+
+	auto childrenDisplay = properties.value("children-display");
+	if (childrenDisplay.canConvert<QString>()) {
+		auto childrenDisplayStr = childrenDisplay.value<QString>();
+
+		if (childrenDisplayStr == "") item->displayChildren = false;
+		else if (childrenDisplayStr == "submenu") item->displayChildren = true;
+		else {
+			qCWarning(logDbusMenu) << "Unrecognized children-display mode" << childrenDisplayStr
+			                       << "for item" << id << "of" << this;
+			item->displayChildren = false;
 		}
+	} else if (removed.isEmpty() || removed.contains("children-display")) {
+		item->displayChildren = false;
 	}
 
-	if (item == nullptr) return;
+	qCDebug(logDbusMenu).nospace() << "Updated properties of item " << id << " of " << this
+	                               << " { label=" << item->text << ", enabled=" << item->enabled
+	                               << ", visible=" << item->visible
+	                               << ", iconName=" << item->iconName
+	                               << ", iconData=" << item->iconData.size() << " bytes"
+	                               << ", separator=" << item->separator
+	                               << ", toggleType=" << item->toggleType
+	                               << ", toggleState=" << item->checkState
+	                               << ", displayChildren=" << item->displayChildren << " }";
+
+	auto visibilityChanged = item->visible != original.visible;
+	auto parent = item->parent;
+
+	// signal handlers may modify the item table, so item is not used past this point
+	if (auto* object = this->objects.value(id)) object->onDataUpdated(original);
+
+	if (visibilityChanged) {
+		if (auto* object = this->objects.value(parent)) object->onChildrenUpdated();
+	}
+}
+
+void DBusMenu::updateLayoutRecursive(const DBusMenuLayout& layout, qint32 depth) {
+	if (!this->items.contains(layout.id)) return;
 
 	qCDebug(logDbusMenu) << "Updating layout recursively for" << this << "menu" << layout.id;
-	item->updateProperties(layout.properties);
+	this->updateItemProperties(layout.id, layout.properties, {});
 
 	if (depth != 0) {
+		// copied, as the item table changes while children are added and removed
+		auto item = this->items.value(layout.id);
 		auto childrenChanged = false;
-		auto iter = item->mChildren.begin();
-		while (iter != item->mChildren.end()) {
+
+		auto iter = item.children.begin();
+		while (iter != item.children.end()) {
 			auto existing = std::find_if(
 			    layout.children.begin(),
 			    layout.children.end(),
@@ -405,10 +444,10 @@ void DBusMenu::updateLayoutRecursive(
 			);
 
 			if (existing == layout.children.end()) {
-				qCDebug(logDbusMenu) << "Removing missing layout item" << this->items.value(*iter) << "from"
-				                     << item;
+				qCDebug(logDbusMenu) << "Removing missing layout item" << *iter << "from menu" << layout.id
+				                     << "of" << this;
 				this->removeRecursive(*iter);
-				iter = item->mChildren.erase(iter);
+				iter = item.children.erase(iter);
 				childrenChanged = true;
 			} else {
 				iter++;
@@ -416,39 +455,58 @@ void DBusMenu::updateLayoutRecursive(
 		}
 
 		for (const auto& child: layout.children) {
-			if (item->mShowChildren && !item->mChildren.contains(child.id)) {
-				qCDebug(logDbusMenu) << "Creating new layout item" << child.id << "in" << item;
-				item->mChildren.push_back(child.id);
-				this->items.insert(child.id, nullptr);
+			if (item.showChildren && !item.children.contains(child.id)) {
+				qCDebug(logDbusMenu) << "Creating new layout item" << child.id << "in menu" << layout.id
+				                     << "of" << this;
+				item.children.push_back(child.id);
+
+				auto data = DBusMenuItemData();
+				data.parent = layout.id;
+				this->items.insert(child.id, data);
 				childrenChanged = true;
 			}
+		}
+
+		if (childrenChanged) this->items[layout.id].children = item.children;
 
-			this->updateLayoutRecursive(child, item, depth - 1);
+		for (const auto& child: layout.children) {
+			this->updateLayoutRecursive(child, depth - 1);
 		}
 
-		if (childrenChanged) item->onChildrenUpdated();
+		if (childrenChanged) {
+			if (auto* object = this->objects.value(layout.id)) object->onChildrenUpdated();
+		}
 	}
 
-	if (item->mShowChildren && !item->childrenLoaded) {
-		item->childrenLoaded = true;
-		emit item->showingChildrenChanged();
+	auto shown = this->items.find(layout.id);
+	if (shown != this->items.end() && shown->showChildren && !shown->childrenLoaded) {
+		shown->childrenLoaded = true;
+		if (auto* object = this->objects.value(layout.id)) emit object->showingChildrenChanged();
 	}
 }
 
 void DBusMenu::removeRecursive(qint32 id) {
-	auto* item = this->items.value(id);
+	auto item = this->items.take(id);
 
-	if (item != nullptr) {
-		for (auto child: item->mChildren) {
-			this->removeRecursive(child);
-		}
+	for (auto child: item.children) {
+		this->removeRecursive(child);
 	}
 
-	this->items.remove(id);
+	auto* object = this->objects.take(id);
+	if (object != nullptr && object != &this->rootItem) {
+		object->deleteLater();
+	}
+}
+
+DBusMenuItem* DBusMenu::itemObject(qint32 id) {
+	auto* object = this->objects.value(id);
 
-	if (item != nullptr) {
-		item->deleteLater();
+	if (object == nullptr && this->items.contains(id)) {
+		object = new DBusMenuItem(id, this);
+		this->objects.insert(id, object);
 	}
+
+	return object;
 }
 
 void DBusMenu::sendEvent(qint32 item, const QString& event) {
@@ -474,6 +532,17 @@ void DBusMenu::sendEvent(qint32 item, const QString& event) {
 
 DBusMenuItem* DBusMenu::menu() { return &this->rootItem; }
 
+void DBusMenu::onPropertiesChanged(quint64 cells) {
+	if ((cells & this->iconThemePath.bit()) == 0) return;
+
+	// Only named icons are looked up in the theme path. Copied as handlers may create objects.
+	const auto objects = this->objects.values();
+
+	for (auto* object: objects) {
+		if (!object->data().iconName.isEmpty()) emit object->iconChanged();
+	}
+}
+
 void DBusMenu::onLayoutUpdated(quint32 /*unused*/, qint32 parent) {
 	// note: spec says this is recursive
 	this->updateLayout(parent, -1);
@@ -484,17 +553,11 @@ void DBusMenu::onItemPropertiesUpdated( // NOLINT
     const DBusMenuItemPropertyNamesList& removedProps
 ) {
 	for (const auto& propset: updatedProps) {
-		auto* item = this->items.value(propset.id);
-		if (item != nullptr) {
-			item->updateProperties(propset.properties);
-		}
+		this->updateItemProperties(propset.id, propset.properties, {});
 	}
 
 	for (const auto& propset: removedProps) {
-		auto* item = this->items.value(propset.id);
-		if (item != nullptr) {
-			item->updateProperties({}, propset.properties);
-		}
+		this->updateItemProperties(propset.id, {}, propset.properties);
 	}
 }
 
@@ -44,6 +44,24 @@ QDebug operator<<(QDebug debug, const ToggleButtonType::Enum& toggleType);
 class DBusMenu;
 class DBusMenuPngImage;
 
+// State of a menu item, stored in its menu whether or not a DBusMenuItem exists for it.
+struct DBusMenuItemData {
+	// label as sent, with `_` marking the mnemonic
+	QString text;
+	QString iconName;
+	QByteArray iconData;
+	QVector<qint32> children;
+	qint32 parent = -1;
+	ToggleButtonType::Enum toggleType = ToggleButtonType::None;
+	Qt::CheckState checkState = Qt::Checked;
+	bool enabled = true;
+	bool visible = true;
+	bool separator = false;
+	bool displayChildren = false;
+	bool showChildren = false;
+	bool childrenLoaded = false;
+};
+
 ///! Menu item shared by an external program.
 /// Menu item shared by an external program via the
 /// [DBusMenu specification](https://github.com/AyatanaIndicators/libdbusmenu/blob/master/libdbusmenu-glib/dbus-menu.xml).
@@ -108,7 +126,7 @@ class DBusMenuItem: public QObject {
 	QML_UNCREATABLE("DBusMenus can only be acquired from a DBusMenuHandle");
 
 public:
-	explicit DBusMenuItem(qint32 id, DBusMenu* menu, DBusMenuItem* parentMenu);
+	explicit DBusMenuItem(qint32 id, DBusMenu* menu);
 
 	/// Send a `clicked` event to the remote application for this menu item.
 	Q_INVOKABLE void click();
@@ -133,14 +151,13 @@ public:
 
 	[[nodiscard]] QQmlListProperty<DBusMenuItem> children();
 
-	void updateProperties(const QVariantMap& properties, const QStringList& removed = {});
+	// Emits change signals for everything that differs from `original`.
+	void onDataUpdated(const DBusMenuItemData& original);
 	void onChildrenUpdated();
 
+	[[nodiscard]] const DBusMenuItemData& data() const;
+
 	qint32 id = 0;
-	QString mLabel;
-	QVector<qint32> mChildren;
-	bool mShowChildren = false;
-	bool childrenLoaded = false;
 	DBusMenu* menu = nullptr;
 
 signals:
@@ -156,18 +173,11 @@ signals:
 	void childrenChanged();
 
 private:
-	QString mCleanLabel;
-	//QChar mnemonic;
-	bool mEnabled = true;
-	bool visible = true;
-	bool mSeparator = false;
-	QString iconName;
+	void updateImage();
+	void updateEnabledChildren();
+
 	DBusMenuPngImage* image = nullptr;
-	ToggleButtonType::Enum mToggleType = ToggleButtonType::None;
-	Qt::CheckState mCheckState = Qt::Checked;
-	bool displayChildren = false;
 	QVector<qint32> enabledChildren;
-	DBusMenuItem* parentMenu = nullptr;
 
 	static qsizetype childrenCount(QQmlListProperty<DBusMenuItem>* property);
 	static DBusMenuItem* childAt(QQmlListProperty<DBusMenuItem>* property, qsizetype index);
@@ -187,22 +197,30 @@ public:
 	explicit DBusMenu(const QString& service, const QString& path, QObject* parent = nullptr);
 
 	dbus::DBusPropertyGroup properties;
-	dbus::DBusProperty<quint32> version {this->properties, "Version"};
-	dbus::DBusProperty<QString> textDirection {this->properties, "TextDirection"};
-	dbus::DBusProperty<QString> status {this->properties, "Status"};
-	dbus::DBusProperty<QStringList> iconThemePath {this->properties, "IconThemePath"};
+	dbus::DBusPropertyCell<quint32> version {this->properties, "Version"};
+	dbus::DBusPropertyCell<QString> textDirection {this->properties, "TextDirection"};
+	dbus::DBusPropertyCell<QString> status {this->properties, "Status"};
+	dbus::DBusPropertyCell<QStringList> iconThemePath {this->properties, "IconThemePath"};
 
 	void prepareToShow(qint32 item, bool sendOpened);
 	void updateLayout(qint32 parent, qint32 depth);
+	void updateItemProperties(qint32 id, const QVariantMap& properties, const QStringList& removed);
 	void removeRecursive(qint32 id);
 	void sendEvent(qint32 item, const QString& event);
 
-	DBusMenuItem rootItem {0, this, nullptr};
-	QHash<qint32, DBusMenuItem*> items {std::make_pair(0, &this->rootItem)};
+	// Returns the object for a known item, creating it if it does not exist yet.
+	[[nodiscard]] DBusMenuItem* itemObject(qint32 id);
+
+	// every item of every loaded submenu
+	QHash<qint32, DBusMenuItemData> items {std::make_pair(0, DBusMenuItemData())};
+	DBusMenuItem rootItem {0, this};
+	// only items that have been exposed to qml
+	QHash<qint32, DBusMenuItem*> objects {std::make_pair(0, &this->rootItem)};
 
 	[[nodiscard]] DBusMenuItem* menu();
 
 private slots:
+	void onPropertiesChanged(quint64 cells);
 	void onLayoutUpdated(quint32 revision, qint32 parent);
 	void onItemPropertiesUpdated(
 	    const DBusMenuItemPropertiesList& updatedProps,
@@ -210,7 +228,7 @@ private slots:
 	);
 
 private:
-	void updateLayoutRecursive(const DBusMenuLayout& layout, DBusMenuItem* parent, qint32 depth);
+	void updateLayoutRecursive(const DBusMenuLayout& layout, qint32 depth);
 
 	DBusMenuInterface* interface = nullptr;
 };
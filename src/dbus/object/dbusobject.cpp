@@ -0,0 +1,351 @@
+#include "dbusobject.hpp"
+#include <utility>
+
+#include <qbytearray.h>
+#include <qcontainerfwd.h>
+#include <qdbusargument.h>
+#include <qdbusconnection.h>
+#include <qdbusconnectioninterface.h>
+#include <qdbuserror.h>
+#include <qdbusextratypes.h>
+#include <qdbusmessage.h>
+#include <qdbuspendingcall.h>
+#include <qdbuspendingreply.h>
+#include <qdbusservicewatcher.h>
+#include <qlogging.h>
+#include <qloggingcategory.h>
+#include <qmetatype.h>
+#include <qobject.h>
+#include <qqmlpropertymap.h>
+#include <qtypes.h>
+#include <qvariant.h>
+
+#include "../properties.hpp"
+
+Q_LOGGING_CATEGORY(logDbusObject, "quickshell.dbus.object", QtWarningMsg);
+
+namespace qs::dbus {
+
+namespace {
+
+QVariant toQmlValue(const QVariant& value);
+
+// converts container types which QML can't read directly into lists and maps
+QVariant argumentToQmlValue(const QDBusArgument& argument) {
+	switch (argument.currentType()) {
+	case QDBusArgument::BasicType:
+	case QDBusArgument::VariantType: return toQmlValue(argument.asVariant());
+	case QDBusArgument::ArrayType: {
+		if (argument.currentSignature() == "ay") {
+			QByteArray bytes;
+			argument >> bytes;
+			return bytes;
+		}
+
+		QVariantList list;
+		argument.beginArray();
+		while (!argument.atEnd()) list.append(argumentToQmlValue(argument));
+		argument.endArray();
+		return list;
+	}
+	case QDBusArgument::StructureType: {
+		QVariantList list;
+		argument.beginStructure();
+		while (!argument.atEnd()) list.append(argumentToQmlValue(argument));
+		argument.endStructure();
+		return list;
+	}
+	case QDBusArgument::MapType: {
+		QVariantMap map;
+		argument.beginMap();
+
+		while (!argument.atEnd()) {
+			argument.beginMapEntry();
+			auto key = argumentToQmlValue(argument).toString();
+			map.insert(key, argumentToQmlValue(argument));
+			argument.endMapEntry();
+		}
+
+		argument.endMap();
+		return map;
+	}
+	default: return QVariant();
+	}
+}
+
+QVariant toQmlValue(const QVariant& value) {
+	auto type = value.metaType();
+
+	if (type == QMetaType::fromType<QDBusArgument>()) {
+		return argumentToQmlValue(qvariant_cast<QDBusArgument>(value));
+	} else if (type == QMetaType::fromType<QDBusVariant>()) {
+		return toQmlValue(qvariant_cast<QDBusVariant>(value).variant());
+	} else if (type == QMetaType::fromType<QDBusObjectPath>()) {
+		return qvariant_cast<QDBusObjectPath>(value).path();
+	} else if (type == QMetaType::fromType<QDBusSignature>()) {
+		return qvariant_cast<QDBusSignature>(value).signature();
+	}
+
+	return value;
+}
+
+} // namespace
+
+DBusObjectPropertyMap::DBusObjectPropertyMap(DBusObject* object)
+    : QQmlPropertyMap(this, object)
+    , object(object) {}
+
+QVariant DBusObjectPropertyMap::updateValue(const QString& key, const QVariant& input) {
+	this->object->writeProperty(key, input);
+	return this->value(key);
+}
+
+DBusObject::DBusObject(QObject* parent)
+    : QObject(parent)
+    , mProperties(new DBusObjectPropertyMap(this)) {
+	this->serviceWatcher.setWatchMode(QDBusServiceWatcher::WatchForOwnerChange);
+
+	// clang-format off
+	QObject::connect(&this->serviceWatcher, &QDBusServiceWatcher::serviceOwnerChanged, this, &DBusObject::onServiceOwnerChanged);
+	QObject::connect(&this->propertyGroup, &DBusPropertyGroup::untrackedPropertyUpdated, this, &DBusObject::onPropertyUpdated);
+	QObject::connect(&this->propertyGroup, &DBusPropertyGroup::untrackedPropertyInvalidated, this, &DBusObject::onPropertyInvalidated);
+	QObject::connect(&this->propertyGroup, &DBusPropertyGroup::getAllFinished, this, &DBusObject::onGetAllFinished);
+	// clang-format on
+}
+
+void DBusObject::componentComplete() {
+	this->componentCompleted = true;
+	this->rebind();
+}
+
+void DBusObject::rebind() {
+	if (!this->componentCompleted) return;
+
+	this->propertyGroup.setInterface(nullptr);
+	delete this->dbusInterface;
+	this->dbusInterface = nullptr;
+
+	this->serviceWatcher.setWatchedServices(QStringList());
+	this->setOwner("");
+	this->setReady(false);
+	this->clearProperties();
+
+	if (this->mService.isEmpty() || this->mPath.isEmpty() || this->mInterface.isEmpty()) return;
+
+	auto connection = this->mBus == DBusBusType::System ? QDBusConnection::systemBus()
+	                                                     : QDBusConnection::sessionBus();
+
+	if (!connection.isConnected()) {
+		qCWarning(logDbusObject) << "Could not connect to the" << this->mBus << "bus for" << this;
+		return;
+	}
+
+	this->dbusInterface =
+	    new DBusObjectInterface(this->mService, this->mPath, this->mInterface, connection, this);
+	this->propertyGroup.setInterface(this->dbusInterface);
+
+	this->serviceWatcher.setConnection(connection);
+	this->serviceWatcher.setWatchedServices({this->mService});
+
+	auto pendingCall = connection.interface()->asyncCall("GetNameOwner", this->mService);
+	auto* call = new QDBusPendingCallWatcher(pendingCall, this->dbusInterface);
+
+	auto responseCallback = [this](QDBusPendingCallWatcher* call) {
+		const QDBusPendingReply<QString> reply = *call;
+
+		// an error means the service has no owner, which the service watcher will report
+		if (!reply.isError() && this->mOwner.isEmpty()) {
+			this->setOwner(reply.value());
+			this->propertyGroup.updateAllViaGetAll();
+		}
+
+		delete call;
+	};
+
+	QObject::connect(call, &QDBusPendingCallWatcher::finished, this, responseCallback);
+}
+
+void DBusObject::onServiceOwnerChanged(
+    const QString& /*service*/,
+    const QString& /*oldOwner*/,
+    const QString& newOwner
+) {
+	// properties of the previous owner are meaningless for the new one
+	this->setReady(false);
+	this->clearProperties();
+	this->setOwner(newOwner);
+
+	if (!newOwner.isEmpty()) this->propertyGroup.updateAllViaGetAll();
+}
+
+void DBusObject::onPropertyUpdated(const QString& name, const QVariant& value) {
+	auto qmlValue = toQmlValue(value);
+	if (this->setProperties.contains(name) && this->mProperties->value(name) == qmlValue) return;
+
+	this->setProperties.insert(name);
+	this->mProperties->insert(name, qmlValue);
+	emit this->propertyChanged(name, qmlValue);
+}
+
+void DBusObject::onPropertyInvalidated(const QString& name) {
+	if (this->dbusInterface == nullptr) return;
+
+	auto callMessage = QDBusMessage::createMethodCall(
+	    this->dbusInterface->service(),
+	    this->dbusInterface->path(),
+	    "org.freedesktop.DBus.Properties",
+	    "Get"
+	);
+
+	callMessage << this->mInterface << name;
+	auto pendingCall = this->dbusInterface->connection().asyncCall(callMessage);
+	auto* call = new QDBusPendingCallWatcher(pendingCall, this->dbusInterface);
+
+	auto responseCallback = [this, name](QDBusPendingCallWatcher* call) {
+		const QDBusPendingReply<QDBusVariant> reply = *call;
+
+		if (reply.isError()) {
+			qCWarning(logDbusObject) << "Error reading invalidated property" << name << "of" << this;
+			qCWarning(logDbusObject) << reply.error();
+		} else {
+			this->onPropertyUpdated(name, reply.value().variant());
+		}
+
+		delete call;
+	};
+
+	QObject::connect(call, &QDBusPendingCallWatcher::finished, this, responseCallback);
+}
+
+void DBusObject::onGetAllFinished() { this->setReady(true); }
+
+qint32 DBusObject::call(const QString& method, const QVariantList& args) {
+	if (this->dbusInterface == nullptr) {
+		qCWarning(logDbusObject) << "Cannot call" << method << "on unbound object" << this;
+		return -1;
+	}
+
+	auto id = this->nextCallId++;
+	auto pendingCall = this->dbusInterface->asyncCallWithArgumentList(method, args);
+	auto* call = new QDBusPendingCallWatcher(pendingCall, this->dbusInterface);
+
+	auto responseCallback = [this, id](QDBusPendingCallWatcher* call) {
+		if (call->isError()) {
+			emit this->callFailed(id, call->error().message());
+		} else {
+			auto arguments = call->reply().arguments();
+
+			QVariant result;
+			if (arguments.length() == 1) {
+				result = toQmlValue(arguments.first());
+			} else if (arguments.length() > 1) {
+				QVariantList list;
+				for (const auto& argument: arguments) list.append(toQmlValue(argument));
+				result = list;
+			}
+
+			emit this->callFinished(id, result);
+		}
+
+		delete call;
+	};
+
+	QObject::connect(call, &QDBusPendingCallWatcher::finished, this, responseCallback);
+	return id;
+}
+
+void DBusObject::writeProperty(const QString& name, const QVariant& value) {
+	if (this->dbusInterface == nullptr) {
+		qCWarning(logDbusObject) << "Cannot set property" << name << "of unbound object" << this;
+		return;
+	}
+
+	auto callMessage = QDBusMessage::createMethodCall(
+	    this->dbusInterface->service(),
+	    this->dbusInterface->path(),
+	    "org.freedesktop.DBus.Properties",
+	    "Set"
+	);
+
+	callMessage << this->mInterface << name << QVariant::fromValue(QDBusVariant(value));
+	auto pendingCall = this->dbusInterface->connection().asyncCall(callMessage);
+	auto* call = new QDBusPendingCallWatcher(pendingCall, this->dbusInterface);
+
+	auto responseCallback = [this, name](QDBusPendingCallWatcher* call) {
+		if (call->isError()) {
+			qCWarning(logDbusObject) << "Error setting property" << name << "of" << this;
+			qCWarning(logDbusObject) << call->error();
+		}
+
+		delete call;
+	};
+
+	QObject::connect(call, &QDBusPendingCallWatcher::finished, this, responseCallback);
+}
+
+void DBusObject::refresh() {
+	if (this->dbusInterface == nullptr || this->mOwner.isEmpty()) return;
+	this->propertyGroup.updateAllViaGetAll();
+}
+
+void DBusObject::clearProperties() {
+	for (const auto& name: std::exchange(this->setProperties, {})) {
+		this->mProperties->clear(name);
+		emit this->propertyChanged(name, QVariant());
+	}
+}
+
+DBusBusType::Enum DBusObject::bus() const { return this->mBus; }
+
+void DBusObject::setBus(DBusBusType::Enum bus) {
+	if (bus == this->mBus) return;
+	this->mBus = bus;
+	emit this->busChanged();
+	this->rebind();
+}
+
+QString DBusObject::service() const { return this->mService; }
+
+void DBusObject::setService(QString service) {
+	if (service == this->mService) return;
+	this->mService = std::move(service);
+	emit this->serviceChanged();
+	this->rebind();
+}
+
+QString DBusObject::path() const { return this->mPath; }
+
+void DBusObject::setPath(QString path) {
+	if (path == this->mPath) return;
+	this->mPath = std::move(path);
+	emit this->pathChanged();
+	this->rebind();
+}
+
+QString DBusObject::interface() const { return this->mInterface; }
+
+void DBusObject::setInterface(QString interface) {
+	if (interface == this->mInterface) return;
+	this->mInterface = std::move(interface);
+	emit this->interfaceChanged();
+	this->rebind();
+}
+
+QQmlPropertyMap* DBusObject::properties() const { return this->mProperties; }
+QString DBusObject::owner() const { return this->mOwner; }
+bool DBusObject::available() const { return !this->mOwner.isEmpty(); }
+bool DBusObject::ready() const { return this->mReady; }
+
+void DBusObject::setOwner(const QString& owner) {
+	if (owner == this->mOwner) return;
+	this->mOwner = owner;
+	emit this->ownerChanged();
+}
+
+void DBusObject::setReady(bool ready) {
+	if (ready == this->mReady) return;
+	this->mReady = ready;
+	emit this->readyChanged();
+}
+
+} // namespace qs::dbus
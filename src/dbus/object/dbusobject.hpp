@@ -0,0 +1,215 @@
+#pragma once
+
+#include <qcontainerfwd.h>
+#include <qdbusabstractinterface.h>
+#include <qdbusconnection.h>
+#include <qdbusservicewatcher.h>
+#include <qloggingcategory.h>
+#include <qobject.h>
+#include <qqmlintegration.h>
+#include <qqmlparserstatus.h>
+#include <qqmlpropertymap.h>
+#include <qset.h>
+#include <qtmetamacros.h>
+#include <qtypes.h>
+#include <qvariant.h>
+
+#include "../properties.hpp"
+
+Q_DECLARE_LOGGING_CATEGORY(logDbusObject);
+
+namespace DBusBusType { // NOLINT
+Q_NAMESPACE;
+QML_ELEMENT;
+
+enum Enum {
+	/// The user's session bus.
+	Session = 0,
+	/// The system bus.
+	System = 1,
+};
+Q_ENUM_NS(Enum);
+
+} // namespace DBusBusType
+
+namespace qs::dbus {
+
+class DBusObject;
+
+// Plain interface without the blocking introspection done by QDBusInterface.
+class DBusObjectInterface: public QDBusAbstractInterface {
+public:
+	DBusObjectInterface(
+	    const QString& service,
+	    const QString& path,
+	    const QString& interface,
+	    const QDBusConnection& connection,
+	    QObject* parent = nullptr
+	)
+	    : QDBusAbstractInterface(
+	          service,
+	          path,
+	          interface.toUtf8().constData(),
+	          connection,
+	          parent
+	      ) {}
+};
+
+// Writes from QML are sent to the remote object instead of changing the cached value,
+// which is updated once the object reports the change.
+class DBusObjectPropertyMap: public QQmlPropertyMap {
+	Q_OBJECT;
+
+public:
+	explicit DBusObjectPropertyMap(DBusObject* object);
+
+protected:
+	QVariant updateValue(const QString& key, const QVariant& input) override;
+
+private:
+	DBusObject* object;
+};
+
+///! Proxy for an object on D-Bus.
+/// Proxy for a single interface of an object on D-Bus, with a cached copy of
+/// its properties.
+///
+/// Properties are fetched once when the service appears, and are then kept up to date
+/// using the `PropertiesChanged` signal, so no polling is required.
+///
+/// #### Example
+/// ```qml
+/// DBusObject {
+///   id: battery
+///   bus: DBusBusType.System
+///   service: "org.freedesktop.UPower"
+///   path: "/org/freedesktop/UPower/devices/DisplayDevice"
+///   interface: "org.freedesktop.UPower.Device"
+/// }
+///
+/// Text { text: `${battery.properties.Percentage}%` }
+/// ```
+///
+/// > [!NOTE] Only objects which emit `org.freedesktop.DBus.Properties.PropertiesChanged`
+/// > are updated automatically. Use [refresh()](#func.refresh) for ones that don't.
+class DBusObject
+    : public QObject
+    , public QQmlParserStatus {
+	Q_OBJECT;
+	Q_INTERFACES(QQmlParserStatus);
+	// clang-format off
+	/// The bus the object is on. Defaults to `DBusBusType.Session`.
+	Q_PROPERTY(DBusBusType::Enum bus READ bus WRITE setBus NOTIFY busChanged);
+	/// The well known or unique name of the service owning the object.
+	Q_PROPERTY(QString service READ service WRITE setService NOTIFY serviceChanged);
+	/// The path of the object.
+	Q_PROPERTY(QString path READ path WRITE setPath NOTIFY pathChanged);
+	/// The interface of the object to access.
+	Q_PROPERTY(QString interface READ interface WRITE setInterface NOTIFY interfaceChanged);
+	/// The cached properties of the interface, by name.
+	///
+	/// Writing to a property sets it on the remote object. The cached value only
+	/// changes once the object reports the change.
+	///
+	/// All properties are removed when the service disappears.
+	Q_PROPERTY(QQmlPropertyMap* properties READ properties CONSTANT);
+	/// The unique name of the current owner of `service`, or an empty string if it has none.
+	Q_PROPERTY(QString owner READ owner NOTIFY ownerChanged);
+	/// If `service` currently has an owner.
+	Q_PROPERTY(bool available READ available NOTIFY ownerChanged);
+	/// If properties have been fetched from the current owner of `service`.
+	Q_PROPERTY(bool ready READ ready NOTIFY readyChanged);
+	// clang-format on
+	QML_ELEMENT;
+
+public:
+	explicit DBusObject(QObject* parent = nullptr);
+
+	void classBegin() override {}
+	void componentComplete() override;
+
+	/// Call a method on the interface without waiting for the result.
+	///
+	/// Arguments are sent with the D-Bus type matching their QML type, for example
+	/// `i` for integers, `d` for other numbers and `a{sv}` for objects.
+	///
+	/// Returns the id of the call, which is passed to [callFinished()] or [callFailed()],
+	/// or -1 if the object is not bound.
+	///
+	/// [callFinished()]: #sig.callFinished
+	/// [callFailed()]: #sig.callFailed
+	Q_INVOKABLE qint32 call(const QString& method, const QVariantList& args = QVariantList());
+
+	/// Set a property on the remote object.
+	Q_INVOKABLE void writeProperty(const QString& name, const QVariant& value);
+
+	/// Fetch all properties again.
+	Q_INVOKABLE void refresh();
+
+	[[nodiscard]] DBusBusType::Enum bus() const;
+	void setBus(DBusBusType::Enum bus);
+
+	[[nodiscard]] QString service() const;
+	void setService(QString service);
+
+	[[nodiscard]] QString path() const;
+	void setPath(QString path);
+
+	[[nodiscard]] QString interface() const;
+	void setInterface(QString interface);
+
+	[[nodiscard]] QQmlPropertyMap* properties() const;
+	[[nodiscard]] QString owner() const;
+	[[nodiscard]] bool available() const;
+	[[nodiscard]] bool ready() const;
+
+signals:
+	/// Sent when a cached property changes. `value` is undefined if the property was removed.
+	void propertyChanged(const QString& name, const QVariant& value);
+	/// Sent when a call made with [call()](#func.call) returns. Methods returning
+	/// multiple values return them as a list.
+	void callFinished(qint32 id, const QVariant& result);
+	/// Sent when a call made with [call()](#func.call) fails.
+	void callFailed(qint32 id, const QString& error);
+
+	void busChanged();
+	void serviceChanged();
+	void pathChanged();
+	void interfaceChanged();
+	void ownerChanged();
+	void readyChanged();
+
+private slots:
+	void onServiceOwnerChanged(
+	    const QString& service,
+	    const QString& oldOwner,
+	    const QString& newOwner
+	);
+	void onPropertyUpdated(const QString& name, const QVariant& value);
+	void onPropertyInvalidated(const QString& name);
+	void onGetAllFinished();
+
+private:
+	void rebind();
+	void setOwner(const QString& owner);
+	void setReady(bool ready);
+	void clearProperties();
+
+	DBusBusType::Enum mBus = DBusBusType::Session;
+	QString mService;
+	QString mPath;
+	QString mInterface;
+	QString mOwner;
+	bool mReady = false;
+	bool componentCompleted = false;
+	qint32 nextCallId = 0;
+
+	DBusObjectPropertyMap* mProperties;
+	// QQmlPropertyMap can't remove keys, so cleared properties are left undefined in the map
+	QSet<QString> setProperties;
+	DBusPropertyGroup propertyGroup;
+	DBusObjectInterface* dbusInterface = nullptr;
+	QDBusServiceWatcher serviceWatcher;
+};
+
+} // namespace qs::dbus
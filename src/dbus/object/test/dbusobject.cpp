@@ -0,0 +1,181 @@
+#include "dbusobject.hpp"
+
+#include <qdbusconnection.h>
+#include <qdbusconnectioninterface.h>
+#include <qdbusmessage.h>
+#include <qobject.h>
+#include <qprocess.h>
+#include <qsignalspy.h>
+#include <qstandardpaths.h>
+#include <qtest.h>
+#include <qtestcase.h>
+#include <qtypes.h>
+#include <qvariant.h>
+
+#include "../dbusobject.hpp"
+
+using qs::dbus::DBusObject;
+
+namespace {
+
+constexpr const char* SERVICE = "org.quickshell.Test";
+constexpr const char* PATH = "/org/quickshell/Test";
+
+QDBusConnection serverConnection() {
+	static auto connection = [] {
+		auto address = qEnvironmentVariable("DBUS_SESSION_BUS_ADDRESS");
+		return QDBusConnection::connectToBus(address, "quickshell-test-server");
+	}();
+
+	return connection;
+}
+
+void bind(DBusObject& object) {
+	object.setService(SERVICE);
+	object.setPath(PATH);
+	object.setInterface(SERVICE);
+	object.componentComplete();
+}
+
+} // namespace
+
+qint32 TestService::Add(qint32 a, qint32 b) { return a + b; } // NOLINT
+
+void TestDBusObject::initTestCase() { // NOLINT
+	auto daemonPath = QStandardPaths::findExecutable("dbus-daemon");
+	if (daemonPath.isEmpty()) QSKIP("dbus-daemon is not installed");
+
+	this->daemon.start(daemonPath, {"--session", "--nofork", "--print-address"});
+	QVERIFY(this->daemon.waitForStarted());
+	QTRY_VERIFY(this->daemon.canReadLine());
+
+	this->address = QString::fromUtf8(this->daemon.readLine()).trimmed();
+
+	// must be set before anything connects to the session bus
+	qputenv("DBUS_SESSION_BUS_ADDRESS", this->address.toUtf8());
+	QVERIFY(QDBusConnection::sessionBus().isConnected());
+	QVERIFY(serverConnection().isConnected());
+}
+
+void TestDBusObject::cleanupTestCase() { // NOLINT
+	QDBusConnection::disconnectFromBus("quickshell-test-server");
+	this->daemon.kill();
+	this->daemon.waitForFinished();
+}
+
+void TestDBusObject::initialProperties() { // NOLINT
+	auto service = TestService();
+	auto connection = serverConnection();
+	QVERIFY(connection.registerObject(PATH, &service, QDBusConnection::ExportAllContents));
+	QVERIFY(connection.registerService(SERVICE));
+
+	auto object = DBusObject();
+	bind(object);
+
+	QTRY_VERIFY(object.ready());
+	QVERIFY(object.available());
+	QCOMPARE(object.owner(), connection.baseService());
+	QCOMPARE(object.properties()->value("Count").toInt(), 1);
+	QCOMPARE(object.properties()->value("Label").toString(), QString("initial"));
+
+	connection.unregisterService(SERVICE);
+	connection.unregisterObject(PATH);
+}
+
+void TestDBusObject::propertiesChanged() { // NOLINT
+	auto service = TestService();
+	auto connection = serverConnection();
+	QVERIFY(connection.registerObject(PATH, &service, QDBusConnection::ExportAllContents));
+	QVERIFY(connection.registerService(SERVICE));
+
+	auto object = DBusObject();
+	bind(object);
+	QTRY_VERIFY(object.ready());
+
+	auto spy = QSignalSpy(&object, &DBusObject::propertyChanged);
+
+	// Count is sent with the signal, Label has to be read again
+	service.count = 5;
+	service.label = "changed";
+
+	auto signal = QDBusMessage::createSignal(
+	    PATH,
+	    "org.freedesktop.DBus.Properties",
+	    "PropertiesChanged"
+	);
+
+	signal << SERVICE << QVariantMap {{"Count", 5}} << QStringList {"Label"};
+	QVERIFY(connection.send(signal));
+
+	QTRY_COMPARE(spy.count(), 2);
+	QCOMPARE(object.properties()->value("Count").toInt(), 5);
+	QCOMPARE(object.properties()->value("Label").toString(), QString("changed"));
+
+	connection.unregisterService(SERVICE);
+	connection.unregisterObject(PATH);
+}
+
+void TestDBusObject::methodCall() { // NOLINT
+	auto service = TestService();
+	auto connection = serverConnection();
+	QVERIFY(connection.registerObject(PATH, &service, QDBusConnection::ExportAllContents));
+	QVERIFY(connection.registerService(SERVICE));
+
+	auto object = DBusObject();
+	bind(object);
+
+	auto finishedSpy = QSignalSpy(&object, &DBusObject::callFinished);
+	auto failedSpy = QSignalSpy(&object, &DBusObject::callFailed);
+
+	auto addId = object.call("Add", {2, 3});
+	auto missingId = object.call("Missing");
+
+	QTRY_COMPARE(finishedSpy.count(), 1);
+	QTRY_COMPARE(failedSpy.count(), 1);
+	QCOMPARE(finishedSpy.at(0).at(0).toInt(), addId);
+	QCOMPARE(finishedSpy.at(0).at(1).value<QVariant>().toInt(), 5);
+	QCOMPARE(failedSpy.at(0).at(0).toInt(), missingId);
+
+	connection.unregisterService(SERVICE);
+	connection.unregisterObject(PATH);
+}
+
+void TestDBusObject::ownerTracking() { // NOLINT
+	auto service = TestService();
+	auto connection = serverConnection();
+	QVERIFY(connection.registerObject(PATH, &service, QDBusConnection::ExportAllContents));
+
+	auto object = DBusObject();
+	bind(object);
+
+	// nothing owns the service yet
+	QTest::qWait(100);
+	QVERIFY(!object.available());
+	QVERIFY(object.properties()->keys().isEmpty());
+
+	QVERIFY(connection.registerService(SERVICE));
+	QTRY_VERIFY(object.ready());
+	QVERIFY(object.available());
+	QCOMPARE(object.properties()->value("Count").toInt(), 1);
+
+	auto changedSpy = QSignalSpy(&object, &DBusObject::propertyChanged);
+
+	connection.unregisterService(SERVICE);
+	QTRY_VERIFY(!object.available());
+	QVERIFY(!object.ready());
+	QVERIFY(!object.properties()->value("Count").isValid());
+	QCOMPARE(changedSpy.count(), 2); // Count and Label
+
+	// properties already cleared are not reported again when the next owner appears
+	QVERIFY(connection.registerService(SERVICE));
+	QTRY_VERIFY(object.ready());
+	QCOMPARE(changedSpy.count(), 4);
+
+	connection.unregisterService(SERVICE);
+	QTRY_VERIFY(!object.available());
+	QCOMPARE(changedSpy.count(), 6);
+
+	connection.unregisterObject(PATH);
+}
+
+QTEST_MAIN(TestDBusObject);
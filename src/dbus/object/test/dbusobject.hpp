@@ -0,0 +1,37 @@
+#pragma once
+
+#include <qobject.h>
+#include <qprocess.h>
+#include <qtmetamacros.h>
+#include <qtypes.h>
+
+// Object exported on the private bus for DBusObject to bind to.
+class TestService: public QObject {
+	Q_OBJECT;
+	Q_CLASSINFO("D-Bus Interface", "org.quickshell.Test");
+	Q_PROPERTY(qint32 Count MEMBER count);
+	Q_PROPERTY(QString Label MEMBER label);
+
+public:
+	qint32 count = 1;
+	QString label = "initial";
+
+public slots:
+	qint32 Add(qint32 a, qint32 b); // NOLINT
+};
+
+class TestDBusObject: public QObject {
+	Q_OBJECT;
+
+private slots:
+	void initTestCase();
+	void cleanupTestCase();
+	void initialProperties();
+	void propertiesChanged();
+	void methodCall();
+	void ownerTracking();
+
+private:
+	QProcess daemon;
+	QString address;
+};
@@ -5,6 +5,7 @@
 #include <qcontainerfwd.h>
 #include <qdbusabstractinterface.h>
 #include <qdbusargument.h>
+#include <qdbusconnection.h>
 #include <qdbuserror.h>
 #include <qdbusextratypes.h>
 #include <qdbusmessage.h>
@@ -12,16 +13,19 @@
 #include <qdbuspendingcall.h>
 #include <qdbuspendingreply.h>
 #include <qdebug.h>
+#include <qhash.h>
+#include <qlist.h>
 #include <qlogging.h>
 #include <qloggingcategory.h>
 #include <qmetatype.h>
 #include <qobject.h>
+#include <qpair.h>
+#include <qpointer.h>
 #include <qpolygon.h>
+#include <qthreadpool.h>
 #include <qtmetamacros.h>
 #include <qvariant.h>
 
-#include "dbus_properties.h"
-
 Q_LOGGING_CATEGORY(logDbusProperties, "quickshell.dbus.properties", QtWarningMsg);
 
 namespace qs::dbus {
@@ -68,6 +72,38 @@ QDBusError demarshallVariant(const QVariant& variant, const QMetaType& type, voi
 	return QDBusError();
 }
 
+QDBusError demarshallVariant(const QVariant& variant, const QMetaType& type, QVariant& decoded) {
+	if (type.id() == QMetaType::QVariant) {
+		decoded = variant;
+		return QDBusError();
+	}
+
+	decoded = QVariant(type);
+	return demarshallVariant(variant, type, decoded.data());
+}
+
+namespace {
+
+bool& threadedDemarshallingFlag() {
+	static bool threaded = qEnvironmentVariableIsSet("QS_DBUS_THREADED_DEMARSHALL"); // NOLINT
+	return threaded;
+}
+
+} // namespace
+
+bool threadedDemarshalling() { return threadedDemarshallingFlag(); }
+void setThreadedDemarshalling(bool threaded) { threadedDemarshallingFlag() = threaded; }
+
+QThreadPool* demarshallPool() {
+	static auto* pool = [] { // NOLINT
+		auto* pool = new QThreadPool();
+		pool->setMaxThreadCount(1);
+		return pool;
+	}();
+
+	return pool;
+}
+
 void asyncReadPropertyInternal(
     const QMetaType& type,
     QDBusAbstractInterface& interface,
@@ -111,19 +147,19 @@ void asyncReadPropertyInternal(
 	QObject::connect(call, &QDBusPendingCallWatcher::finished, &interface, responseCallback);
 }
 
-void AbstractDBusProperty::tryUpdate(const QVariant& variant) {
-	auto error = this->read(variant);
+void DBusPropertyCore::applyDecoded(const QVariant& value, const QDBusError& error) {
 	if (error.isValid()) {
 		qCWarning(logDbusProperties).noquote()
 		    << "Error demarshalling property update for" << this->toString();
 		qCWarning(logDbusProperties) << error;
 	} else {
+		this->apply(value);
 		qCDebug(logDbusProperties).noquote()
 		    << "Updated property" << this->toString() << "to" << this->valueString();
 	}
 }
 
-void AbstractDBusProperty::update() {
+void DBusPropertyCore::requestUpdate() {
 	if (this->group == nullptr) {
 		qFatal(logDbusProperties) << "Tried to update dbus property" << this->name
 		                          << "which is not attached to a group";
@@ -137,60 +173,177 @@ void AbstractDBusProperty::update() {
 
 		qCDebug(logDbusProperties).noquote() << "Updating property" << propStr;
 
-		auto pendingCall =
-		    this->group->propertyInterface->Get(this->group->interface->interface(), this->name);
-
-		auto* call = new QDBusPendingCallWatcher(pendingCall, this);
+		auto pendingCall = this->group->callProperties(
+		    "Get",
+		    {this->group->interface->interface(), this->name}
+		);
 
-		auto responseCallback = [this, propStr](QDBusPendingCallWatcher* call) {
-			const QDBusPendingReply<QDBusVariant> reply = *call;
+		// cells are not QObjects, so the group owns the call
+		auto* group = this->group;
+		auto* call = new QDBusPendingCallWatcher(pendingCall, group);
 
-			if (reply.isError()) {
+		auto responseCallback = [this, group, propStr](QDBusPendingCallWatcher* call) {
+			if (call->isError()) {
 				qCWarning(logDbusProperties).noquote() << "Error updating property" << propStr;
-				qCWarning(logDbusProperties) << reply.error();
+				qCWarning(logDbusProperties) << call->error();
 			} else {
-				this->tryUpdate(reply.value().variant());
+				auto message = call->reply();
+				auto type = this->type;
+
+				using Decoded = QPair<QVariant, QDBusError>;
+
+				auto decode = [message, type]() {
+					auto variant = qdbus_cast<QDBusVariant>(message.arguments().value(0)).variant();
+					auto decoded = Decoded();
+					decoded.second = demarshallVariant(variant, type, decoded.first);
+					return decoded;
+				};
+
+				auto apply = [this](const Decoded& decoded) {
+					this->applyDecoded(decoded.first, decoded.second);
+				};
+
+				demarshallAsync(group, decode, apply);
 			}
 
 			delete call;
 		};
 
-		QObject::connect(call, &QDBusPendingCallWatcher::finished, this, responseCallback);
+		QObject::connect(call, &QDBusPendingCallWatcher::finished, group, responseCallback);
 	}
 }
 
-QString AbstractDBusProperty::toString() const {
+QString DBusPropertyCore::toString() const {
 	const QString group = this->group == nullptr ? "{ NO GROUP }" : this->group->toString();
 	return group + ':' + this->name;
 }
 
-DBusPropertyGroup::DBusPropertyGroup(QVector<AbstractDBusProperty*> properties, QObject* parent)
+DBusPropertiesRouter::DBusPropertiesRouter(QDBusConnection connection, QString service)
+    : connection(std::move(connection))
+    , service(std::move(service)) {
+	// no path, so the bus sends PropertiesChanged for every object of the service
+	auto connected = this->connection.connect(
+	    this->service,
+	    "",
+	    "org.freedesktop.DBus.Properties",
+	    "PropertiesChanged",
+	    this,
+	    SLOT(onPropertiesChanged(QDBusMessage))
+	);
+
+	if (!connected) {
+		qCWarning(logDbusProperties) << "Failed to watch PropertiesChanged for service"
+		                             << this->service << "-" << this->connection.lastError();
+	}
+}
+
+DBusPropertiesRouter::~DBusPropertiesRouter() {
+	this->connection.disconnect(
+	    this->service,
+	    "",
+	    "org.freedesktop.DBus.Properties",
+	    "PropertiesChanged",
+	    this,
+	    SLOT(onPropertiesChanged(QDBusMessage))
+	);
+}
+
+namespace {
+
+QHash<QPair<QString, QString>, DBusPropertiesRouter*>& routers() {
+	static auto routers = QHash<QPair<QString, QString>, DBusPropertiesRouter*>(); // NOLINT
+	return routers;
+}
+
+} // namespace
+
+DBusPropertiesRouter*
+DBusPropertiesRouter::forService(const QDBusConnection& connection, const QString& service) {
+	auto key = qMakePair(connection.name(), service);
+	auto*& router = routers()[key];
+
+	if (router == nullptr) {
+		qCDebug(logDbusProperties) << "Creating PropertiesChanged router for" << service;
+		router = new DBusPropertiesRouter(connection, service);
+	}
+
+	return router;
+}
+
+void DBusPropertiesRouter::addGroup(
+    DBusPropertyGroup* group,
+    const QString& path,
+    const QString& interface
+) {
+	auto key = qMakePair(path, interface);
+	this->groups.insert(key, group);
+	this->groupKeys.insert(group, key);
+}
+
+void DBusPropertiesRouter::removeGroup(DBusPropertyGroup* group) {
+	if (!this->groupKeys.contains(group)) return;
+
+	this->groups.remove(this->groupKeys.take(group), group);
+
+	if (this->groupKeys.isEmpty()) {
+		qCDebug(logDbusProperties) << "Removing PropertiesChanged router for" << this->service;
+		routers().remove(qMakePair(this->connection.name(), this->service));
+
+		// may be removed by a group destroyed while handling a signal
+		this->deleteLater();
+	}
+}
+
+void DBusPropertiesRouter::onPropertiesChanged(const QDBusMessage& message) {
+	auto arguments = message.arguments();
+	if (arguments.length() != 3) return;
+
+	auto interfaceName = arguments.at(0).toString();
+
+	// handlers may destroy other groups, which removes them from the hash
+	auto targets = QList<QPointer<DBusPropertyGroup>>();
+	for (auto* group: this->groups.values(qMakePair(message.path(), interfaceName))) {
+		targets.append(group);
+	}
+
+	for (auto& group: targets) {
+		if (group) group->onPropertiesChanged(message);
+	}
+}
+
+DBusPropertyGroup::DBusPropertyGroup(QVector<DBusPropertyCore*> properties, QObject* parent)
     : QObject(parent)
     , properties(std::move(properties)) {}
 
+DBusPropertyGroup::~DBusPropertyGroup() {
+	if (this->router != nullptr) this->router->removeGroup(this);
+}
+
 void DBusPropertyGroup::setInterface(QDBusAbstractInterface* interface) {
-	if (this->interface != nullptr) {
-		delete this->propertyInterface;
-		this->propertyInterface = nullptr;
+	if (this->router != nullptr) {
+		this->router->removeGroup(this);
+		this->router = nullptr;
 	}
 
+	this->interface = interface;
+
 	if (interface != nullptr) {
-		this->interface = interface;
+		this->router = DBusPropertiesRouter::forService(interface->connection(), interface->service());
+		this->router->addGroup(this, interface->path(), interface->interface());
+	}
+}
 
-		this->propertyInterface = new DBusPropertiesInterface(
-		    interface->service(),
-		    interface->path(),
-		    interface->connection(),
-		    this
-		);
+QDBusPendingCall
+DBusPropertyGroup::callProperties(const QString& method, const QVariantList& args) {
+	auto message = QDBusMessage::createMethodCall(
+	    this->interface->service(),
+	    this->interface->path(),
+	    "org.freedesktop.DBus.Properties",
+	    method
+	);
 
-		QObject::connect(
-		    this->propertyInterface,
-		    &DBusPropertiesInterface::PropertiesChanged,
-		    this,
-		    &DBusPropertyGroup::onPropertiesChanged
-		);
-	}
+	message.setArguments(args);
+	return this->interface->connection().asyncCall(message);
 }
 
 void DBusPropertyGroup::attachProperty(AbstractDBusProperty* property) {
@@ -198,6 +351,24 @@ void DBusPropertyGroup::attachProperty(AbstractDBusProperty* property) {
 	property->group = this;
 }
 
+quint64 DBusPropertyGroup::attachCell(DBusPropertyCore* cell) {
+	if (this->nextCellBit == 0) {
+		qFatal(logDbusProperties) << "Tried to attach more than 64 property cells to a group";
+	}
+
+	this->properties.append(cell);
+	cell->group = this;
+
+	auto bit = this->nextCellBit;
+	this->nextCellBit <<= 1;
+	return bit;
+}
+
+void DBusPropertyGroup::cellChanged(quint64 bit) {
+	if (this->batching) this->changedCells |= bit;
+	else emit this->changed(bit);
+}
+
 void DBusPropertyGroup::updateAllDirect() {
 	qCDebug(logDbusProperties).noquote()
 	    << "Updating all properties of" << this->toString() << "via individual queries";
@@ -207,7 +378,7 @@ void DBusPropertyGroup::updateAllDirect() {
 	}
 
 	for (auto* property: this->properties) {
-		property->update();
+		property->requestUpdate();
 	}
 }
 
@@ -219,43 +390,103 @@ void DBusPropertyGroup::updateAllViaGetAll() {
 		qFatal() << "Attempted to update properties of disconnected property group";
 	}
 
-	auto pendingCall = this->propertyInterface->GetAll(this->interface->interface());
+	auto pendingCall = this->callProperties("GetAll", {this->interface->interface()});
 	auto* call = new QDBusPendingCallWatcher(pendingCall, this);
 
 	auto responseCallback = [this](QDBusPendingCallWatcher* call) {
-		const QDBusPendingReply<QVariantMap> reply = *call;
-
-		if (reply.isError()) {
+		if (call->isError()) {
 			qCWarning(logDbusProperties).noquote()
 			    << "Error updating properties of" << this->toString() << "via GetAll";
-			qCWarning(logDbusProperties) << reply.error();
+			qCWarning(logDbusProperties) << call->error();
+			emit this->getAllFinished();
 		} else {
 			qCDebug(logDbusProperties).noquote()
 			    << "Received GetAll property set for" << this->toString();
-			this->updatePropertySet(reply.value());
+
+			auto message = call->reply();
+			auto types = this->propertyTypes();
+
+			auto decode = [message, types]() {
+				auto properties = qdbus_cast<QVariantMap>(message.arguments().value(0));
+				return DBusPropertyGroup::decodePropertySet(types, properties);
+			};
+
+			auto apply = [this](const QList<DecodedProperty>& properties) {
+				this->applyPropertySet(properties);
+				emit this->getAllFinished();
+			};
+
+			demarshallAsync(this, decode, apply);
 		}
 
 		delete call;
-		emit this->getAllFinished();
 	};
 
 	QObject::connect(call, &QDBusPendingCallWatcher::finished, this, responseCallback);
 }
 
-void DBusPropertyGroup::updatePropertySet(const QVariantMap& properties) {
+DBusPropertyGroup::PropertyTypes DBusPropertyGroup::propertyTypes() const {
+	auto types = PropertyTypes();
+	for (auto* property: this->properties) {
+		types.insert(property->name, property->type);
+	}
+
+	return types;
+}
+
+DBusPropertyCore* DBusPropertyGroup::property(const QString& name) const {
+	auto prop = std::find_if(
+	    this->properties.begin(),
+	    this->properties.end(),
+	    [&name](DBusPropertyCore* prop) { return prop->name == name; }
+	);
+
+	return prop == this->properties.end() ? nullptr : *prop;
+}
+
+QList<DBusPropertyGroup::DecodedProperty>
+DBusPropertyGroup::decodePropertySet(const PropertyTypes& types, const QVariantMap& properties) {
+	auto decoded = QList<DecodedProperty>();
+	decoded.reserve(properties.size());
+
 	for (const auto [name, value]: properties.asKeyValueRange()) {
-		auto prop = std::find_if(
-		    this->properties.begin(),
-		    this->properties.end(),
-		    [&name](AbstractDBusProperty* prop) { return prop->name == name; }
-		);
+		auto property = DecodedProperty();
+		property.name = name;
+		auto type = types.constFind(name);
+
+		if (type == types.constEnd()) {
+			property.value = value;
+		} else {
+			property.tracked = true;
+			property.error = demarshallVariant(value, *type, property.value);
+		}
+
+		decoded.append(std::move(property));
+	}
 
-		if (prop == this->properties.end()) {
-			qCDebug(logDbusProperties) << "Ignoring untracked property update" << name << "for" << this;
+	return decoded;
+}
+
+void DBusPropertyGroup::applyPropertySet(const QList<DecodedProperty>& properties) {
+	this->batching = true;
+
+	for (const auto& decoded: properties) {
+		auto* property = decoded.tracked ? this->property(decoded.name) : nullptr;
+
+		if (property == nullptr) {
+			qCDebug(logDbusProperties) << "Received untracked property update" << decoded.name << "for"
+			                           << this;
+			emit this->untrackedPropertyUpdated(decoded.name, decoded.value);
 		} else {
-			(*prop)->tryUpdate(value);
+			property->applyDecoded(decoded.value, decoded.error);
 		}
 	}
+
+	this->batching = false;
+
+	if (this->changedCells != 0) {
+		emit this->changed(std::exchange(this->changedCells, 0));
+	}
 }
 
 QString DBusPropertyGroup::toString() const {
@@ -267,31 +498,38 @@ QString DBusPropertyGroup::toString() const {
 	}
 }
 
-void DBusPropertyGroup::onPropertiesChanged(
-    const QString& interfaceName,
-    const QVariantMap& changedProperties,
-    const QStringList& invalidatedProperties
-) {
-	if (interfaceName != this->interface->interface()) return;
+void DBusPropertyGroup::onPropertiesChanged(const QDBusMessage& message) {
 	qCDebug(logDbusProperties).noquote()
 	    << "Received property change set and invalidations for" << this->toString();
 
-	for (const auto& name: invalidatedProperties) {
-		auto prop = std::find_if(
-		    this->properties.begin(),
-		    this->properties.end(),
-		    [&name](AbstractDBusProperty* prop) { return prop->name == name; }
-		);
+	using Decoded = QPair<QList<DecodedProperty>, QStringList>;
 
-		if (prop == this->properties.end()) {
-			qCDebug(logDbusProperties) << "Ignoring untracked property invalidation" << name << "for"
-			                           << this;
-		} else {
-			(*prop)->update();
+	auto types = this->propertyTypes();
+
+	auto decode = [message, types]() {
+		auto arguments = message.arguments();
+		auto changed = qdbus_cast<QVariantMap>(arguments.at(1));
+		auto invalidated = qdbus_cast<QStringList>(arguments.at(2));
+		return Decoded(DBusPropertyGroup::decodePropertySet(types, changed), invalidated);
+	};
+
+	auto apply = [this](const Decoded& decoded) {
+		for (const auto& name: decoded.second) {
+			auto* property = this->property(name);
+
+			if (property == nullptr) {
+				qCDebug(logDbusProperties) << "Received untracked property invalidation" << name << "for"
+				                           << this;
+				emit this->untrackedPropertyInvalidated(name);
+			} else {
+				property->requestUpdate();
+			}
 		}
-	}
 
-	this->updatePropertySet(changedProperties);
+		this->applyPropertySet(decoded.first);
+	};
+
+	demarshallAsync(this, decode, apply);
 }
 
 } // namespace qs::dbus
@@ -1,30 +1,74 @@
 #pragma once
 
 #include <functional>
+#include <type_traits>
 #include <utility>
 
 #include <qcontainerfwd.h>
+#include <qcoreapplication.h>
 #include <qdbusabstractinterface.h>
+#include <qdbusconnection.h>
 #include <qdbuserror.h>
 #include <qdbusextratypes.h>
+#include <qdbusmessage.h>
 #include <qdbuspendingcall.h>
 #include <qdbusreply.h>
 #include <qdbusservicewatcher.h>
 #include <qdebug.h>
+#include <qhash.h>
 #include <qlogging.h>
 #include <qloggingcategory.h>
+#include <qnamespace.h>
 #include <qobject.h>
+#include <qpair.h>
+#include <qpointer.h>
+#include <qthreadpool.h>
 #include <qtmetamacros.h>
+#include <qtypes.h>
 #include <qvariant.h>
 
-class DBusPropertiesInterface;
-
 Q_DECLARE_LOGGING_CATEGORY(logDbusProperties);
 
 namespace qs::dbus {
 
 QDBusError demarshallVariant(const QVariant& variant, const QMetaType& type, void* slot);
 
+// Demarshalls into a QVariant holding `type`, or the variant itself if `type` is QVariant.
+QDBusError demarshallVariant(const QVariant& variant, const QMetaType& type, QVariant& decoded);
+
+// If large replies and signals are decoded on a worker thread instead of the main thread.
+// Off unless QS_DBUS_THREADED_DEMARSHALL is set.
+[[nodiscard]] bool threadedDemarshalling();
+void setThreadedDemarshalling(bool threaded);
+
+// Single threaded, so results are applied in the order their messages arrived.
+QThreadPool* demarshallPool();
+
+// Calls `decode`, on the demarshalling thread if threadedDemarshalling is set, then calls `apply`
+// with its result on the main thread unless `context` has been destroyed.
+// `decode` must not touch objects owned by the main thread.
+template <typename Decode, typename Apply>
+void demarshallAsync(QObject* context, Decode decode, Apply apply) {
+	if (!threadedDemarshalling()) {
+		apply(decode());
+		return;
+	}
+
+	auto guard = QPointer<QObject>(context);
+
+	demarshallPool()->start([guard, decode, apply]() {
+		auto result = decode();
+
+		QMetaObject::invokeMethod(
+		    QCoreApplication::instance(),
+		    [guard, apply, result = std::move(result)]() {
+			    if (guard) apply(result);
+		    },
+		    Qt::QueuedConnection
+		);
+	});
+}
+
 template <typename T>
 class DBusResult {
 public:
@@ -75,36 +119,91 @@ void asyncReadProperty(
 
 class DBusPropertyGroup;
 
-class AbstractDBusProperty: public QObject {
-	Q_OBJECT;
-
+// Name, type and decoding shared by DBusProperty and DBusPropertyCell.
+class DBusPropertyCore {
 public:
-	explicit AbstractDBusProperty(QString name, const QMetaType& type, QObject* parent = nullptr)
-	    : QObject(parent)
-	    , name(std::move(name))
+	explicit DBusPropertyCore(QString name, const QMetaType& type)
+	    : name(std::move(name))
 	    , type(type) {}
 
+	virtual ~DBusPropertyCore() = default;
+	Q_DISABLE_COPY_MOVE(DBusPropertyCore);
+
 	[[nodiscard]] QString toString() const;
 	[[nodiscard]] virtual QString valueString() = 0;
 
+protected:
+	// Reads the property again with Get.
+	void requestUpdate();
+
+	// `value` holds the property's type, or is the value itself for QVariant properties.
+	virtual void apply(QVariant value) = 0;
+
+	template <typename T>
+	static T takeDecoded(QVariant& value) {
+		if constexpr (std::is_same_v<T, QVariant>) {
+			return std::move(value);
+		} else {
+			return std::move(*static_cast<T*>(value.data()));
+		}
+	}
+
+	DBusPropertyGroup* group = nullptr;
+
+private:
+	void applyDecoded(const QVariant& value, const QDBusError& error);
+
+	QString name;
+	QMetaType type;
+
+	friend class DBusPropertyGroup;
+};
+
+class AbstractDBusProperty
+    : public QObject
+    , public DBusPropertyCore {
+	Q_OBJECT;
+
+public:
+	explicit AbstractDBusProperty(QString name, const QMetaType& type, QObject* parent = nullptr)
+	    : QObject(parent)
+	    , DBusPropertyCore(std::move(name), type) {}
+
 public slots:
-	void update();
+	void update() { this->requestUpdate(); }
 
 signals:
 	void changed();
+};
 
-protected:
-	virtual QDBusError read(const QVariant& variant) = 0;
+// Receives PropertiesChanged for every object of a service with a single match rule,
+// and hands each signal to the groups watching its path and interface.
+class DBusPropertiesRouter: public QObject {
+	Q_OBJECT;
 
-private:
-	void tryUpdate(const QVariant& variant);
+public:
+	~DBusPropertiesRouter() override;
+	Q_DISABLE_COPY_MOVE(DBusPropertiesRouter);
 
-	DBusPropertyGroup* group = nullptr;
+	// shared by all groups of the service on the connection, until the last one is removed
+	static DBusPropertiesRouter*
+	forService(const QDBusConnection& connection, const QString& service);
 
-	QString name;
-	QMetaType type;
+	void addGroup(DBusPropertyGroup* group, const QString& path, const QString& interface);
+	void removeGroup(DBusPropertyGroup* group);
 
-	friend class DBusPropertyGroup;
+private slots:
+	void onPropertiesChanged(const QDBusMessage& message);
+
+private:
+	using Key = QPair<QString, QString>;
+
+	explicit DBusPropertiesRouter(QDBusConnection connection, QString service);
+
+	QDBusConnection connection;
+	QString service;
+	QMultiHash<Key, DBusPropertyGroup*> groups;
+	QHash<DBusPropertyGroup*, Key> groupKeys;
 };
 
 class DBusPropertyGroup: public QObject {
@@ -112,34 +211,65 @@ class DBusPropertyGroup: public QObject {
 
 public:
 	explicit DBusPropertyGroup(
-	    QVector<AbstractDBusProperty*> properties = QVector<AbstractDBusProperty*>(),
+	    QVector<DBusPropertyCore*> properties = QVector<DBusPropertyCore*>(),
 	    QObject* parent = nullptr
 	);
+	~DBusPropertyGroup() override;
+	Q_DISABLE_COPY_MOVE(DBusPropertyGroup);
 
 	void setInterface(QDBusAbstractInterface* interface);
 	void attachProperty(AbstractDBusProperty* property);
+	// Returns the bit set in `changed` when the cell changes.
+	quint64 attachCell(DBusPropertyCore* cell);
 	void updateAllDirect();
 	void updateAllViaGetAll();
 	[[nodiscard]] QString toString() const;
 
 signals:
 	void getAllFinished();
-
-private slots:
-	void onPropertiesChanged(
-	    const QString& interfaceName,
-	    const QVariantMap& changedProperties,
-	    const QStringList& invalidatedProperties
-	);
+	// Sent with the bits of all cells changed by an update, once per update.
+	void changed(quint64 cells);
+	// sent for updates and invalidations of properties that are not attached to the group
+	void untrackedPropertyUpdated(const QString& name, const QVariant& value);
+	void untrackedPropertyInvalidated(const QString& name);
 
 private:
-	void updatePropertySet(const QVariantMap& properties);
+	struct DecodedProperty {
+		QString name;
+		// the raw value for untracked properties
+		QVariant value;
+		QDBusError error;
+		bool tracked = false;
+	};
 
-	DBusPropertiesInterface* propertyInterface = nullptr;
-	QDBusAbstractInterface* interface = nullptr;
-	QVector<AbstractDBusProperty*> properties;
+	using PropertyTypes = QHash<QString, QMetaType>;
 
-	friend class AbstractDBusProperty;
+	void onPropertiesChanged(const QDBusMessage& message);
+
+	// copied so decoding never touches the properties themselves
+	[[nodiscard]] PropertyTypes propertyTypes() const;
+	[[nodiscard]] DBusPropertyCore* property(const QString& name) const;
+
+	static QList<DecodedProperty>
+	decodePropertySet(const PropertyTypes& types, const QVariantMap& properties);
+
+	void applyPropertySet(const QList<DecodedProperty>& properties);
+	[[nodiscard]] QDBusPendingCall callProperties(const QString& method, const QVariantList& args);
+
+	void cellChanged(quint64 bit);
+
+	DBusPropertiesRouter* router = nullptr;
+	QDBusAbstractInterface* interface = nullptr;
+	QVector<DBusPropertyCore*> properties;
+	quint64 nextCellBit = 1;
+	// cell changes are collected while a property set is applied
+	bool batching = false;
+	quint64 changedCells = 0;
+
+	friend class DBusPropertyCore;
+	friend class DBusPropertiesRouter;
+	template <typename T>
+	friend class DBusPropertyCell;
 };
 
 template <typename T>
@@ -173,20 +303,47 @@ public:
 	}
 
 protected:
-	QDBusError read(const QVariant& variant) override {
-		auto result = demarshallVariant<T>(variant);
+	void apply(QVariant value) override { this->set(takeDecoded<T>(value)); }
 
-		if (result.isValid()) {
-			this->set(std::move(result.value));
-		}
+private:
+	T value;
+
+	friend class DBusPropertyGroup;
+};
+
+// A property stored by value in its owner, without the QObject and signal of a DBusProperty.
+// Changes are reported by the group's `changed` signal, with the cell's `bit()` set.
+template <typename T>
+class DBusPropertyCell: public DBusPropertyCore {
+public:
+	explicit DBusPropertyCell(DBusPropertyGroup& group, QString name, T value = T())
+	    : DBusPropertyCore(std::move(name), QMetaType::fromType<T>())
+	    , value(std::move(value)) {
+		this->mBit = group.attachCell(this);
+	}
+
+	[[nodiscard]] QString valueString() override {
+		QString str;
+		QDebug(&str) << this->value;
+		return str;
+	}
+
+	[[nodiscard]] const T& get() const { return this->value; }
+	[[nodiscard]] quint64 bit() const { return this->mBit; }
 
-		return result.error;
+	void set(T value) {
+		this->value = std::move(value);
+		this->group->cellChanged(this->mBit);
 	}
 
+	void update() { this->requestUpdate(); }
+
+protected:
+	void apply(QVariant value) override { this->set(takeDecoded<T>(value)); }
+
 private:
 	T value;
-
-	friend class DBusPropertyGroup;
+	quint64 mBit = 0;
 };
 
 } // namespace qs::dbus
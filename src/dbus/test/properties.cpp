@@ -0,0 +1,267 @@
+#include "properties.hpp"
+
+#include <memory>
+
+#include <qdbusabstractinterface.h>
+#include <qdbusconnection.h>
+#include <qdbusextratypes.h>
+#include <qdbusmessage.h>
+#include <qdbusvirtualobject.h>
+#include <qobject.h>
+#include <qprocess.h>
+#include <qsignalspy.h>
+#include <qstandardpaths.h>
+#include <qthread.h>
+#include <qtest.h>
+#include <qtestcase.h>
+#include <qtypes.h>
+#include <qvariant.h>
+
+#include "../properties.hpp"
+
+using namespace qs::dbus;
+
+namespace {
+
+constexpr const char* INTERFACE = "org.quickshell.Test";
+constexpr const char* OTHER_INTERFACE = "org.quickshell.Other";
+
+QDBusConnection serverConnection() {
+	static auto connection = [] {
+		auto address = qEnvironmentVariable("DBUS_SESSION_BUS_ADDRESS");
+		return QDBusConnection::connectToBus(address, "quickshell-test-server");
+	}();
+
+	return connection;
+}
+
+class TestInterface: public QDBusAbstractInterface {
+public:
+	explicit TestInterface(const QString& path, const char* interface)
+	    : QDBusAbstractInterface(
+	          serverConnection().baseService(),
+	          path,
+	          interface,
+	          QDBusConnection::sessionBus(),
+	          nullptr
+	      ) {}
+};
+
+// A Count property watched on one object and interface of the test server.
+class Watched {
+public:
+	explicit Watched(const QString& path, const char* interface = INTERFACE)
+	    : interface(path, interface) {
+		this->group.setInterface(&this->interface);
+
+		// the match rule is added asynchronously, a round trip makes sure the bus has it
+		auto ping = QDBusMessage::createMethodCall(
+		    "org.freedesktop.DBus",
+		    "/org/freedesktop/DBus",
+		    "org.freedesktop.DBus",
+		    "GetId"
+		);
+
+		QDBusConnection::sessionBus().call(ping);
+	}
+
+	TestInterface interface;
+	DBusPropertyGroup group;
+	DBusProperty<qint32> count {this->group, "Count"};
+};
+
+// The same properties stored as cells.
+class WatchedCells {
+public:
+	explicit WatchedCells(const QString& path): interface(path, INTERFACE) {
+		this->group.setInterface(&this->interface);
+		QDBusConnection::sessionBus().call(QDBusMessage::createMethodCall(
+		    "org.freedesktop.DBus",
+		    "/org/freedesktop/DBus",
+		    "org.freedesktop.DBus",
+		    "GetId"
+		));
+	}
+
+	TestInterface interface;
+	DBusPropertyGroup group;
+	DBusPropertyCell<qint32> count {this->group, "Count"};
+	DBusPropertyCell<QString> label {this->group, "Label"};
+};
+
+// Answers Get for a Count property on the test server.
+class CountObject: public QDBusVirtualObject {
+public:
+	[[nodiscard]] QString introspect(const QString& /*unused*/) const override { return ""; }
+
+	bool handleMessage(const QDBusMessage& message, const QDBusConnection& connection) override {
+		if (message.member() != "Get") return false;
+
+		auto reply = message.createReply(QVariant::fromValue(QDBusVariant(this->count)));
+		connection.send(reply);
+		return true;
+	}
+
+	qint32 count = 0;
+};
+
+void sendCount(const QString& path, const char* interface, qint32 count) {
+	auto signal =
+	    QDBusMessage::createSignal(path, "org.freedesktop.DBus.Properties", "PropertiesChanged");
+
+	signal << QString(interface) << QVariantMap {{"Count", count}} << QStringList();
+	serverConnection().send(signal);
+}
+
+} // namespace
+
+void TestProperties::initTestCase() { // NOLINT
+	auto daemonPath = QStandardPaths::findExecutable("dbus-daemon");
+	if (daemonPath.isEmpty()) QSKIP("dbus-daemon is not installed");
+
+	this->daemon.start(daemonPath, {"--session", "--nofork", "--print-address"});
+	QVERIFY(this->daemon.waitForStarted());
+	QTRY_VERIFY(this->daemon.canReadLine());
+
+	auto address = QString::fromUtf8(this->daemon.readLine()).trimmed();
+
+	// must be set before anything connects to the session bus
+	qputenv("DBUS_SESSION_BUS_ADDRESS", address.toUtf8());
+	QVERIFY(QDBusConnection::sessionBus().isConnected());
+	QVERIFY(serverConnection().isConnected());
+}
+
+void TestProperties::cleanupTestCase() { // NOLINT
+	QDBusConnection::disconnectFromBus("quickshell-test-server");
+	this->daemon.kill();
+	this->daemon.waitForFinished();
+}
+
+void TestProperties::routing() { // NOLINT
+	auto first = Watched("/first");
+	auto second = Watched("/second");
+	auto other = Watched("/first", OTHER_INTERFACE);
+
+	// only the group of the signal's path and interface is updated
+	sendCount("/first", INTERFACE, 5);
+	QTRY_COMPARE(first.count.get(), 5);
+	QCOMPARE(second.count.get(), 0);
+	QCOMPARE(other.count.get(), 0);
+
+	sendCount("/second", INTERFACE, 6);
+	sendCount("/first", OTHER_INTERFACE, 7);
+	QTRY_COMPARE(other.count.get(), 7);
+	QCOMPARE(second.count.get(), 6);
+	QCOMPARE(first.count.get(), 5);
+
+	// signals for objects nobody watches are dropped
+	sendCount("/third", INTERFACE, 8);
+	sendCount("/first", INTERFACE, 9);
+	QTRY_COMPARE(first.count.get(), 9);
+	QCOMPARE(second.count.get(), 6);
+}
+
+void TestProperties::groupRemoval() { // NOLINT
+	auto first = Watched("/first");
+	auto second = std::make_unique<Watched>("/first");
+
+	// a group destroyed by another group's update is skipped
+	QObject::connect(&first.count, &AbstractDBusProperty::changed, &first.group, [&] {
+		second.reset();
+	});
+
+	sendCount("/first", INTERFACE, 5);
+	QTRY_COMPARE(first.count.get(), 5);
+	QVERIFY(second == nullptr);
+
+	// a detached group no longer receives updates
+	first.group.setInterface(nullptr);
+	auto third = Watched("/first");
+
+	sendCount("/first", INTERFACE, 6);
+	QTRY_COMPARE(third.count.get(), 6);
+	QCOMPARE(first.count.get(), 5);
+}
+
+void TestProperties::threadedDemarshalling() { // NOLINT
+	setThreadedDemarshalling(true);
+
+	QThread* decodeThread = nullptr;
+	auto result = 0;
+	auto context = QObject();
+
+	demarshallAsync(
+	    &context,
+	    [&decodeThread]() {
+		    decodeThread = QThread::currentThread();
+		    return 5;
+	    },
+	    [&result](qint32 value) { result = value; }
+	);
+
+	// applied on the main thread once decoded
+	QCOMPARE(result, 0);
+	QTRY_COMPARE(result, 5);
+	QVERIFY(decodeThread != QThread::currentThread());
+
+	// results for destroyed objects are dropped
+	auto* destroyed = new QObject();
+	demarshallAsync(destroyed, []() { return 6; }, [&result](qint32 value) { result = value; });
+	delete destroyed;
+
+	auto watched = Watched("/first");
+	sendCount("/first", INTERFACE, 7);
+	QTRY_COMPARE(watched.count.get(), 7);
+	QCOMPARE(result, 5);
+
+	setThreadedDemarshalling(false);
+}
+
+void TestProperties::cells() { // NOLINT
+	auto watched = WatchedCells("/first");
+	auto spy = QSignalSpy(&watched.group, &DBusPropertyGroup::changed);
+
+	QVERIFY(watched.count.bit() != watched.label.bit());
+
+	// one notification for the whole change set
+	auto signal =
+	    QDBusMessage::createSignal("/first", "org.freedesktop.DBus.Properties", "PropertiesChanged");
+
+	signal << QString(INTERFACE) << QVariantMap {{"Count", 5}, {"Label", "changed"}}
+	       << QStringList();
+	serverConnection().send(signal);
+
+	QTRY_COMPARE(spy.count(), 1);
+	QCOMPARE(spy.at(0).at(0).toULongLong(), watched.count.bit() | watched.label.bit());
+	QCOMPARE(watched.count.get(), 5);
+	QCOMPARE(watched.label.get(), QString("changed"));
+
+	// direct sets are reported immediately
+	watched.label.set("set");
+	QCOMPARE(spy.count(), 2);
+	QCOMPARE(spy.at(1).at(0).toULongLong(), watched.label.bit());
+}
+
+void TestProperties::cellInvalidation() { // NOLINT
+	auto object = CountObject();
+	object.count = 42;
+	QVERIFY(serverConnection().registerVirtualObject("/cells", &object));
+
+	auto watched = WatchedCells("/cells");
+	auto spy = QSignalSpy(&watched.group, &DBusPropertyGroup::changed);
+
+	// invalidated cells are read again with Get
+	auto signal =
+	    QDBusMessage::createSignal("/cells", "org.freedesktop.DBus.Properties", "PropertiesChanged");
+
+	signal << QString(INTERFACE) << QVariantMap() << QStringList {"Count"};
+	serverConnection().send(signal);
+
+	QTRY_COMPARE(watched.count.get(), 42);
+	QCOMPARE(spy.count(), 1);
+	QCOMPARE(spy.at(0).at(0).toULongLong(), watched.count.bit());
+
+	serverConnection().unregisterObject("/cells");
+}
+
+QTEST_MAIN(TestProperties);
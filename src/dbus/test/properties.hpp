@@ -0,0 +1,21 @@
+#pragma once
+
+#include <qobject.h>
+#include <qprocess.h>
+#include <qtmetamacros.h>
+
+class TestProperties: public QObject {
+	Q_OBJECT;
+
+private slots:
+	void initTestCase();
+	void cleanupTestCase();
+	void routing();
+	void groupRemoval();
+	void threadedDemarshalling();
+	void cells();
+	void cellInvalidation();
+
+private:
+	QProcess daemon;
+};
@@ -0,0 +1,638 @@
+#include "connection.hpp"
+#include <utility>
+
+#include <qbytearray.h>
+#include <qdir.h>
+#include <qjsonarray.h>
+#include <qjsondocument.h>
+#include <qjsonobject.h>
+#include <qjsonvalue.h>
+#include <qlogging.h>
+#include <qloggingcategory.h>
+#include <qobject.h>
+#include <qprocessenvironment.h>
+#include <qtypes.h>
+
+#include "ipc.hpp"
+
+namespace qs::hyprland::ipc {
+
+namespace {
+
+// addresses in events are missing the 0x prefix used everywhere else
+QString clientAddress(const QByteArray& address) { return "0x" + QString::fromUtf8(address); }
+
+qint32 toInt(const QByteArray& field, qint32 fallback) {
+	auto ok = false;
+	auto value = field.toInt(&ok);
+	return ok ? value : fallback;
+}
+
+} // namespace
+
+void HyprlandWorkspace::activate() {
+	auto* ipc = HyprlandIpc::instance();
+	if (ipc == nullptr) return;
+
+	// named and special workspaces have negative ids, which would be read as relative offsets
+	if (this->mId <= 0) ipc->dispatch("workspace name:" + this->mName);
+	else ipc->dispatch(QString("workspace %1").arg(this->mId));
+}
+
+void HyprlandWorkspace::setName(const QString& name) {
+	if (name == this->mName) return;
+	this->mName = name;
+	emit this->nameChanged();
+}
+
+void HyprlandWorkspace::setMonitor(const QString& monitor) {
+	if (monitor == this->mMonitor) return;
+	this->mMonitor = monitor;
+	emit this->monitorChanged();
+}
+
+void HyprlandWorkspace::setWindows(qint32 windows) {
+	if (windows == this->mWindows) return;
+	this->mWindows = windows;
+	emit this->windowsChanged();
+}
+
+void HyprlandWorkspace::setActive(bool active) {
+	if (active == this->mActive) return;
+	this->mActive = active;
+	emit this->activeChanged();
+}
+
+void HyprlandWorkspace::setFocused(bool focused) {
+	if (focused == this->mFocused) return;
+	this->mFocused = focused;
+	emit this->focusedChanged();
+}
+
+void HyprlandWorkspace::updateFromReply(const QJsonObject& workspace) {
+	this->setName(workspace.value("name").toString());
+	this->setMonitor(workspace.value("monitor").toString());
+	this->setWindows(workspace.value("windows").toInt());
+}
+
+void HyprlandMonitor::setActiveWorkspace(const QString& workspace) {
+	if (workspace == this->mActiveWorkspace) return;
+	this->mActiveWorkspace = workspace;
+	emit this->activeWorkspaceChanged();
+}
+
+void HyprlandMonitor::setFocused(bool focused) {
+	if (focused == this->mFocused) return;
+	this->mFocused = focused;
+	emit this->focusedChanged();
+}
+
+void HyprlandMonitor::updateFromReply(const QJsonObject& monitor) {
+	auto description = monitor.value("description").toString();
+	if (description != this->mDescription) {
+		this->mDescription = description;
+		emit this->descriptionChanged();
+	}
+
+	this->setActiveWorkspace(monitor.value("activeWorkspace").toObject().value("name").toString());
+	this->setFocused(monitor.value("focused").toBool());
+
+	auto x = monitor.value("x").toInt();
+	auto y = monitor.value("y").toInt();
+	auto width = monitor.value("width").toInt();
+	auto height = monitor.value("height").toInt();
+
+	if (x != this->mX || y != this->mY || width != this->mWidth || height != this->mHeight) {
+		this->mX = x;
+		this->mY = y;
+		this->mWidth = width;
+		this->mHeight = height;
+		emit this->geometryChanged();
+	}
+
+	auto scale = monitor.value("scale").toDouble(1);
+	if (scale != this->mScale) {
+		this->mScale = scale;
+		emit this->scaleChanged();
+	}
+}
+
+void HyprlandClient::focus() {
+	auto* ipc = HyprlandIpc::instance();
+	if (ipc == nullptr) return;
+
+	ipc->dispatch(QString("focuswindow address:%1").arg(this->mAddress));
+}
+
+void HyprlandClient::setTitle(const QString& title) {
+	if (title == this->mTitle) return;
+	this->mTitle = title;
+	emit this->titleChanged();
+}
+
+void HyprlandClient::setAppClass(const QString& appClass) {
+	if (appClass == this->mAppClass) return;
+	this->mAppClass = appClass;
+	emit this->appClassChanged();
+}
+
+void HyprlandClient::setWorkspace(const QString& workspace) {
+	if (workspace == this->mWorkspace) return;
+	this->mWorkspace = workspace;
+	emit this->workspaceChanged();
+}
+
+void HyprlandClient::setFocused(bool focused) {
+	if (focused == this->mFocused) return;
+	this->mFocused = focused;
+	emit this->focusedChanged();
+}
+
+void HyprlandClient::setUrgent(bool urgent) {
+	if (urgent == this->mUrgent) return;
+	this->mUrgent = urgent;
+	emit this->urgentChanged();
+}
+
+void HyprlandClient::setFullscreen(bool fullscreen) {
+	if (fullscreen == this->mFullscreen) return;
+	this->mFullscreen = fullscreen;
+	emit this->fullscreenChanged();
+}
+
+void HyprlandClient::updateFromReply(const QJsonObject& client) {
+	this->setTitle(client.value("title").toString());
+	this->setAppClass(client.value("class").toString());
+	this->setWorkspace(client.value("workspace").toObject().value("name").toString());
+	this->setFocused(client.value("focusHistoryID").toInt(-1) == 0);
+
+	// a bool in older versions, the fullscreen mode in newer ones
+	auto fullscreen = client.value("fullscreen");
+	this->setFullscreen(fullscreen.isBool() ? fullscreen.toBool() : fullscreen.toInt() != 0);
+}
+
+HyprlandIpc::HyprlandIpc(QString requestPath, const QString& eventPath, QObject* parent)
+    : QObject(parent)
+    , requestPath(std::move(requestPath)) {
+	// clang-format off
+	QObject::connect(&this->eventSocket, &Socket::connectionStateChanged, this, &HyprlandIpc::onEventSocketStateChanged);
+	QObject::connect(&this->eventParser, &HyprlandEventParser::event, this, &HyprlandIpc::onEvent);
+	// clang-format on
+
+	this->eventSocket.setReader(&this->eventParser);
+	this->eventSocket.setPath(eventPath);
+	this->eventSocket.setAutoReconnect(true);
+	this->eventSocket.setConnected(true);
+}
+
+HyprlandIpc* HyprlandIpc::instance() {
+	static HyprlandIpc* instance = nullptr; // NOLINT
+	static bool initialized = false;        // NOLINT
+
+	if (!initialized) {
+		initialized = true;
+
+		auto env = QProcessEnvironment::systemEnvironment();
+		auto signature = env.value("HYPRLAND_INSTANCE_SIGNATURE");
+
+		if (signature.isEmpty()) {
+			qCWarning(logHyprlandIpc) << "$HYPRLAND_INSTANCE_SIGNATURE is not set."
+			                          << "Hyprland integration will not work.";
+		} else {
+			// sockets moved to the runtime dir in newer versions
+			auto dir = QDir(env.value("XDG_RUNTIME_DIR") + "/hypr/" + signature);
+			if (!dir.exists()) dir = QDir("/tmp/hypr/" + signature);
+
+			instance = new HyprlandIpc(dir.filePath(".socket.sock"), dir.filePath(".socket2.sock"));
+		}
+	}
+
+	return instance;
+}
+
+QString HyprlandIpc::eventSocketPath() const { return this->eventSocket.path(); }
+bool HyprlandIpc::isConnected() const { return this->eventSocket.isConnected(); }
+
+HyprlandWorkspace* HyprlandIpc::focusedWorkspace() const { return this->mFocusedWorkspace; }
+HyprlandMonitor* HyprlandIpc::focusedMonitor() const { return this->mFocusedMonitor; }
+
+void HyprlandIpc::dispatch(const QString& request) {
+	auto* req = HyprlandRequest::send(this->requestPath, "dispatch " + request.toUtf8(), this);
+
+	auto onFinished = [request](bool /*success*/, const QByteArray& reply) {
+		if (reply != "ok") qCWarning(logHyprlandIpc) << "Dispatch" << request << "failed:" << reply;
+	};
+
+	QObject::connect(req, &HyprlandRequest::finished, this, onFinished);
+}
+
+void HyprlandIpc::refreshWorkspaces() { this->requestRefresh(Workspaces); }
+void HyprlandIpc::refreshMonitors() { this->requestRefresh(Monitors); }
+void HyprlandIpc::refreshClients() { this->requestRefresh(Clients); }
+
+void HyprlandIpc::requestRefresh(Refresh refresh) {
+	// a burst of events only needs one request in flight, plus one more after it if
+	// the burst continued past the point the first request was answered.
+	if (this->pendingRefreshes & refresh) {
+		this->staleRefreshes |= refresh;
+		return;
+	}
+
+	this->pendingRefreshes |= refresh;
+
+	QByteArray request;
+	switch (refresh) {
+	case Workspaces: request = "j/workspaces"; break;
+	case Monitors: request = "j/monitors"; break;
+	case Clients: request = "j/clients"; break;
+	}
+
+	auto* req = HyprlandRequest::send(this->requestPath, request, this);
+
+	QObject::connect(
+	    req,
+	    &HyprlandRequest::finished,
+	    this,
+	    [this, refresh](bool success, const QByteArray& reply) {
+		    this->pendingRefreshes &= ~refresh;
+
+		    if (this->staleRefreshes & refresh) {
+			    this->staleRefreshes &= ~refresh;
+			    this->requestRefresh(refresh);
+		    }
+
+		    if (success) this->onRefreshReply(refresh, reply);
+	    }
+	);
+}
+
+void HyprlandIpc::onRefreshReply(Refresh refresh, const QByteArray& reply) {
+	QJsonParseError error;
+	auto document = QJsonDocument::fromJson(reply, &error);
+
+	if (error.error != QJsonParseError::NoError) {
+		qCWarning(logHyprlandIpc) << "Failed to parse reply:" << error.errorString();
+		return;
+	}
+
+	switch (refresh) {
+	case Workspaces: this->updateWorkspaces(document.array()); break;
+	case Monitors: this->updateMonitors(document.array()); break;
+	case Clients: this->updateClients(document.array()); break;
+	}
+}
+
+void HyprlandIpc::onEventSocketStateChanged() {
+	// anything may have changed while disconnected
+	if (this->eventSocket.isConnected()) {
+		this->refreshMonitors();
+		this->refreshWorkspaces();
+		this->refreshClients();
+	}
+
+	emit this->connectedChanged();
+}
+
+void HyprlandIpc::onEvent(const QByteArray& name, const QByteArray& data) {
+	this->applyEvent(name, data);
+	emit this->rawEvent(name, data);
+}
+
+void HyprlandIpc::applyEvent(const QByteArray& name, const QByteArray& data) {
+	// Hyprland sends both v1 and v2 versions of most events. Only the one carrying
+	// the most information is handled, the others are ignored.
+
+	if (name == "workspacev2") {
+		auto fields = splitEventData(data, 2);
+		auto* workspace = this->findWorkspace(toInt(fields.at(0), 0));
+		auto* monitor = workspace == nullptr ? nullptr : this->findMonitor(workspace->monitor());
+
+		if (monitor == nullptr) {
+			// Usually a workspace created just before this event. Workspace replies don't say
+			// which one is active, so the monitors are read again as well.
+			this->requestRefresh(Workspaces);
+			this->requestRefresh(Monitors);
+		} else {
+			this->focusMonitor(monitor, workspace->name());
+		}
+	} else if (name == "focusedmon") {
+		auto fields = splitEventData(data, 2);
+		auto* monitor = this->findMonitor(QString::fromUtf8(fields.at(0)));
+
+		if (monitor == nullptr || fields.length() != 2) this->requestRefresh(Monitors);
+		else this->focusMonitor(monitor, QString::fromUtf8(fields.at(1)));
+	} else if (name == "createworkspacev2") {
+		// the event doesn't say which monitor the workspace was created on
+		auto fields = splitEventData(data, 2);
+		if (this->findWorkspace(toInt(fields.at(0), 0)) == nullptr) {
+			this->requestRefresh(Workspaces);
+		}
+	} else if (name == "destroyworkspacev2") {
+		auto fields = splitEventData(data, 2);
+		if (auto* workspace = this->findWorkspace(toInt(fields.at(0), 0))) {
+			this->removeWorkspace(workspace);
+		}
+	} else if (name == "moveworkspacev2") {
+		auto fields = splitEventData(data, 3);
+		auto* workspace = this->findWorkspace(toInt(fields.at(0), 0));
+
+		if (workspace == nullptr || fields.length() != 3) {
+			this->requestRefresh(Workspaces);
+		} else {
+			workspace->setMonitor(QString::fromUtf8(fields.at(2)));
+			// the monitor the workspace left now shows a different one
+			this->requestRefresh(Monitors);
+		}
+	} else if (name == "renameworkspace") {
+		auto fields = splitEventData(data, 2);
+		auto* workspace = this->findWorkspace(toInt(fields.at(0), 0));
+
+		if (workspace == nullptr || fields.length() != 2) {
+			this->requestRefresh(Workspaces);
+		} else {
+			auto oldName = workspace->name();
+			auto newName = QString::fromUtf8(fields.at(1));
+			workspace->setName(newName);
+
+			for (auto* monitor: this->monitors.valueList()) {
+				if (monitor->activeWorkspace() == oldName) monitor->setActiveWorkspace(newName);
+			}
+
+			for (auto* client: this->clients.valueList()) {
+				if (client->workspace() == oldName) client->setWorkspace(newName);
+			}
+		}
+	} else if (name == "monitoradded") {
+		// geometry and workspaces are not part of the event
+		this->requestRefresh(Monitors);
+	} else if (name == "monitorremoved") {
+		if (auto* monitor = this->findMonitor(QString::fromUtf8(data))) {
+			this->monitors.removeObject(monitor);
+			if (monitor == this->mFocusedMonitor) this->mFocusedMonitor = nullptr;
+			monitor->deleteLater();
+			this->updateActiveWorkspaces();
+		}
+	} else if (name == "openwindow") {
+		auto fields = splitEventData(data, 4);
+		if (fields.length() != 4) {
+			this->requestRefresh(Clients);
+			return;
+		}
+
+		auto address = clientAddress(fields.at(0));
+		if (this->findClient(address) != nullptr) return;
+
+		auto* client = new HyprlandClient(address, this);
+		client->setAppClass(QString::fromUtf8(fields.at(2)));
+		client->setTitle(QString::fromUtf8(fields.at(3)));
+		this->clients.insertObject(client);
+		this->moveClient(client, QString::fromUtf8(fields.at(1)));
+	} else if (name == "closewindow") {
+		if (auto* client = this->findClient(clientAddress(data))) this->removeClient(client);
+	} else if (name == "movewindowv2") {
+		auto fields = splitEventData(data, 3);
+		auto* client = fields.length() == 3 ? this->findClient(clientAddress(fields.at(0))) : nullptr;
+
+		if (client == nullptr) this->requestRefresh(Clients);
+		else this->moveClient(client, QString::fromUtf8(fields.at(2)));
+	} else if (name == "windowtitlev2") {
+		auto fields = splitEventData(data, 2);
+		auto* client = fields.length() == 2 ? this->findClient(clientAddress(fields.at(0))) : nullptr;
+
+		if (client == nullptr) this->requestRefresh(Clients);
+		else client->setTitle(QString::fromUtf8(fields.at(1)));
+	} else if (name == "activewindowv2") {
+		// empty when focus moves to an empty workspace
+		auto* focused = data.isEmpty() || data == "," ? nullptr : this->findClient(clientAddress(data));
+
+		for (auto* client: this->clients.valueList()) {
+			client->setFocused(client == focused);
+		}
+
+		if (focused != nullptr) focused->setUrgent(false);
+		else if (!data.isEmpty() && data != ",") this->requestRefresh(Clients);
+	} else if (name == "urgent") {
+		if (auto* client = this->findClient(clientAddress(data))) client->setUrgent(true);
+	} else if (name == "fullscreen") {
+		for (auto* client: this->clients.valueList()) {
+			if (client->focused()) client->setFullscreen(data == "1");
+		}
+	} else if (name == "configreloaded") {
+		this->requestRefresh(Monitors);
+		this->requestRefresh(Workspaces);
+		this->requestRefresh(Clients);
+	}
+}
+
+void HyprlandIpc::updateWorkspaces(const QJsonArray& workspaces) {
+	auto removed = this->workspaces.valueList();
+
+	for (const auto& value: workspaces) {
+		auto object = value.toObject();
+		auto id = object.value("id").toInt();
+		auto* workspace = this->findWorkspace(id);
+
+		if (workspace == nullptr) {
+			workspace = new HyprlandWorkspace(id, this);
+			workspace->updateFromReply(object);
+			this->insertWorkspace(workspace);
+		} else {
+			removed.removeOne(workspace);
+			workspace->updateFromReply(object);
+		}
+	}
+
+	for (auto* workspace: removed) {
+		this->removeWorkspace(workspace);
+	}
+
+	this->updateActiveWorkspaces();
+}
+
+void HyprlandIpc::updateMonitors(const QJsonArray& monitors) {
+	auto removed = this->monitors.valueList();
+	HyprlandMonitor* focusedMonitor = nullptr;
+
+	for (const auto& value: monitors) {
+		auto object = value.toObject();
+		auto name = object.value("name").toString();
+		auto* monitor = this->findMonitor(name);
+
+		if (monitor == nullptr) {
+			monitor = new HyprlandMonitor(name, this);
+			monitor->updateFromReply(object);
+			this->monitors.insertObject(monitor);
+		} else {
+			removed.removeOne(monitor);
+			monitor->updateFromReply(object);
+		}
+
+		if (monitor->focused()) focusedMonitor = monitor;
+	}
+
+	for (auto* monitor: removed) {
+		this->monitors.removeObject(monitor);
+		monitor->deleteLater();
+	}
+
+	if (focusedMonitor != this->mFocusedMonitor) {
+		this->mFocusedMonitor = focusedMonitor;
+		emit this->focusedMonitorChanged();
+	}
+
+	this->updateActiveWorkspaces();
+}
+
+void HyprlandIpc::updateClients(const QJsonArray& clients) {
+	auto removed = this->clients.valueList();
+
+	for (const auto& value: clients) {
+		auto object = value.toObject();
+		// unmapped clients have not been announced with openwindow yet
+		if (!object.value("mapped").toBool(true)) continue;
+
+		auto address = object.value("address").toString();
+		auto* client = this->findClient(address);
+
+		if (client == nullptr) {
+			client = new HyprlandClient(address, this);
+			client->updateFromReply(object);
+			this->clients.insertObject(client);
+		} else {
+			removed.removeOne(client);
+			client->updateFromReply(object);
+		}
+	}
+
+	for (auto* client: removed) {
+		this->clients.removeObject(client);
+		client->deleteLater();
+	}
+
+	for (auto* workspace: this->workspaces.valueList()) {
+		qint32 windows = 0;
+		for (auto* client: this->clients.valueList()) {
+			if (client->workspace() == workspace->name()) windows++;
+		}
+
+		workspace->setWindows(windows);
+	}
+}
+
+HyprlandWorkspace* HyprlandIpc::findWorkspace(qint32 id) const {
+	for (auto* workspace: this->workspaces.valueList()) {
+		if (workspace->id() == id) return workspace;
+	}
+
+	return nullptr;
+}
+
+HyprlandWorkspace* HyprlandIpc::findWorkspace(const QString& name) const {
+	for (auto* workspace: this->workspaces.valueList()) {
+		if (workspace->name() == name) return workspace;
+	}
+
+	return nullptr;
+}
+
+HyprlandMonitor* HyprlandIpc::findMonitor(const QString& name) const {
+	for (auto* monitor: this->monitors.valueList()) {
+		if (monitor->name() == name) return monitor;
+	}
+
+	return nullptr;
+}
+
+HyprlandClient* HyprlandIpc::findClient(const QString& address) const {
+	for (auto* client: this->clients.valueList()) {
+		if (client->address() == address) return client;
+	}
+
+	return nullptr;
+}
+
+void HyprlandIpc::insertWorkspace(HyprlandWorkspace* workspace) {
+	// numbered workspaces first, then named and special workspaces, which have negative ids
+	auto lessThan = [](const HyprlandWorkspace* a, const HyprlandWorkspace* b) {
+		if ((a->id() > 0) != (b->id() > 0)) return a->id() > 0;
+		if (a->id() > 0) return a->id() < b->id();
+		return a->name() < b->name();
+	};
+
+	const auto& list = this->workspaces.valueList();
+	qsizetype index = 0;
+	while (index < list.length() && lessThan(list.at(index), workspace)) index++;
+
+	this->workspaces.insertObject(workspace, index);
+}
+
+void HyprlandIpc::removeWorkspace(HyprlandWorkspace* workspace) {
+	this->workspaces.removeObject(workspace);
+	workspace->deleteLater();
+
+	if (workspace == this->mFocusedWorkspace) {
+		this->mFocusedWorkspace = nullptr;
+		emit this->focusedWorkspaceChanged();
+	}
+}
+
+void HyprlandIpc::removeClient(HyprlandClient* client) {
+	this->moveClient(client, QString());
+	this->clients.removeObject(client);
+	client->deleteLater();
+}
+
+void HyprlandIpc::moveClient(HyprlandClient* client, const QString& workspace) {
+	if (auto* from = this->findWorkspace(client->workspace())) {
+		from->setWindows(from->windows() - 1);
+	}
+
+	client->setWorkspace(workspace);
+
+	if (auto* to = this->findWorkspace(workspace)) {
+		to->setWindows(to->windows() + 1);
+	}
+}
+
+void HyprlandIpc::focusMonitor(HyprlandMonitor* monitor, const QString& workspace) {
+	monitor->setActiveWorkspace(workspace);
+
+	if (monitor != this->mFocusedMonitor) {
+		for (auto* other: this->monitors.valueList()) {
+			other->setFocused(other == monitor);
+		}
+
+		this->mFocusedMonitor = monitor;
+		emit this->focusedMonitorChanged();
+	}
+
+	this->updateActiveWorkspaces();
+}
+
+void HyprlandIpc::updateActiveWorkspaces() {
+	HyprlandWorkspace* focusedWorkspace = nullptr;
+
+	for (auto* workspace: this->workspaces.valueList()) {
+		auto active = false;
+		for (auto* monitor: this->monitors.valueList()) {
+			if (monitor->activeWorkspace() == workspace->name()) {
+				active = true;
+				break;
+			}
+		}
+
+		auto focused = this->mFocusedMonitor != nullptr
+		            && this->mFocusedMonitor->activeWorkspace() == workspace->name();
+
+		workspace->setActive(active);
+		workspace->setFocused(focused);
+		if (focused) focusedWorkspace = workspace;
+	}
+
+	if (focusedWorkspace != this->mFocusedWorkspace) {
+		this->mFocusedWorkspace = focusedWorkspace;
+		emit this->focusedWorkspaceChanged();
+	}
+}
+
+} // namespace qs::hyprland::ipc
@@ -0,0 +1,272 @@
+#pragma once
+
+#include <utility>
+
+#include <qbytearray.h>
+#include <qjsonarray.h>
+#include <qjsonobject.h>
+#include <qobject.h>
+#include <qqmlintegration.h>
+#include <qtmetamacros.h>
+#include <qtypes.h>
+
+#include "../core/model.hpp"
+#include "../io/socket.hpp"
+#include "ipc.hpp"
+
+namespace qs::hyprland::ipc {
+
+///! A Hyprland workspace.
+class HyprlandWorkspace: public QObject {
+	Q_OBJECT;
+	/// The id of the workspace. Special workspaces have negative ids.
+	Q_PROPERTY(qint32 id READ id CONSTANT);
+	/// The name of the workspace.
+	Q_PROPERTY(QString name READ name NOTIFY nameChanged);
+	/// The name of the monitor the workspace is on.
+	Q_PROPERTY(QString monitor READ monitor NOTIFY monitorChanged);
+	/// The number of windows on the workspace.
+	Q_PROPERTY(qint32 windows READ windows NOTIFY windowsChanged);
+	/// If the workspace is the active workspace of its monitor.
+	Q_PROPERTY(bool active READ active NOTIFY activeChanged);
+	/// If the workspace is the active workspace of the focused monitor.
+	Q_PROPERTY(bool focused READ focused NOTIFY focusedChanged);
+	QML_ELEMENT;
+	QML_UNCREATABLE("HyprlandWorkspaces are provided by Hyprland");
+
+public:
+	explicit HyprlandWorkspace(qint32 id, QObject* parent = nullptr): QObject(parent), mId(id) {}
+
+	/// Switch to this workspace.
+	Q_INVOKABLE void activate();
+
+	[[nodiscard]] qint32 id() const { return this->mId; }
+	[[nodiscard]] QString name() const { return this->mName; }
+	[[nodiscard]] QString monitor() const { return this->mMonitor; }
+	[[nodiscard]] qint32 windows() const { return this->mWindows; }
+	[[nodiscard]] bool active() const { return this->mActive; }
+	[[nodiscard]] bool focused() const { return this->mFocused; }
+
+	void setName(const QString& name);
+	void setMonitor(const QString& monitor);
+	void setWindows(qint32 windows);
+	void setActive(bool active);
+	void setFocused(bool focused);
+	void updateFromReply(const QJsonObject& workspace);
+
+signals:
+	void nameChanged();
+	void monitorChanged();
+	void windowsChanged();
+	void activeChanged();
+	void focusedChanged();
+
+private:
+	qint32 mId;
+	QString mName;
+	QString mMonitor;
+	qint32 mWindows = 0;
+	bool mActive = false;
+	bool mFocused = false;
+};
+
+///! A Hyprland monitor.
+class HyprlandMonitor: public QObject {
+	Q_OBJECT;
+	/// The name of the monitor.
+	Q_PROPERTY(QString name READ name CONSTANT);
+	/// The description of the monitor, usually its make, model and serial.
+	Q_PROPERTY(QString description READ description NOTIFY descriptionChanged);
+	/// The name of the workspace shown on the monitor.
+	Q_PROPERTY(QString activeWorkspace READ activeWorkspace NOTIFY activeWorkspaceChanged);
+	/// If the monitor is focused.
+	Q_PROPERTY(bool focused READ focused NOTIFY focusedChanged);
+	Q_PROPERTY(qint32 x READ x NOTIFY geometryChanged);
+	Q_PROPERTY(qint32 y READ y NOTIFY geometryChanged);
+	Q_PROPERTY(qint32 width READ width NOTIFY geometryChanged);
+	Q_PROPERTY(qint32 height READ height NOTIFY geometryChanged);
+	Q_PROPERTY(qreal scale READ scale NOTIFY scaleChanged);
+	QML_ELEMENT;
+	QML_UNCREATABLE("HyprlandMonitors are provided by Hyprland");
+
+public:
+	explicit HyprlandMonitor(QString name, QObject* parent = nullptr)
+	    : QObject(parent)
+	    , mName(std::move(name)) {}
+
+	[[nodiscard]] QString name() const { return this->mName; }
+	[[nodiscard]] QString description() const { return this->mDescription; }
+	[[nodiscard]] QString activeWorkspace() const { return this->mActiveWorkspace; }
+	[[nodiscard]] bool focused() const { return this->mFocused; }
+	[[nodiscard]] qint32 x() const { return this->mX; }
+	[[nodiscard]] qint32 y() const { return this->mY; }
+	[[nodiscard]] qint32 width() const { return this->mWidth; }
+	[[nodiscard]] qint32 height() const { return this->mHeight; }
+	[[nodiscard]] qreal scale() const { return this->mScale; }
+
+	void setActiveWorkspace(const QString& workspace);
+	void setFocused(bool focused);
+	void updateFromReply(const QJsonObject& monitor);
+
+signals:
+	void descriptionChanged();
+	void activeWorkspaceChanged();
+	void focusedChanged();
+	void geometryChanged();
+	void scaleChanged();
+
+private:
+	QString mName;
+	QString mDescription;
+	QString mActiveWorkspace;
+	bool mFocused = false;
+	qint32 mX = 0;
+	qint32 mY = 0;
+	qint32 mWidth = 0;
+	qint32 mHeight = 0;
+	qreal mScale = 1;
+};
+
+///! A Hyprland client window.
+class HyprlandClient: public QObject {
+	Q_OBJECT;
+	/// The address of the window, as used by `address:` window selectors.
+	Q_PROPERTY(QString address READ address CONSTANT);
+	/// The title of the window.
+	Q_PROPERTY(QString title READ title NOTIFY titleChanged);
+	/// The class (app id) of the window.
+	Q_PROPERTY(QString appClass READ appClass NOTIFY appClassChanged);
+	/// The name of the workspace the window is on.
+	Q_PROPERTY(QString workspace READ workspace NOTIFY workspaceChanged);
+	/// If the window is focused.
+	Q_PROPERTY(bool focused READ focused NOTIFY focusedChanged);
+	/// If the window has requested attention since it was last focused.
+	Q_PROPERTY(bool urgent READ urgent NOTIFY urgentChanged);
+	/// If the window is fullscreen.
+	Q_PROPERTY(bool fullscreen READ fullscreen NOTIFY fullscreenChanged);
+	QML_ELEMENT;
+	QML_UNCREATABLE("HyprlandClients are provided by Hyprland");
+
+public:
+	explicit HyprlandClient(QString address, QObject* parent = nullptr)
+	    : QObject(parent)
+	    , mAddress(std::move(address)) {}
+
+	/// Focus this window.
+	Q_INVOKABLE void focus();
+
+	[[nodiscard]] QString address() const { return this->mAddress; }
+	[[nodiscard]] QString title() const { return this->mTitle; }
+	[[nodiscard]] QString appClass() const { return this->mAppClass; }
+	[[nodiscard]] QString workspace() const { return this->mWorkspace; }
+	[[nodiscard]] bool focused() const { return this->mFocused; }
+	[[nodiscard]] bool urgent() const { return this->mUrgent; }
+	[[nodiscard]] bool fullscreen() const { return this->mFullscreen; }
+
+	void setTitle(const QString& title);
+	void setAppClass(const QString& appClass);
+	void setWorkspace(const QString& workspace);
+	void setFocused(bool focused);
+	void setUrgent(bool urgent);
+	void setFullscreen(bool fullscreen);
+	void updateFromReply(const QJsonObject& client);
+
+signals:
+	void titleChanged();
+	void appClassChanged();
+	void workspaceChanged();
+	void focusedChanged();
+	void urgentChanged();
+	void fullscreenChanged();
+
+private:
+	QString mAddress;
+	QString mTitle;
+	QString mAppClass;
+	QString mWorkspace;
+	bool mFocused = false;
+	bool mUrgent = false;
+	bool mFullscreen = false;
+};
+
+// Connection to a Hyprland instance's sockets, shared by every engine generation.
+//
+// Events from `.socket2.sock` are applied to the models directly where possible.
+// Events that don't carry enough information to be applied trigger a request for
+// the affected state on `.socket.sock`, which is then diffed against the models.
+class HyprlandIpc: public QObject {
+	Q_OBJECT;
+
+public:
+	explicit HyprlandIpc(QString requestPath, const QString& eventPath, QObject* parent = nullptr);
+
+	// null if HYPRLAND_INSTANCE_SIGNATURE is not set
+	static HyprlandIpc* instance();
+
+	void dispatch(const QString& request);
+	void refreshWorkspaces();
+	void refreshMonitors();
+	void refreshClients();
+
+	[[nodiscard]] QString requestSocketPath() const { return this->requestPath; }
+	[[nodiscard]] QString eventSocketPath() const;
+	[[nodiscard]] bool isConnected() const;
+	[[nodiscard]] HyprlandWorkspace* focusedWorkspace() const;
+	[[nodiscard]] HyprlandMonitor* focusedMonitor() const;
+
+	ObjectModel<HyprlandWorkspace> workspaces {this};
+	ObjectModel<HyprlandMonitor> monitors {this};
+	ObjectModel<HyprlandClient> clients {this};
+
+signals:
+	void connectedChanged();
+	void focusedWorkspaceChanged();
+	void focusedMonitorChanged();
+	void rawEvent(const QByteArray& name, const QByteArray& data);
+
+private slots:
+	void onEventSocketStateChanged();
+	void onEvent(const QByteArray& name, const QByteArray& data);
+
+private:
+	enum Refresh : quint8 {
+		Workspaces = 1 << 0,
+		Monitors = 1 << 1,
+		Clients = 1 << 2,
+	};
+
+	void requestRefresh(Refresh refresh);
+	void onRefreshReply(Refresh refresh, const QByteArray& reply);
+
+	// requests the affected state for events that can't be applied from their data
+	void applyEvent(const QByteArray& name, const QByteArray& data);
+
+	void updateWorkspaces(const QJsonArray& workspaces);
+	void updateMonitors(const QJsonArray& monitors);
+	void updateClients(const QJsonArray& clients);
+
+	[[nodiscard]] HyprlandWorkspace* findWorkspace(qint32 id) const;
+	[[nodiscard]] HyprlandWorkspace* findWorkspace(const QString& name) const;
+	[[nodiscard]] HyprlandMonitor* findMonitor(const QString& name) const;
+	[[nodiscard]] HyprlandClient* findClient(const QString& address) const;
+	void insertWorkspace(HyprlandWorkspace* workspace);
+	void removeWorkspace(HyprlandWorkspace* workspace);
+	void removeClient(HyprlandClient* client);
+	void moveClient(HyprlandClient* client, const QString& workspace);
+	void focusMonitor(HyprlandMonitor* monitor, const QString& workspace);
+	void updateActiveWorkspaces();
+
+	QString requestPath;
+	Socket eventSocket;
+	HyprlandEventParser eventParser;
+
+	// refreshes waiting for a reply, and ones that need to be requested again
+	// once it arrives because another event invalidated them in the meantime.
+	quint8 pendingRefreshes = 0;
+	quint8 staleRefreshes = 0;
+
+	HyprlandWorkspace* mFocusedWorkspace = nullptr;
+	HyprlandMonitor* mFocusedMonitor = nullptr;
+};
+
+} // namespace qs::hyprland::ipc
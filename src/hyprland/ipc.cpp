@@ -0,0 +1,91 @@
+#include "ipc.hpp"
+#include <utility>
+
+#include <qbytearray.h>
+#include <qlist.h>
+#include <qlocalsocket.h>
+#include <qlogging.h>
+#include <qloggingcategory.h>
+#include <qobject.h>
+#include <qtypes.h>
+
+Q_LOGGING_CATEGORY(logHyprlandIpc, "quickshell.hyprland.ipc", QtWarningMsg);
+
+namespace qs::hyprland::ipc {
+
+void HyprlandEventParser::onRecord(const QByteArray& record) {
+	auto split = record.indexOf(">>");
+
+	if (split == -1) {
+		qCWarning(logHyprlandIpc) << "Received malformed event:" << record;
+		return;
+	}
+
+	emit this->event(record.first(split), record.sliced(split + 2));
+}
+
+QList<QByteArray> splitEventData(const QByteArray& data, qsizetype count) {
+	QList<QByteArray> fields;
+	fields.reserve(count);
+
+	qsizetype start = 0;
+	while (fields.length() < count - 1) {
+		auto end = data.indexOf(',', start);
+		if (end == -1) break;
+
+		fields.append(data.sliced(start, end - start));
+		start = end + 1;
+	}
+
+	fields.append(data.sliced(start));
+	return fields;
+}
+
+HyprlandRequest::HyprlandRequest(QByteArray request, QObject* parent)
+    : QObject(parent)
+    , request(std::move(request)) {
+	// clang-format off
+	QObject::connect(&this->socket, &QLocalSocket::connected, this, &HyprlandRequest::onConnected);
+	QObject::connect(&this->socket, &QLocalSocket::readyRead, this, &HyprlandRequest::onReadyRead);
+	QObject::connect(&this->socket, &QLocalSocket::disconnected, this, &HyprlandRequest::onDisconnected);
+	QObject::connect(&this->socket, &QLocalSocket::errorOccurred, this, &HyprlandRequest::onError);
+	// clang-format on
+}
+
+HyprlandRequest*
+HyprlandRequest::send(const QString& path, const QByteArray& request, QObject* parent) {
+	auto* self = new HyprlandRequest(request, parent);
+	self->socket.connectToServer(path);
+	return self;
+}
+
+void HyprlandRequest::onConnected() {
+	this->socket.write(this->request);
+	this->socket.flush();
+}
+
+void HyprlandRequest::onReadyRead() { this->reply.append(this->socket.readAll()); }
+
+void HyprlandRequest::onDisconnected() {
+	this->reply.append(this->socket.readAll());
+	this->finish(true);
+}
+
+void HyprlandRequest::onError(QLocalSocket::LocalSocketError error) {
+	// the server closing the connection after replying is reported as an error as well
+	if (error == QLocalSocket::PeerClosedError) return;
+
+	qCWarning(logHyprlandIpc) << "Request" << this->request << "failed:" << error;
+	this->finish(false);
+}
+
+void HyprlandRequest::finish(bool success) {
+	if (this->done) return;
+	this->done = true;
+
+	if (!success) this->reply.clear();
+	emit this->finished(success, this->reply);
+	this->deleteLater();
+}
+
+} // namespace qs::hyprland::ipc
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <qbytearray.h>
+#include <qlist.h>
+#include <qlocalsocket.h>
+#include <qloggingcategory.h>
+#include <qobject.h>
+#include <qstring.h>
+#include <qtmetamacros.h>
+#include <qtypes.h>
+
+#include "../io/datastream.hpp"
+
+Q_DECLARE_LOGGING_CATEGORY(logHyprlandIpc);
+
+namespace qs::hyprland::ipc {
+
+// Splits `EVENT>>DATA` lines from the event socket without converting them to strings.
+class HyprlandEventParser: public SplitParser {
+	Q_OBJECT;
+
+public:
+	explicit HyprlandEventParser(QObject* parent = nullptr): SplitParser(parent) {}
+
+signals:
+	void event(const QByteArray& name, const QByteArray& data);
+
+protected:
+	void onRecord(const QByteArray& record) override;
+};
+
+// Splits event data into at most `count` comma separated fields. The last field
+// gets the remainder of the data, as titles and names may contain commas.
+QList<QByteArray> splitEventData(const QByteArray& data, qsizetype count);
+
+// A single request on the request socket. Hyprland closes the connection after
+// replying, so every request uses its own connection. Deletes itself when finished.
+class HyprlandRequest: public QObject {
+	Q_OBJECT;
+
+public:
+	static HyprlandRequest* send(const QString& path, const QByteArray& request, QObject* parent);
+
+signals:
+	// reply is empty if the request failed
+	void finished(bool success, const QByteArray& reply);
+
+private slots:
+	void onConnected();
+	void onReadyRead();
+	void onDisconnected();
+	void onError(QLocalSocket::LocalSocketError error);
+
+private:
+	HyprlandRequest(QByteArray request, QObject* parent);
+
+	void finish(bool success);
+
+	QLocalSocket socket;
+	QByteArray request;
+	QByteArray reply;
+	bool done = false;
+};
+
+} // namespace qs::hyprland::ipc
@@ -0,0 +1,81 @@
+#include "qml.hpp"
+
+#include <qbytearray.h>
+#include <qobject.h>
+#include <qstring.h>
+
+#include "../core/model.hpp"
+#include "connection.hpp"
+
+namespace qs::hyprland {
+
+using ipc::HyprlandIpc;
+
+Hyprland::Hyprland(QObject* parent): QObject(parent), ipc(HyprlandIpc::instance()) {
+	if (this->ipc == nullptr) {
+		this->emptyModel = new ObjectModel<QObject>(this);
+		return;
+	}
+
+	// clang-format off
+	QObject::connect(this->ipc, &HyprlandIpc::connectedChanged, this, &Hyprland::connectedChanged);
+	QObject::connect(this->ipc, &HyprlandIpc::focusedWorkspaceChanged, this, &Hyprland::focusedWorkspaceChanged);
+	QObject::connect(this->ipc, &HyprlandIpc::focusedMonitorChanged, this, &Hyprland::focusedMonitorChanged);
+	QObject::connect(this->ipc, &HyprlandIpc::rawEvent, this, &Hyprland::onRawEvent);
+	// clang-format on
+}
+
+void Hyprland::dispatch(const QString& request) {
+	if (this->ipc == nullptr) return;
+	this->ipc->dispatch(request);
+}
+
+void Hyprland::refresh() {
+	if (this->ipc == nullptr) return;
+	this->ipc->refreshMonitors();
+	this->ipc->refreshWorkspaces();
+	this->ipc->refreshClients();
+}
+
+QString Hyprland::requestSocketPath() const {
+	if (this->ipc == nullptr) return "";
+	return this->ipc->requestSocketPath();
+}
+
+QString Hyprland::eventSocketPath() const {
+	if (this->ipc == nullptr) return "";
+	return this->ipc->eventSocketPath();
+}
+
+bool Hyprland::isConnected() const { return this->ipc != nullptr && this->ipc->isConnected(); }
+
+UntypedObjectModel* Hyprland::workspaces() const {
+	if (this->ipc == nullptr) return this->emptyModel;
+	return &this->ipc->workspaces;
+}
+
+UntypedObjectModel* Hyprland::monitors() const {
+	if (this->ipc == nullptr) return this->emptyModel;
+	return &this->ipc->monitors;
+}
+
+UntypedObjectModel* Hyprland::clients() const {
+	if (this->ipc == nullptr) return this->emptyModel;
+	return &this->ipc->clients;
+}
+
+ipc::HyprlandWorkspace* Hyprland::focusedWorkspace() const {
+	if (this->ipc == nullptr) return nullptr;
+	return this->ipc->focusedWorkspace();
+}
+
+ipc::HyprlandMonitor* Hyprland::focusedMonitor() const {
+	if (this->ipc == nullptr) return nullptr;
+	return this->ipc->focusedMonitor();
+}
+
+void Hyprland::onRawEvent(const QByteArray& name, const QByteArray& data) {
+	emit this->rawEvent(QString::fromUtf8(name), QString::fromUtf8(data));
+}
+
+} // namespace qs::hyprland
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <qbytearray.h>
+#include <qobject.h>
+#include <qqmlintegration.h>
+#include <qtmetamacros.h>
+
+#include "../core/model.hpp"
+#include "connection.hpp"
+
+namespace qs::hyprland {
+
+///! Hyprland IPC integration
+/// Live state of the Hyprland instance named by `$HYPRLAND_INSTANCE_SIGNATURE`.
+///
+/// State is kept up to date from the event socket, and the models only report the rows
+/// that actually changed, so there is no need to rerun `hyprctl` when an event arrives.
+class Hyprland: public QObject {
+	Q_OBJECT;
+	// clang-format off
+	/// The path of the request socket, or an empty string if `$HYPRLAND_INSTANCE_SIGNATURE` is not set.
+	Q_PROPERTY(QString requestSocketPath READ requestSocketPath CONSTANT);
+	/// The path of the event socket, or an empty string if `$HYPRLAND_INSTANCE_SIGNATURE` is not set.
+	Q_PROPERTY(QString eventSocketPath READ eventSocketPath CONSTANT);
+	/// If the event socket is currently connected.
+	Q_PROPERTY(bool connected READ isConnected NOTIFY connectedChanged);
+	/// All workspaces, sorted by id. Named and special workspaces come last.
+	Q_PROPERTY(UntypedObjectModel* workspaces READ workspaces CONSTANT);
+	/// All monitors.
+	Q_PROPERTY(UntypedObjectModel* monitors READ monitors CONSTANT);
+	/// All mapped client windows.
+	Q_PROPERTY(UntypedObjectModel* clients READ clients CONSTANT);
+	/// The active workspace of the focused monitor.
+	Q_PROPERTY(qs::hyprland::ipc::HyprlandWorkspace* focusedWorkspace READ focusedWorkspace NOTIFY focusedWorkspaceChanged);
+	/// The focused monitor.
+	Q_PROPERTY(qs::hyprland::ipc::HyprlandMonitor* focusedMonitor READ focusedMonitor NOTIFY focusedMonitorChanged);
+	// clang-format on
+	QML_ELEMENT;
+	QML_SINGLETON;
+
+public:
+	explicit Hyprland(QObject* parent = nullptr);
+
+	/// Run a dispatcher, such as `workspace 2`. Equivalent to `hyprctl dispatch <request>`.
+	Q_INVOKABLE void dispatch(const QString& request);
+
+	/// Request the full state from the compositor again.
+	///
+	/// This should not be necessary, as state is updated from events.
+	Q_INVOKABLE void refresh();
+
+	[[nodiscard]] QString requestSocketPath() const;
+	[[nodiscard]] QString eventSocketPath() const;
+	[[nodiscard]] bool isConnected() const;
+	[[nodiscard]] UntypedObjectModel* workspaces() const;
+	[[nodiscard]] UntypedObjectModel* monitors() const;
+	[[nodiscard]] UntypedObjectModel* clients() const;
+	[[nodiscard]] qs::hyprland::ipc::HyprlandWorkspace* focusedWorkspace() const;
+	[[nodiscard]] qs::hyprland::ipc::HyprlandMonitor* focusedMonitor() const;
+
+signals:
+	/// Emitted for every event read from the event socket.
+	void rawEvent(const QString& name, const QString& data);
+
+	void connectedChanged();
+	void focusedWorkspaceChanged();
+	void focusedMonitorChanged();
+
+private slots:
+	void onRawEvent(const QByteArray& name, const QByteArray& data);
+
+private:
+	ipc::HyprlandIpc* ipc = nullptr;
+	// stands in for the connection's models when there is no connection
+	ObjectModel<QObject>* emptyModel = nullptr;
+};
+
+} // namespace qs::hyprland
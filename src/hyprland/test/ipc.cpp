@@ -0,0 +1,243 @@
+#include "ipc.hpp"
+
+#include <qbytearray.h>
+#include <qlist.h>
+#include <qlocalserver.h>
+#include <qlocalsocket.h>
+#include <qobject.h>
+#include <qsignalspy.h>
+#include <qtemporarydir.h>
+#include <qtest.h>
+#include <qtestcase.h>
+#include <qtypes.h>
+
+#include "../connection.hpp"
+#include "../ipc.hpp"
+
+using namespace qs::hyprland::ipc;
+
+namespace {
+
+const QByteArray WORKSPACES = R"([
+	{"id": 1, "name": "1", "monitor": "DP-1", "windows": 1},
+	{"id": 2, "name": "2", "monitor": "DP-1", "windows": 0},
+	{"id": 3, "name": "3", "monitor": "DP-2", "windows": 0}
+])";
+
+const QByteArray WORKSPACES_CREATED = R"([
+	{"id": 1, "name": "1", "monitor": "DP-1", "windows": 1},
+	{"id": 2, "name": "2", "monitor": "DP-1", "windows": 0},
+	{"id": 3, "name": "3", "monitor": "DP-2", "windows": 0},
+	{"id": 4, "name": "4", "monitor": "DP-2", "windows": 0}
+])";
+
+const QByteArray MONITORS = R"([
+	{"name": "DP-1", "x": 0, "y": 0, "width": 1920, "height": 1080, "scale": 1.0, "focused": true,
+	 "activeWorkspace": {"id": 1, "name": "1"}},
+	{"name": "DP-2", "x": 1920, "y": 0, "width": 2560, "height": 1440, "scale": 1.25, "focused": false,
+	 "activeWorkspace": {"id": 3, "name": "3"}}
+])";
+
+const QByteArray MONITORS_SWITCHED = R"([
+	{"name": "DP-1", "x": 0, "y": 0, "width": 1920, "height": 1080, "scale": 1.0, "focused": false,
+	 "activeWorkspace": {"id": 1, "name": "1"}},
+	{"name": "DP-2", "x": 1920, "y": 0, "width": 2560, "height": 1440, "scale": 1.25, "focused": true,
+	 "activeWorkspace": {"id": 4, "name": "4"}}
+])";
+
+const QByteArray CLIENTS = R"([
+	{"address": "0xa1", "mapped": true, "class": "foot", "title": "term",
+	 "workspace": {"id": 1, "name": "1"}, "focusHistoryID": 0, "fullscreen": 0}
+])";
+
+// Answers requests with canned replies and records them, and holds the event connection.
+class StandInServer {
+public:
+	StandInServer() {
+		this->requestServer.listen(this->dir.filePath(".socket.sock"));
+		this->eventServer.listen(this->dir.filePath(".socket2.sock"));
+
+		QObject::connect(&this->requestServer, &QLocalServer::newConnection, [this]() {
+			auto* socket = this->requestServer.nextPendingConnection();
+
+			QObject::connect(socket, &QLocalSocket::readyRead, [this, socket]() {
+				auto request = socket->readAll();
+				this->requests.append(request);
+
+				if (request == "j/workspaces") socket->write(this->workspaces);
+				else if (request == "j/monitors") socket->write(this->monitors);
+				else if (request == "j/clients") socket->write(this->clients);
+				else socket->write("ok");
+
+				socket->flush();
+				socket->disconnectFromServer();
+			});
+		});
+
+		QObject::connect(&this->eventServer, &QLocalServer::newConnection, [this]() {
+			this->eventSocket = this->eventServer.nextPendingConnection();
+		});
+	}
+
+	[[nodiscard]] QString requestPath() const { return this->requestServer.fullServerName(); }
+	[[nodiscard]] QString eventPath() const { return this->eventServer.fullServerName(); }
+
+	void sendEvent(const QByteArray& event) const {
+		this->eventSocket->write(event + '\n');
+		this->eventSocket->flush();
+	}
+
+	QTemporaryDir dir;
+	QLocalServer requestServer;
+	QLocalServer eventServer;
+	QLocalSocket* eventSocket = nullptr;
+	QList<QByteArray> requests;
+
+	QByteArray workspaces = WORKSPACES;
+	QByteArray monitors = MONITORS;
+	QByteArray clients = CLIENTS;
+};
+
+} // namespace
+
+void TestHyprlandIpc::splitEventData() { // NOLINT
+	auto fields = qs::hyprland::ipc::splitEventData("a1,1,foot,title, with, commas", 4);
+	QCOMPARE(fields.length(), static_cast<qsizetype>(4));
+	QCOMPARE(fields.at(0), QByteArray("a1"));
+	QCOMPARE(fields.at(2), QByteArray("foot"));
+	QCOMPARE(fields.at(3), QByteArray("title, with, commas"));
+
+	fields = qs::hyprland::ipc::splitEventData("DP-1", 2);
+	QCOMPARE(fields.length(), static_cast<qsizetype>(1));
+}
+
+void TestHyprlandIpc::eventParser() { // NOLINT
+	auto parser = HyprlandEventParser();
+	auto spy = QSignalSpy(&parser, &HyprlandEventParser::event);
+
+	auto buffer = QByteArray();
+	auto incoming = QByteArray("workspacev2>>2,2\nwindowtitlev2>>a1,a >> b\nclosewin");
+	parser.parseBytes(incoming, buffer);
+
+	QCOMPARE(spy.count(), 2);
+	QCOMPARE(spy.at(0).at(0).toByteArray(), QByteArray("workspacev2"));
+	QCOMPARE(spy.at(0).at(1).toByteArray(), QByteArray("2,2"));
+	QCOMPARE(spy.at(1).at(1).toByteArray(), QByteArray("a1,a >> b"));
+
+	incoming = "dow>>a1\n";
+	parser.parseBytes(incoming, buffer);
+	QCOMPARE(spy.count(), 3);
+	QCOMPARE(spy.at(2).at(0).toByteArray(), QByteArray("closewindow"));
+	QCOMPARE(spy.at(2).at(1).toByteArray(), QByteArray("a1"));
+}
+
+void TestHyprlandIpc::initialState() { // NOLINT
+	auto server = StandInServer();
+	auto ipc = HyprlandIpc(server.requestPath(), server.eventPath());
+
+	QTRY_COMPARE(ipc.workspaces.valueList().length(), static_cast<qsizetype>(3));
+	QTRY_COMPARE(ipc.monitors.valueList().length(), static_cast<qsizetype>(2));
+	QTRY_COMPARE(ipc.clients.valueList().length(), static_cast<qsizetype>(1));
+
+	QVERIFY(ipc.focusedMonitor() != nullptr);
+	QCOMPARE(ipc.focusedMonitor()->name(), QString("DP-1"));
+	QCOMPARE(ipc.monitors.valueList().at(1)->scale(), 1.25);
+
+	QTRY_VERIFY(ipc.focusedWorkspace() != nullptr);
+	QCOMPARE(ipc.focusedWorkspace()->name(), QString("1"));
+	QVERIFY(ipc.workspaces.valueList().at(2)->active());
+	QVERIFY(!ipc.workspaces.valueList().at(2)->focused());
+
+	auto* client = ipc.clients.valueList().at(0);
+	QCOMPARE(client->address(), QString("0xa1"));
+	QCOMPARE(client->appClass(), QString("foot"));
+	QCOMPARE(client->workspace(), QString("1"));
+	QVERIFY(client->focused());
+}
+
+void TestHyprlandIpc::incrementalEvents() { // NOLINT
+	auto server = StandInServer();
+	auto ipc = HyprlandIpc(server.requestPath(), server.eventPath());
+
+	QTRY_COMPARE(ipc.workspaces.valueList().length(), static_cast<qsizetype>(3));
+	QTRY_COMPARE(ipc.monitors.valueList().length(), static_cast<qsizetype>(2));
+	QTRY_COMPARE(ipc.clients.valueList().length(), static_cast<qsizetype>(1));
+	QTRY_VERIFY(server.eventSocket != nullptr);
+
+	auto requestCount = server.requests.length();
+	auto* one = ipc.workspaces.valueList().at(0);
+	auto* two = ipc.workspaces.valueList().at(1);
+	auto* term = ipc.clients.valueList().at(0);
+
+	auto clientInsertSpy = QSignalSpy(&ipc.clients, &UntypedObjectModel::rowsInserted);
+	auto clientRemoveSpy = QSignalSpy(&ipc.clients, &UntypedObjectModel::rowsRemoved);
+
+	server.sendEvent("workspace>>2");
+	server.sendEvent("workspacev2>>2,2");
+
+	QTRY_COMPARE(ipc.focusedWorkspace(), two);
+	QVERIFY(!one->active());
+	QVERIFY(two->active());
+	QCOMPARE(ipc.focusedMonitor()->activeWorkspace(), QString("2"));
+
+	server.sendEvent("openwindow>>b2,2,emacs,notes, draft");
+	QTRY_COMPARE(clientInsertSpy.count(), 1);
+
+	auto* emacs = ipc.clients.valueList().at(1);
+	QCOMPARE(emacs->address(), QString("0xb2"));
+	QCOMPARE(emacs->title(), QString("notes, draft"));
+	QCOMPARE(two->windows(), 1);
+
+	server.sendEvent("activewindowv2>>b2");
+	QTRY_VERIFY(emacs->focused());
+	QVERIFY(!term->focused());
+
+	server.sendEvent("windowtitlev2>>b2,notes");
+	QTRY_COMPARE(emacs->title(), QString("notes"));
+
+	server.sendEvent("movewindowv2>>b2,1,1");
+	QTRY_COMPARE(emacs->workspace(), QString("1"));
+	QCOMPARE(one->windows(), 2);
+	QCOMPARE(two->windows(), 0);
+
+	server.sendEvent("closewindow>>a1");
+	QTRY_COMPARE(clientRemoveSpy.count(), 1);
+	QCOMPARE(one->windows(), 1);
+
+	// none of the above needed the compositor to resend its state
+	QCOMPARE(server.requests.length(), requestCount);
+}
+
+void TestHyprlandIpc::refreshFallback() { // NOLINT
+	auto server = StandInServer();
+	auto ipc = HyprlandIpc(server.requestPath(), server.eventPath());
+
+	QTRY_COMPARE(ipc.workspaces.valueList().length(), static_cast<qsizetype>(3));
+	QTRY_VERIFY(server.eventSocket != nullptr);
+
+	auto* first = ipc.workspaces.valueList().at(0);
+	auto insertSpy = QSignalSpy(&ipc.workspaces, &UntypedObjectModel::rowsInserted);
+	auto removeSpy = QSignalSpy(&ipc.workspaces, &UntypedObjectModel::rowsRemoved);
+
+	// switching to a new workspace arrives before the workspace is known
+	server.workspaces = WORKSPACES_CREATED;
+	server.monitors = MONITORS_SWITCHED;
+	server.sendEvent("createworkspacev2>>4,4");
+	server.sendEvent("workspacev2>>4,4");
+
+	QTRY_COMPARE(ipc.workspaces.valueList().length(), static_cast<qsizetype>(4));
+	QVERIFY(server.requests.contains("j/workspaces"));
+	QTRY_VERIFY(ipc.focusedWorkspace() != nullptr && ipc.focusedWorkspace()->name() == "4");
+	QCOMPARE(ipc.focusedMonitor()->name(), QString("DP-2"));
+
+	// the existing workspaces are updated in place rather than recreated
+	QCOMPARE(insertSpy.count(), 1);
+	QCOMPARE(removeSpy.count(), 0);
+	QCOMPARE(ipc.workspaces.valueList().at(0), first);
+	QCOMPARE(ipc.workspaces.valueList().at(3)->monitor(), QString("DP-2"));
+
+	server.sendEvent("destroyworkspacev2>>4,4");
+	QTRY_COMPARE(removeSpy.count(), 1);
+}
+
+QTEST_MAIN(TestHyprlandIpc);
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <qobject.h>
+#include <qtmetamacros.h>
+
+class TestHyprlandIpc: public QObject {
+	Q_OBJECT;
+
+private slots:
+	void splitEventData();
+	void eventParser();
+	void initialState();
+	void incrementalEvents();
+	void refreshFallback();
+};
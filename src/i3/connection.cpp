@@ -0,0 +1,653 @@
+#include "connection.hpp"
+
+#include <qbytearray.h>
+#include <qjsonarray.h>
+#include <qjsondocument.h>
+#include <qjsonobject.h>
+#include <qjsonvalue.h>
+#include <qlist.h>
+#include <qlogging.h>
+#include <qloggingcategory.h>
+#include <qobject.h>
+#include <qprocessenvironment.h>
+#include <qtypes.h>
+
+#include "ipc.hpp"
+
+namespace qs::i3::ipc {
+
+namespace {
+
+QJsonValue parseJson(const QByteArray& payload) {
+	QJsonParseError error;
+	auto document = QJsonDocument::fromJson(payload, &error);
+
+	if (error.error != QJsonParseError::NoError) {
+		qCWarning(logI3Ipc) << "Failed to parse ipc message:" << error.errorString();
+		return QJsonValue();
+	}
+
+	if (document.isArray()) return document.array();
+	return document.object();
+}
+
+bool isWindowNode(const QJsonObject& node) {
+	auto type = node.value("type").toString();
+	if (type != "con" && type != "floating_con") return false;
+
+	// i3 sets window to the X11 window id, sway sets pid for both wayland and xwayland windows
+	return node.value("window").isDouble() || node.value("pid").isDouble();
+}
+
+} // namespace
+
+void I3Workspace::activate() {
+	auto* connection = I3IpcConnection::instance();
+	if (connection == nullptr) return;
+
+	auto name = this->mName;
+	name.replace('\\', "\\\\").replace('"', "\\\"");
+	connection->dispatch(QString("workspace \"%1\"").arg(name));
+}
+
+void I3Workspace::setName(const QString& name) {
+	if (name == this->mName) return;
+	this->mName = name;
+	emit this->nameChanged();
+}
+
+void I3Workspace::setNum(qint32 num) {
+	if (num == this->mNum) return;
+	this->mNum = num;
+	emit this->numChanged();
+}
+
+void I3Workspace::setOutput(const QString& output) {
+	if (output == this->mOutput) return;
+	this->mOutput = output;
+	emit this->outputChanged();
+}
+
+void I3Workspace::setFocused(bool focused) {
+	if (focused == this->mFocused) return;
+	this->mFocused = focused;
+	emit this->focusedChanged();
+}
+
+void I3Workspace::setVisible(bool visible) {
+	if (visible == this->mVisible) return;
+	this->mVisible = visible;
+	emit this->visibleChanged();
+}
+
+void I3Workspace::setUrgent(bool urgent) {
+	if (urgent == this->mUrgent) return;
+	this->mUrgent = urgent;
+	emit this->urgentChanged();
+}
+
+void I3Workspace::updateFromNode(const QJsonObject& node) {
+	// event payloads are tree nodes, which don't always carry every field of a GET_WORKSPACES reply
+	if (node.contains("name")) this->setName(node.value("name").toString());
+	if (node.contains("num")) this->setNum(node.value("num").toInt(-1));
+	if (node.value("output").isString()) this->setOutput(node.value("output").toString());
+	if (node.contains("urgent")) this->setUrgent(node.value("urgent").toBool());
+}
+
+void I3Workspace::updateFromReply(const QJsonObject& reply) {
+	this->updateFromNode(reply);
+	this->setFocused(reply.value("focused").toBool());
+	this->setVisible(reply.value("visible").toBool());
+}
+
+void I3Monitor::setFocused(bool focused) {
+	if (focused == this->mFocused) return;
+	this->mFocused = focused;
+	emit this->focusedChanged();
+}
+
+void I3Monitor::setCurrentWorkspace(const QString& workspace) {
+	if (workspace == this->mCurrentWorkspace) return;
+	this->mCurrentWorkspace = workspace;
+	emit this->currentWorkspaceChanged();
+}
+
+void I3Monitor::updateFromReply(const QJsonObject& output) {
+	auto active = output.value("active").toBool();
+	if (active != this->mActive) {
+		this->mActive = active;
+		emit this->activeChanged();
+	}
+
+	this->setCurrentWorkspace(output.value("current_workspace").toString());
+
+	auto rect = output.value("rect").toObject();
+	auto x = rect.value("x").toInt();
+	auto y = rect.value("y").toInt();
+	auto width = rect.value("width").toInt();
+	auto height = rect.value("height").toInt();
+
+	if (x != this->mX || y != this->mY || width != this->mWidth || height != this->mHeight) {
+		this->mX = x;
+		this->mY = y;
+		this->mWidth = width;
+		this->mHeight = height;
+		emit this->geometryChanged();
+	}
+
+	// only sent by sway
+	auto scale = output.value("scale").toDouble(1);
+	if (scale != this->mScale) {
+		this->mScale = scale;
+		emit this->scaleChanged();
+	}
+}
+
+void I3Window::focus() {
+	auto* connection = I3IpcConnection::instance();
+	if (connection == nullptr) return;
+
+	connection->dispatch(QString("[con_id=%1] focus").arg(this->mId));
+}
+
+void I3Window::setWorkspace(const QString& workspace) {
+	if (workspace == this->mWorkspace) return;
+	this->mWorkspace = workspace;
+	emit this->workspaceChanged();
+}
+
+void I3Window::setFocused(bool focused) {
+	if (focused == this->mFocused) return;
+	this->mFocused = focused;
+	emit this->focusedChanged();
+}
+
+void I3Window::updateFromNode(const QJsonObject& node) {
+	auto title = node.value("name").toString();
+	if (title != this->mTitle) {
+		this->mTitle = title;
+		emit this->titleChanged();
+	}
+
+	auto appId = node.value("app_id").toString();
+	if (appId.isEmpty()) {
+		appId = node.value("window_properties").toObject().value("class").toString();
+	}
+
+	if (appId != this->mAppId) {
+		this->mAppId = appId;
+		emit this->appIdChanged();
+	}
+
+	if (node.contains("focused")) this->setFocused(node.value("focused").toBool());
+
+	auto urgent = node.value("urgent").toBool();
+	if (urgent != this->mUrgent) {
+		this->mUrgent = urgent;
+		emit this->urgentChanged();
+	}
+
+	auto fullscreen = node.value("fullscreen_mode").toInt() != 0;
+	if (fullscreen != this->mFullscreen) {
+		this->mFullscreen = fullscreen;
+		emit this->fullscreenChanged();
+	}
+}
+
+I3IpcConnection::I3IpcConnection(const QString& path, QObject* parent): QObject(parent) {
+	// clang-format off
+	QObject::connect(&this->eventSocket, &Socket::connectionStateChanged, this, &I3IpcConnection::onEventSocketStateChanged);
+	QObject::connect(&this->requestSocket, &Socket::connectionStateChanged, this, &I3IpcConnection::onRequestSocketStateChanged);
+	QObject::connect(&this->eventParser, &I3IpcParser::message, this, &I3IpcConnection::onEvent);
+	QObject::connect(&this->requestParser, &I3IpcParser::message, this, &I3IpcConnection::onReply);
+	// clang-format on
+
+	this->eventSocket.setReader(&this->eventParser);
+	this->requestSocket.setReader(&this->requestParser);
+
+	for (auto* socket: {&this->eventSocket, &this->requestSocket}) {
+		socket->setPath(path);
+		socket->setAutoReconnect(true);
+		socket->setConnected(true);
+	}
+}
+
+I3IpcConnection* I3IpcConnection::instance() {
+	static I3IpcConnection* instance = nullptr; // NOLINT
+	static bool initialized = false;            // NOLINT
+
+	if (!initialized) {
+		initialized = true;
+
+		auto env = QProcessEnvironment::systemEnvironment();
+		auto path = env.value("SWAYSOCK");
+		if (path.isEmpty()) path = env.value("I3SOCK");
+
+		if (path.isEmpty()) {
+			qCWarning(logI3Ipc) << "Neither $SWAYSOCK nor $I3SOCK are set. I3 integration will not work.";
+		} else {
+			instance = new I3IpcConnection(path);
+		}
+	}
+
+	return instance;
+}
+
+QString I3IpcConnection::socketPath() const { return this->requestSocket.path(); }
+
+bool I3IpcConnection::isConnected() const {
+	return this->eventSocket.isConnected() && this->requestSocket.isConnected();
+}
+
+I3Workspace* I3IpcConnection::focusedWorkspace() const { return this->mFocusedWorkspace; }
+I3Monitor* I3IpcConnection::focusedMonitor() const { return this->mFocusedMonitor; }
+
+void I3IpcConnection::dispatch(const QString& command) {
+	if (!this->requestSocket.isConnected()) {
+		qCWarning(logI3Ipc) << "Cannot dispatch" << command << "while disconnected.";
+		return;
+	}
+
+	this->sendRequest(MessageType::RunCommand, command.toUtf8());
+}
+
+void I3IpcConnection::refreshWorkspaces() { this->requestRefresh(MessageType::GetWorkspaces); }
+void I3IpcConnection::refreshOutputs() { this->requestRefresh(MessageType::GetOutputs); }
+void I3IpcConnection::refreshTree() { this->requestRefresh(MessageType::GetTree); }
+
+void I3IpcConnection::sendRequest(quint32 type, const QByteArray& payload) {
+	this->requestSocket.writeBytes(encodeMessage(type, payload));
+	this->requestSocket.flush();
+}
+
+void I3IpcConnection::requestRefresh(quint32 type) {
+	if (!this->requestSocket.isConnected()) return;
+
+	auto bit = 1u << type;
+
+	// a burst of events only needs one request in flight, plus one more after it if
+	// the burst continued past the point the first request was answered.
+	if (this->pendingRefreshes & bit) {
+		this->staleRefreshes |= bit;
+		return;
+	}
+
+	this->pendingRefreshes |= bit;
+	this->sendRequest(type);
+}
+
+void I3IpcConnection::onEventSocketStateChanged() {
+	if (this->eventSocket.isConnected()) {
+		qCDebug(logI3Ipc) << "Event socket connected, subscribing.";
+		this->eventSocket.writeBytes(
+		    encodeMessage(MessageType::Subscribe, R"(["workspace","output","window"])")
+		);
+		this->eventSocket.flush();
+	}
+
+	emit this->connectedChanged();
+}
+
+void I3IpcConnection::onRequestSocketStateChanged() {
+	this->pendingRefreshes = 0;
+	this->staleRefreshes = 0;
+
+	if (this->requestSocket.isConnected()) {
+		this->refreshOutputs();
+		this->refreshWorkspaces();
+		this->refreshTree();
+	}
+
+	emit this->connectedChanged();
+}
+
+void I3IpcConnection::onEvent(quint32 type, const QByteArray& payload) {
+	if ((type & 0x80000000) == 0) {
+		// the reply to our subscription
+		auto success = parseJson(payload).toObject().value("success").toBool();
+		if (type == MessageType::Subscribe && !success) {
+			qCWarning(logI3Ipc) << "Failed to subscribe to events:" << payload;
+		}
+
+		return;
+	}
+
+	auto event = parseJson(payload).toObject();
+
+	switch (type) {
+	case EventType::Workspace:
+		if (!this->applyWorkspaceEvent(event)) this->refreshWorkspaces();
+		break;
+	case EventType::Output:
+		// output events carry no information about the output
+		this->refreshOutputs();
+		break;
+	case EventType::Window:
+		if (!this->applyWindowEvent(event)) this->refreshTree();
+		break;
+	default: break;
+	}
+
+	emit this->rawEvent(EventType::toString(type), payload);
+}
+
+void I3IpcConnection::onReply(quint32 type, const QByteArray& payload) {
+	auto bit = type < 32 ? 1u << type : 0;
+	this->pendingRefreshes &= ~bit;
+
+	if (this->staleRefreshes & bit) {
+		this->staleRefreshes &= ~bit;
+		this->requestRefresh(type);
+	}
+
+	auto reply = parseJson(payload);
+
+	switch (type) {
+	case MessageType::RunCommand:
+		for (const auto& result: reply.toArray()) {
+			auto object = result.toObject();
+			if (!object.value("success").toBool()) {
+				qCWarning(logI3Ipc) << "Command failed:" << object.value("error").toString();
+			}
+		}
+		break;
+	case MessageType::GetWorkspaces: this->updateWorkspaces(reply.toArray()); break;
+	case MessageType::GetOutputs: this->updateOutputs(reply.toArray()); break;
+	case MessageType::GetTree: this->updateTree(reply.toObject()); break;
+	default: break;
+	}
+}
+
+bool I3IpcConnection::applyWorkspaceEvent(const QJsonObject& event) {
+	auto change = event.value("change").toString();
+	auto current = event.value("current").toObject();
+	auto id = static_cast<qint64>(current.value("id").toDouble(-1));
+
+	auto* workspace = this->findWorkspace(id);
+
+	if (change == "init") {
+		if (workspace != nullptr) return true;
+		// without an output the workspace can't be placed correctly
+		if (!current.value("output").isString()) return false;
+
+		workspace = new I3Workspace(id, this);
+		workspace->updateFromNode(current);
+		this->insertWorkspace(workspace);
+		return true;
+	}
+
+	if (workspace == nullptr) return false;
+
+	if (change == "empty") {
+		this->workspaces.removeObject(workspace);
+		workspace->deleteLater();
+		this->updateFocus();
+		return true;
+	}
+
+	if (change == "focus") {
+		workspace->updateFromNode(current);
+		this->focusWorkspace(workspace);
+		return true;
+	}
+
+	if (change == "rename" || change == "urgent") {
+		auto num = workspace->num();
+		auto name = workspace->name();
+		workspace->updateFromNode(current);
+
+		if (auto* monitor = this->findMonitor(workspace->output())) {
+			if (monitor->currentWorkspace() == name) monitor->setCurrentWorkspace(workspace->name());
+		}
+
+		// keep the model sorted
+		if (num != workspace->num() || name != workspace->name()) {
+			this->workspaces.removeObject(workspace);
+			this->insertWorkspace(workspace);
+		}
+
+		return true;
+	}
+
+	// move, reload and anything newer need the full state
+	return false;
+}
+
+bool I3IpcConnection::applyWindowEvent(const QJsonObject& event) {
+	auto change = event.value("change").toString();
+	auto container = event.value("container").toObject();
+	auto id = static_cast<qint64>(container.value("id").toDouble(-1));
+
+	auto* window = this->findWindow(id);
+
+	if (change == "close") {
+		if (window != nullptr) {
+			this->windows.removeObject(window);
+			window->deleteLater();
+		}
+
+		return true;
+	}
+
+	// new windows and moves change the layout of the tree, which isn't described by the event
+	if (window == nullptr || change == "new" || change == "move") return false;
+
+	if (change == "focus") {
+		for (auto* other: this->windows.valueList()) {
+			if (other != window) other->setFocused(false);
+		}
+	}
+
+	window->updateFromNode(container);
+	return true;
+}
+
+void I3IpcConnection::updateWorkspaces(const QJsonArray& workspaces) {
+	auto removed = this->workspaces.valueList();
+
+	for (const auto& value: workspaces) {
+		auto object = value.toObject();
+		auto id = static_cast<qint64>(object.value("id").toDouble(-1));
+
+		auto* workspace = this->findWorkspace(id);
+
+		if (workspace == nullptr) {
+			workspace = new I3Workspace(id, this);
+			workspace->updateFromReply(object);
+			this->insertWorkspace(workspace);
+		} else {
+			removed.removeOne(workspace);
+
+			auto num = workspace->num();
+			auto name = workspace->name();
+			workspace->updateFromReply(object);
+
+			if (num != workspace->num() || name != workspace->name()) {
+				this->workspaces.removeObject(workspace);
+				this->insertWorkspace(workspace);
+			}
+		}
+	}
+
+	for (auto* workspace: removed) {
+		this->workspaces.removeObject(workspace);
+		workspace->deleteLater();
+	}
+
+	this->updateFocus();
+}
+
+void I3IpcConnection::updateOutputs(const QJsonArray& outputs) {
+	auto removed = this->monitors.valueList();
+
+	for (const auto& value: outputs) {
+		auto object = value.toObject();
+		auto name = object.value("name").toString();
+
+		// i3 reports a placeholder output which holds the scratchpad
+		if (name.isEmpty() || name == "xroot-0") continue;
+
+		auto* monitor = this->findMonitor(name);
+
+		if (monitor == nullptr) {
+			monitor = new I3Monitor(name, this);
+			monitor->updateFromReply(object);
+			this->monitors.insertObject(monitor);
+		} else {
+			removed.removeOne(monitor);
+			monitor->updateFromReply(object);
+		}
+	}
+
+	for (auto* monitor: removed) {
+		this->monitors.removeObject(monitor);
+		monitor->deleteLater();
+	}
+
+	this->updateFocus();
+}
+
+void I3IpcConnection::updateTree(const QJsonObject& tree) {
+	auto removed = this->windows.valueList();
+
+	struct Entry {
+		QJsonObject node;
+		QString workspace;
+	};
+
+	QList<Entry> stack = {{tree, QString()}};
+
+	while (!stack.isEmpty()) {
+		auto entry = stack.takeLast();
+		auto& node = entry.node;
+		auto workspace = entry.workspace;
+
+		if (node.value("type").toString() == "workspace") {
+			workspace = node.value("name").toString();
+			// scratchpad windows are not on any workspace the user can see
+			if (workspace == "__i3_scratch") continue;
+		}
+
+		if (isWindowNode(node)) {
+			auto id = static_cast<qint64>(node.value("id").toDouble(-1));
+			auto* window = this->findWindow(id);
+
+			if (window == nullptr) {
+				window = new I3Window(id, this);
+				window->updateFromNode(node);
+				window->setWorkspace(workspace);
+				this->windows.insertObject(window);
+			} else {
+				removed.removeOne(window);
+				window->updateFromNode(node);
+				window->setWorkspace(workspace);
+			}
+		}
+
+		// pushed in reverse so windows are visited in tree order
+		for (const auto& key: {"floating_nodes", "nodes"}) {
+			auto children = node.value(key).toArray();
+			for (auto i = children.size() - 1; i >= 0; i--) {
+				stack.append({children.at(i).toObject(), workspace});
+			}
+		}
+	}
+
+	for (auto* window: removed) {
+		this->windows.removeObject(window);
+		window->deleteLater();
+	}
+}
+
+I3Workspace* I3IpcConnection::findWorkspace(qint64 id) const {
+	for (auto* workspace: this->workspaces.valueList()) {
+		if (workspace->id() == id) return workspace;
+	}
+
+	return nullptr;
+}
+
+I3Monitor* I3IpcConnection::findMonitor(const QString& name) const {
+	for (auto* monitor: this->monitors.valueList()) {
+		if (monitor->name() == name) return monitor;
+	}
+
+	return nullptr;
+}
+
+I3Window* I3IpcConnection::findWindow(qint64 id) const {
+	for (auto* window: this->windows.valueList()) {
+		if (window->id() == id) return window;
+	}
+
+	return nullptr;
+}
+
+void I3IpcConnection::insertWorkspace(I3Workspace* workspace) {
+	// numbered workspaces first in numeric order, then named workspaces by name
+	auto lessThan = [](const I3Workspace* a, const I3Workspace* b) {
+		if ((a->num() < 0) != (b->num() < 0)) return a->num() >= 0;
+		if (a->num() != b->num()) return a->num() < b->num();
+		return a->name() < b->name();
+	};
+
+	const auto& list = this->workspaces.valueList();
+	qsizetype index = 0;
+	while (index < list.length() && lessThan(list.at(index), workspace)) index++;
+
+	this->workspaces.insertObject(workspace, index);
+}
+
+void I3IpcConnection::focusWorkspace(I3Workspace* workspace) {
+	workspace->setFocused(true);
+	workspace->setVisible(true);
+
+	for (auto* other: this->workspaces.valueList()) {
+		if (other == workspace) continue;
+		other->setFocused(false);
+
+		// only one workspace is visible per output
+		if (other->output() == workspace->output()) other->setVisible(false);
+	}
+
+	// focusing an empty workspace sends no window event
+	for (auto* window: this->windows.valueList()) {
+		if (window->workspace() != workspace->name()) window->setFocused(false);
+	}
+
+	if (auto* monitor = this->findMonitor(workspace->output())) {
+		monitor->setCurrentWorkspace(workspace->name());
+	}
+
+	this->updateFocus();
+}
+
+void I3IpcConnection::updateFocus() {
+	I3Workspace* focusedWorkspace = nullptr;
+
+	for (auto* workspace: this->workspaces.valueList()) {
+		if (workspace->focused()) {
+			focusedWorkspace = workspace;
+			break;
+		}
+	}
+
+	auto* focusedMonitor =
+	    focusedWorkspace == nullptr ? nullptr : this->findMonitor(focusedWorkspace->output());
+
+	for (auto* monitor: this->monitors.valueList()) {
+		monitor->setFocused(monitor == focusedMonitor);
+	}
+
+	if (focusedWorkspace != this->mFocusedWorkspace) {
+		this->mFocusedWorkspace = focusedWorkspace;
+		emit this->focusedWorkspaceChanged();
+	}
+
+	if (focusedMonitor != this->mFocusedMonitor) {
+		this->mFocusedMonitor = focusedMonitor;
+		emit this->focusedMonitorChanged();
+	}
+}
+
+} // namespace qs::i3::ipc
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <utility>
+
+#include <qbytearray.h>
+#include <qjsonarray.h>
+#include <qjsonobject.h>
+#include <qobject.h>
+#include <qqmlintegration.h>
+#include <qtclasshelpermacros.h>
+#include <qtmetamacros.h>
+#include <qtypes.h>
+
+#include "../core/model.hpp"
+#include "../io/socket.hpp"
+#include "ipc.hpp"
+
+namespace qs::i3::ipc {
+
+///! An i3 or Sway workspace.
+class I3Workspace: public QObject {
+	Q_OBJECT;
+	/// The internal id of the workspace.
+	Q_PROPERTY(qint64 id READ id CONSTANT);
+	/// The name of the workspace.
+	Q_PROPERTY(QString name READ name NOTIFY nameChanged);
+	/// The number of the workspace, or -1 if the name does not start with a number.
+	Q_PROPERTY(qint32 num READ num NOTIFY numChanged);
+	/// The name of the output the workspace is on.
+	Q_PROPERTY(QString output READ output NOTIFY outputChanged);
+	/// If the workspace contains the focused window.
+	Q_PROPERTY(bool focused READ focused NOTIFY focusedChanged);
+	/// If the workspace is visible on its output.
+	Q_PROPERTY(bool visible READ visible NOTIFY visibleChanged);
+	/// If a window on the workspace has requested attention.
+	Q_PROPERTY(bool urgent READ urgent NOTIFY urgentChanged);
+	QML_ELEMENT;
+	QML_UNCREATABLE("I3Workspaces are provided by I3");
+
+public:
+	explicit I3Workspace(qint64 id, QObject* parent = nullptr): QObject(parent), mId(id) {}
+
+	/// Switch to this workspace.
+	Q_INVOKABLE void activate();
+
+	[[nodiscard]] qint64 id() const { return this->mId; }
+	[[nodiscard]] QString name() const { return this->mName; }
+	[[nodiscard]] qint32 num() const { return this->mNum; }
+	[[nodiscard]] QString output() const { return this->mOutput; }
+	[[nodiscard]] bool focused() const { return this->mFocused; }
+	[[nodiscard]] bool visible() const { return this->mVisible; }
+	[[nodiscard]] bool urgent() const { return this->mUrgent; }
+
+	void setName(const QString& name);
+	void setNum(qint32 num);
+	void setOutput(const QString& output);
+	void setFocused(bool focused);
+	void setVisible(bool visible);
+	void setUrgent(bool urgent);
+
+	// Fields shared by workspace nodes in events and GET_WORKSPACES replies. `focused` is not
+	// one of them, in a tree node it is only set if the workspace itself has focus.
+	void updateFromNode(const QJsonObject& node);
+	void updateFromReply(const QJsonObject& reply);
+
+signals:
+	void nameChanged();
+	void numChanged();
+	void outputChanged();
+	void focusedChanged();
+	void visibleChanged();
+	void urgentChanged();
+
+private:
+	qint64 mId;
+	QString mName;
+	qint32 mNum = -1;
+	QString mOutput;
+	bool mFocused = false;
+	bool mVisible = false;
+	bool mUrgent = false;
+};
+
+///! An i3 or Sway output.
+class I3Monitor: public QObject {
+	Q_OBJECT;
+	/// The name of the output.
+	Q_PROPERTY(QString name READ name CONSTANT);
+	/// If the output is currently enabled.
+	Q_PROPERTY(bool active READ active NOTIFY activeChanged);
+	/// If the output contains the focused workspace.
+	Q_PROPERTY(bool focused READ focused NOTIFY focusedChanged);
+	/// The name of the workspace visible on the output.
+	Q_PROPERTY(QString currentWorkspace READ currentWorkspace NOTIFY currentWorkspaceChanged);
+	Q_PROPERTY(qint32 x READ x NOTIFY geometryChanged);
+	Q_PROPERTY(qint32 y READ y NOTIFY geometryChanged);
+	Q_PROPERTY(qint32 width READ width NOTIFY geometryChanged);
+	Q_PROPERTY(qint32 height READ height NOTIFY geometryChanged);
+	/// The scale of the output. Always 1 on i3.
+	Q_PROPERTY(qreal scale READ scale NOTIFY scaleChanged);
+	QML_ELEMENT;
+	QML_UNCREATABLE("I3Monitors are provided by I3");
+
+public:
+	explicit I3Monitor(QString name, QObject* parent = nullptr)
+	    : QObject(parent)
+	    , mName(std::move(name)) {}
+
+	[[nodiscard]] QString name() const { return this->mName; }
+	[[nodiscard]] bool active() const { return this->mActive; }
+	[[nodiscard]] bool focused() const { return this->mFocused; }
+	[[nodiscard]] QString currentWorkspace() const { return this->mCurrentWorkspace; }
+	[[nodiscard]] qint32 x() const { return this->mX; }
+	[[nodiscard]] qint32 y() const { return this->mY; }
+	[[nodiscard]] qint32 width() const { return this->mWidth; }
+	[[nodiscard]] qint32 height() const { return this->mHeight; }
+	[[nodiscard]] qreal scale() const { return this->mScale; }
+
+	void setFocused(bool focused);
+	void setCurrentWorkspace(const QString& workspace);
+	void updateFromReply(const QJsonObject& output);
+
+signals:
+	void activeChanged();
+	void focusedChanged();
+	void currentWorkspaceChanged();
+	void geometryChanged();
+	void scaleChanged();
+
+private:
+	QString mName;
+	bool mActive = false;
+	bool mFocused = false;
+	QString mCurrentWorkspace;
+	qint32 mX = 0;
+	qint32 mY = 0;
+	qint32 mWidth = 0;
+	qint32 mHeight = 0;
+	qreal mScale = 1;
+};
+
+///! An i3 or Sway window.
+class I3Window: public QObject {
+	Q_OBJECT;
+	/// The internal id of the window's container.
+	Q_PROPERTY(qint64 id READ id CONSTANT);
+	/// The title of the window.
+	Q_PROPERTY(QString title READ title NOTIFY titleChanged);
+	/// The wayland app id of the window, or its X11 class for X11 windows.
+	Q_PROPERTY(QString appId READ appId NOTIFY appIdChanged);
+	/// The name of the workspace the window is on.
+	Q_PROPERTY(QString workspace READ workspace NOTIFY workspaceChanged);
+	/// If the window is focused.
+	Q_PROPERTY(bool focused READ focused NOTIFY focusedChanged);
+	/// If the window has requested attention.
+	Q_PROPERTY(bool urgent READ urgent NOTIFY urgentChanged);
+	/// If the window is fullscreen.
+	Q_PROPERTY(bool fullscreen READ fullscreen NOTIFY fullscreenChanged);
+	QML_ELEMENT;
+	QML_UNCREATABLE("I3Windows are provided by I3");
+
+public:
+	explicit I3Window(qint64 id, QObject* parent = nullptr): QObject(parent), mId(id) {}
+
+	/// Focus this window.
+	Q_INVOKABLE void focus();
+
+	[[nodiscard]] qint64 id() const { return this->mId; }
+	[[nodiscard]] QString title() const { return this->mTitle; }
+	[[nodiscard]] QString appId() const { return this->mAppId; }
+	[[nodiscard]] QString workspace() const { return this->mWorkspace; }
+	[[nodiscard]] bool focused() const { return this->mFocused; }
+	[[nodiscard]] bool urgent() const { return this->mUrgent; }
+	[[nodiscard]] bool fullscreen() const { return this->mFullscreen; }
+
+	void setWorkspace(const QString& workspace);
+	void setFocused(bool focused);
+	void updateFromNode(const QJsonObject& node);
+
+signals:
+	void titleChanged();
+	void appIdChanged();
+	void workspaceChanged();
+	void focusedChanged();
+	void urgentChanged();
+	void fullscreenChanged();
+
+private:
+	qint64 mId;
+	QString mTitle;
+	QString mAppId;
+	QString mWorkspace;
+	bool mFocused = false;
+	bool mUrgent = false;
+	bool mFullscreen = false;
+};
+
+// Connection to the i3/Sway ipc socket, shared by every engine generation.
+//
+// Events are applied to the models directly where possible. Events that can't be
+// applied from their payload alone trigger a request for the affected state,
+// which is then diffed against the models.
+class I3IpcConnection: public QObject {
+	Q_OBJECT;
+
+public:
+	explicit I3IpcConnection(const QString& path, QObject* parent = nullptr);
+
+	// null if neither I3SOCK nor SWAYSOCK are set
+	static I3IpcConnection* instance();
+
+	void dispatch(const QString& command);
+	void refreshWorkspaces();
+	void refreshOutputs();
+	void refreshTree();
+
+	[[nodiscard]] QString socketPath() const;
+	[[nodiscard]] bool isConnected() const;
+	[[nodiscard]] I3Workspace* focusedWorkspace() const;
+	[[nodiscard]] I3Monitor* focusedMonitor() const;
+
+	ObjectModel<I3Workspace> workspaces {this};
+	ObjectModel<I3Monitor> monitors {this};
+	ObjectModel<I3Window> windows {this};
+
+signals:
+	void connectedChanged();
+	void focusedWorkspaceChanged();
+	void focusedMonitorChanged();
+	void rawEvent(const QString& type, const QByteArray& payload);
+
+private slots:
+	void onEventSocketStateChanged();
+	void onRequestSocketStateChanged();
+	void onEvent(quint32 type, const QByteArray& payload);
+	void onReply(quint32 type, const QByteArray& payload);
+
+private:
+	void sendRequest(quint32 type, const QByteArray& payload = QByteArray());
+	void requestRefresh(quint32 type);
+
+	bool applyWorkspaceEvent(const QJsonObject& event);
+	bool applyWindowEvent(const QJsonObject& event);
+
+	void updateWorkspaces(const QJsonArray& workspaces);
+	void updateOutputs(const QJsonArray& outputs);
+	void updateTree(const QJsonObject& tree);
+
+	I3Workspace* findWorkspace(qint64 id) const;
+	I3Monitor* findMonitor(const QString& name) const;
+	I3Window* findWindow(qint64 id) const;
+	void insertWorkspace(I3Workspace* workspace);
+	void focusWorkspace(I3Workspace* workspace);
+	void updateFocus();
+
+	Socket eventSocket;
+	Socket requestSocket;
+	I3IpcParser eventParser;
+	I3IpcParser requestParser;
+
+	I3Workspace* mFocusedWorkspace = nullptr;
+	I3Monitor* mFocusedMonitor = nullptr;
+
+	// state requests waiting for a reply, and ones that need to be sent again once it arrives
+	// because another event invalidated them in the meantime. bits are MessageTypes.
+	quint32 pendingRefreshes = 0;
+	quint32 staleRefreshes = 0;
+};
+
+} // namespace qs::i3::ipc
@@ -0,0 +1,72 @@
+#include "ipc.hpp"
+
+#include <qbytearray.h>
+#include <qendian.h>
+#include <qlogging.h>
+#include <qloggingcategory.h>
+#include <qtypes.h>
+
+Q_LOGGING_CATEGORY(logI3Ipc, "quickshell.i3.ipc", QtWarningMsg);
+
+namespace qs::i3::ipc {
+
+namespace {
+constexpr QByteArrayView MAGIC = "i3-ipc";
+}
+
+QString EventType::toString(quint32 type) {
+	switch (type) {
+	case Workspace: return QStringLiteral("workspace");
+	case Output: return QStringLiteral("output");
+	case 0x80000002: return QStringLiteral("mode");
+	case Window: return QStringLiteral("window");
+	case 0x80000004: return QStringLiteral("barconfig_update");
+	case 0x80000005: return QStringLiteral("binding");
+	case 0x80000006: return QStringLiteral("shutdown");
+	case 0x80000007: return QStringLiteral("tick");
+	default: return QStringLiteral("unknown");
+	}
+}
+
+QByteArray encodeMessage(quint32 type, const QByteArray& payload) {
+	auto length = static_cast<quint32>(payload.length());
+
+	QByteArray message;
+	message.reserve(HEADER_SIZE + payload.length());
+	message.append(MAGIC);
+	message.append(reinterpret_cast<const char*>(&length), sizeof(length)); // NOLINT
+	message.append(reinterpret_cast<const char*>(&type), sizeof(type));     // NOLINT
+	message.append(payload);
+
+	return message;
+}
+
+void I3IpcParser::parseBytes(QByteArray& incoming, QByteArray& buffer) {
+	if (&incoming != &buffer) buffer.append(incoming);
+
+	qsizetype offset = 0;
+	while (buffer.length() - offset >= HEADER_SIZE) {
+		const auto* header = buffer.constData() + offset;
+
+		if (QByteArrayView(header, MAGIC.length()) != MAGIC) {
+			qCWarning(logI3Ipc) << "Received message with invalid magic, dropping buffered data.";
+			buffer.clear();
+			return;
+		}
+
+		auto length = qFromUnaligned<quint32>(header + MAGIC.length());
+		auto type = qFromUnaligned<quint32>(header + MAGIC.length() + sizeof(quint32));
+
+		if (buffer.length() - offset - HEADER_SIZE < length) break;
+
+		// copied out as handlers may outlive the buffer
+		auto payload = buffer.sliced(offset + HEADER_SIZE, length);
+		offset += HEADER_SIZE + length;
+
+		emit this->message(type, payload);
+	}
+
+	if (offset != 0) buffer.remove(0, offset);
+}
+
+} // namespace qs::i3::ipc
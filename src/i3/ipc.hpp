@@ -0,0 +1,55 @@
+#pragma once
+
+#include <qbytearray.h>
+#include <qloggingcategory.h>
+#include <qobject.h>
+#include <qstring.h>
+#include <qtmetamacros.h>
+#include <qtypes.h>
+
+#include "../io/datastream.hpp"
+
+Q_DECLARE_LOGGING_CATEGORY(logI3Ipc);
+
+namespace qs::i3::ipc {
+
+namespace MessageType { // NOLINT
+enum Enum : quint32 {
+	RunCommand = 0,
+	GetWorkspaces = 1,
+	Subscribe = 2,
+	GetOutputs = 3,
+	GetTree = 4,
+};
+} // namespace MessageType
+
+namespace EventType { // NOLINT
+enum Enum : quint32 {
+	Workspace = 0x80000000,
+	Output = 0x80000001,
+	Window = 0x80000003,
+};
+
+QString toString(quint32 type);
+} // namespace EventType
+
+// "i3-ipc", followed by the payload length and message type as native endian u32s
+constexpr qsizetype HEADER_SIZE = 14;
+
+QByteArray encodeMessage(quint32 type, const QByteArray& payload = QByteArray());
+
+// Decodes i3 ipc framing from a stream. Used for both replies and events,
+// which share the same framing.
+class I3IpcParser: public DataStreamParser {
+	Q_OBJECT;
+
+public:
+	explicit I3IpcParser(QObject* parent = nullptr): DataStreamParser(parent) {}
+
+	void parseBytes(QByteArray& incoming, QByteArray& buffer) override;
+
+signals:
+	void message(quint32 type, const QByteArray& payload);
+};
+
+} // namespace qs::i3::ipc
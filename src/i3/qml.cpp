@@ -0,0 +1,78 @@
+#include "qml.hpp"
+
+#include <qbytearray.h>
+#include <qobject.h>
+#include <qstring.h>
+
+#include "../core/model.hpp"
+#include "connection.hpp"
+
+namespace qs::i3 {
+
+using ipc::I3IpcConnection;
+
+I3::I3(QObject* parent): QObject(parent), connection(I3IpcConnection::instance()) {
+	if (this->connection == nullptr) {
+		this->emptyModel = new ObjectModel<QObject>(this);
+		return;
+	}
+
+	// clang-format off
+	QObject::connect(this->connection, &I3IpcConnection::connectedChanged, this, &I3::connectedChanged);
+	QObject::connect(this->connection, &I3IpcConnection::focusedWorkspaceChanged, this, &I3::focusedWorkspaceChanged);
+	QObject::connect(this->connection, &I3IpcConnection::focusedMonitorChanged, this, &I3::focusedMonitorChanged);
+	QObject::connect(this->connection, &I3IpcConnection::rawEvent, this, &I3::onRawEvent);
+	// clang-format on
+}
+
+void I3::dispatch(const QString& command) {
+	if (this->connection == nullptr) return;
+	this->connection->dispatch(command);
+}
+
+void I3::refresh() {
+	if (this->connection == nullptr) return;
+	this->connection->refreshOutputs();
+	this->connection->refreshWorkspaces();
+	this->connection->refreshTree();
+}
+
+QString I3::socketPath() const {
+	if (this->connection == nullptr) return "";
+	return this->connection->socketPath();
+}
+
+bool I3::isConnected() const {
+	return this->connection != nullptr && this->connection->isConnected();
+}
+
+UntypedObjectModel* I3::workspaces() const {
+	if (this->connection == nullptr) return this->emptyModel;
+	return &this->connection->workspaces;
+}
+
+UntypedObjectModel* I3::monitors() const {
+	if (this->connection == nullptr) return this->emptyModel;
+	return &this->connection->monitors;
+}
+
+UntypedObjectModel* I3::windows() const {
+	if (this->connection == nullptr) return this->emptyModel;
+	return &this->connection->windows;
+}
+
+ipc::I3Workspace* I3::focusedWorkspace() const {
+	if (this->connection == nullptr) return nullptr;
+	return this->connection->focusedWorkspace();
+}
+
+ipc::I3Monitor* I3::focusedMonitor() const {
+	if (this->connection == nullptr) return nullptr;
+	return this->connection->focusedMonitor();
+}
+
+void I3::onRawEvent(const QString& type, const QByteArray& payload) {
+	emit this->rawEvent(type, QString::fromUtf8(payload));
+}
+
+} // namespace qs::i3
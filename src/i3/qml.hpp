@@ -0,0 +1,75 @@
+#pragma once
+
+#include <qbytearray.h>
+#include <qobject.h>
+#include <qqmlintegration.h>
+#include <qtmetamacros.h>
+
+#include "../core/model.hpp"
+#include "connection.hpp"
+
+namespace qs::i3 {
+
+///! I3/Sway IPC integration
+/// Live state of an i3 or Sway session, read from the socket in `$SWAYSOCK` or `$I3SOCK`.
+///
+/// State is kept up to date from ipc events, and the models only report the rows
+/// that actually changed, so views over them are cheap to keep around.
+class I3: public QObject {
+	Q_OBJECT;
+	// clang-format off
+	/// The path of the ipc socket, or an empty string if neither `$SWAYSOCK` nor `$I3SOCK` are set.
+	Q_PROPERTY(QString socketPath READ socketPath CONSTANT);
+	/// If the connection to the ipc socket is currently established.
+	Q_PROPERTY(bool connected READ isConnected NOTIFY connectedChanged);
+	/// All workspaces, sorted by number and then by name.
+	Q_PROPERTY(UntypedObjectModel* workspaces READ workspaces CONSTANT);
+	/// All outputs.
+	Q_PROPERTY(UntypedObjectModel* monitors READ monitors CONSTANT);
+	/// All windows, in tree order. Windows in the scratchpad are not included.
+	Q_PROPERTY(UntypedObjectModel* windows READ windows CONSTANT);
+	/// The currently focused workspace.
+	Q_PROPERTY(qs::i3::ipc::I3Workspace* focusedWorkspace READ focusedWorkspace NOTIFY focusedWorkspaceChanged);
+	/// The currently focused output.
+	Q_PROPERTY(qs::i3::ipc::I3Monitor* focusedMonitor READ focusedMonitor NOTIFY focusedMonitorChanged);
+	// clang-format on
+	QML_ELEMENT;
+	QML_SINGLETON;
+
+public:
+	explicit I3(QObject* parent = nullptr);
+
+	/// Run an i3/Sway command, such as `workspace 2`.
+	Q_INVOKABLE void dispatch(const QString& command);
+
+	/// Request the full state from the compositor again.
+	///
+	/// This should not be necessary, as state is updated from events.
+	Q_INVOKABLE void refresh();
+
+	[[nodiscard]] QString socketPath() const;
+	[[nodiscard]] bool isConnected() const;
+	[[nodiscard]] UntypedObjectModel* workspaces() const;
+	[[nodiscard]] UntypedObjectModel* monitors() const;
+	[[nodiscard]] UntypedObjectModel* windows() const;
+	[[nodiscard]] qs::i3::ipc::I3Workspace* focusedWorkspace() const;
+	[[nodiscard]] qs::i3::ipc::I3Monitor* focusedMonitor() const;
+
+signals:
+	/// Emitted for every ipc event, with the event's name and raw json payload.
+	void rawEvent(const QString& type, const QString& data);
+
+	void connectedChanged();
+	void focusedWorkspaceChanged();
+	void focusedMonitorChanged();
+
+private slots:
+	void onRawEvent(const QString& type, const QByteArray& payload);
+
+private:
+	ipc::I3IpcConnection* connection = nullptr;
+	// stands in for the connection's models when there is no connection
+	ObjectModel<QObject>* emptyModel = nullptr;
+};
+
+} // namespace qs::i3
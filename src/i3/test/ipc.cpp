@@ -0,0 +1,298 @@
+#include "ipc.hpp"
+
+#include <qbytearray.h>
+#include <qhash.h>
+#include <qlist.h>
+#include <qlocalserver.h>
+#include <qlocalsocket.h>
+#include <qobject.h>
+#include <qsignalspy.h>
+#include <qtemporarydir.h>
+#include <qtest.h>
+#include <qtestcase.h>
+#include <qtypes.h>
+
+#include "../connection.hpp"
+#include "../ipc.hpp"
+
+using namespace qs::i3::ipc;
+
+namespace {
+
+const QByteArray WORKSPACES = R"([
+	{"id": 10, "num": 1, "name": "1", "output": "DP-1", "focused": true, "visible": true, "urgent": false},
+	{"id": 11, "num": 2, "name": "2", "output": "DP-1", "focused": false, "visible": false, "urgent": false},
+	{"id": 12, "num": -1, "name": "mail", "output": "DP-2", "focused": false, "visible": true, "urgent": false}
+])";
+
+const QByteArray OUTPUTS = R"([
+	{"name": "DP-1", "active": true, "current_workspace": "1", "rect": {"x": 0, "y": 0, "width": 1920, "height": 1080}},
+	{"name": "DP-2", "active": true, "current_workspace": "mail", "rect": {"x": 1920, "y": 0, "width": 1920, "height": 1080}}
+])";
+
+const QByteArray TREE_ONE_WINDOW = R"({"type": "root", "nodes": [
+	{"type": "output", "name": "DP-1", "nodes": [
+		{"type": "workspace", "name": "1", "nodes": [
+			{"type": "con", "id": 100, "pid": 1, "name": "term", "app_id": "foot", "focused": true, "nodes": []}
+		]}
+	]}
+]})";
+
+const QByteArray TREE_TWO_WINDOWS = R"({"type": "root", "nodes": [
+	{"type": "output", "name": "DP-1", "nodes": [
+		{"type": "workspace", "name": "1", "nodes": [
+			{"type": "con", "id": 100, "pid": 1, "name": "term", "app_id": "foot", "focused": false, "nodes": []},
+			{"type": "con", "id": 101, "pid": 2, "name": "editor", "app_id": "emacs", "focused": true, "nodes": []}
+		]}
+	]}
+]})";
+
+// Answers state requests with canned replies and records which requests were made.
+class StandInServer {
+public:
+	StandInServer() {
+		this->server.listen(this->dir.filePath("ipc.sock"));
+
+		QObject::connect(&this->server, &QLocalServer::newConnection, [this]() {
+			auto* socket = this->server.nextPendingConnection();
+			auto* parser = new I3IpcParser(socket);
+
+			auto onRequest = [this, socket](quint32 type, const QByteArray& /*payload*/) {
+				this->requests.append(type);
+
+				QByteArray reply;
+				switch (type) {
+				case MessageType::GetWorkspaces: reply = this->workspaces; break;
+				case MessageType::GetOutputs: reply = this->outputs; break;
+				case MessageType::GetTree: reply = this->tree; break;
+				case MessageType::Subscribe:
+					this->eventSocket = socket;
+					reply = R"({"success": true})";
+					break;
+				default: reply = R"([{"success": true}])"; break;
+				}
+
+				socket->write(encodeMessage(type, reply));
+				socket->flush();
+			};
+
+			QObject::connect(parser, &I3IpcParser::message, onRequest);
+
+			QObject::connect(socket, &QLocalSocket::readyRead, [this, socket, parser]() {
+				auto incoming = socket->readAll();
+				parser->parseBytes(incoming, this->buffers[socket]);
+			});
+		});
+	}
+
+	[[nodiscard]] QString path() const { return this->server.fullServerName(); }
+
+	void sendEvent(quint32 type, const QByteArray& payload) const {
+		this->eventSocket->write(encodeMessage(type, payload));
+		this->eventSocket->flush();
+	}
+
+	QTemporaryDir dir;
+	QLocalServer server;
+	QLocalSocket* eventSocket = nullptr;
+	QHash<QLocalSocket*, QByteArray> buffers;
+	QList<quint32> requests;
+
+	QByteArray workspaces = WORKSPACES;
+	QByteArray outputs = OUTPUTS;
+	QByteArray tree = TREE_ONE_WINDOW;
+};
+
+} // namespace
+
+void TestI3Ipc::splitFrames() { // NOLINT
+	auto parser = I3IpcParser();
+	auto spy = QSignalSpy(&parser, &I3IpcParser::message);
+
+	auto stream = encodeMessage(EventType::Workspace, R"({"change":"focus"})")
+	            + encodeMessage(MessageType::GetTree, "{}");
+
+	auto buffer = QByteArray();
+
+	// split inside the headers of both messages
+	auto first = stream.first(5);
+	auto second = stream.sliced(5, stream.length() - 8);
+	auto third = stream.last(3);
+
+	parser.parseBytes(first, buffer);
+	QCOMPARE(spy.count(), 0);
+
+	parser.parseBytes(second, buffer);
+	QCOMPARE(spy.count(), 1);
+	QCOMPARE(spy.at(0).at(0).value<quint32>(), static_cast<quint32>(EventType::Workspace));
+	QCOMPARE(spy.at(0).at(1).toByteArray(), QByteArray(R"({"change":"focus"})"));
+
+	parser.parseBytes(third, buffer);
+	QCOMPARE(spy.count(), 2);
+	QCOMPARE(spy.at(1).at(0).value<quint32>(), static_cast<quint32>(MessageType::GetTree));
+	QCOMPARE(spy.at(1).at(1).toByteArray(), QByteArray("{}"));
+	QVERIFY(buffer.isEmpty());
+}
+
+void TestI3Ipc::invalidMagic() { // NOLINT
+	auto parser = I3IpcParser();
+	auto spy = QSignalSpy(&parser, &I3IpcParser::message);
+
+	auto buffer = QByteArray();
+	auto garbage = QByteArray("not-an-ipc-message");
+	parser.parseBytes(garbage, buffer);
+
+	QCOMPARE(spy.count(), 0);
+	QVERIFY(buffer.isEmpty());
+
+	auto message = encodeMessage(MessageType::GetOutputs, "[]");
+	parser.parseBytes(message, buffer);
+	QCOMPARE(spy.count(), 1);
+}
+
+void TestI3Ipc::initialState() { // NOLINT
+	auto server = StandInServer();
+	auto connection = I3IpcConnection(server.path());
+
+	QTRY_COMPARE(connection.workspaces.valueList().length(), static_cast<qsizetype>(3));
+	QTRY_COMPARE(connection.monitors.valueList().length(), static_cast<qsizetype>(2));
+	QTRY_COMPARE(connection.windows.valueList().length(), static_cast<qsizetype>(1));
+	QTRY_VERIFY(server.eventSocket != nullptr);
+
+	// numbered workspaces sort before named ones
+	const auto& workspaces = connection.workspaces.valueList();
+	QCOMPARE(workspaces.at(0)->name(), QString("1"));
+	QCOMPARE(workspaces.at(1)->name(), QString("2"));
+	QCOMPARE(workspaces.at(2)->name(), QString("mail"));
+
+	QCOMPARE(connection.focusedWorkspace(), workspaces.at(0));
+	QVERIFY(connection.focusedMonitor() != nullptr);
+	QCOMPARE(connection.focusedMonitor()->name(), QString("DP-1"));
+	QCOMPARE(connection.focusedMonitor()->width(), 1920);
+
+	auto* window = connection.windows.valueList().at(0);
+	QCOMPARE(window->title(), QString("term"));
+	QCOMPARE(window->appId(), QString("foot"));
+	QCOMPARE(window->workspace(), QString("1"));
+	QVERIFY(window->focused());
+}
+
+void TestI3Ipc::incrementalEvents() { // NOLINT
+	auto server = StandInServer();
+	auto connection = I3IpcConnection(server.path());
+
+	QTRY_COMPARE(connection.workspaces.valueList().length(), static_cast<qsizetype>(3));
+	QTRY_COMPARE(connection.windows.valueList().length(), static_cast<qsizetype>(1));
+	QTRY_VERIFY(server.eventSocket != nullptr);
+
+	auto* one = connection.workspaces.valueList().at(0);
+	auto* two = connection.workspaces.valueList().at(1);
+	auto requestCount = server.requests.length();
+
+	auto insertSpy = QSignalSpy(&connection.workspaces, &UntypedObjectModel::rowsInserted);
+	auto removeSpy = QSignalSpy(&connection.workspaces, &UntypedObjectModel::rowsRemoved);
+	auto focusSpy = QSignalSpy(&connection, &I3IpcConnection::focusedWorkspaceChanged);
+
+	// workspace nodes in events are only focused if the workspace itself has focus,
+	// not when a window on it does
+	server.sendEvent(
+	    EventType::Workspace,
+	    R"({"change": "focus", "current": {"id": 11, "type": "workspace", "name": "2", "num": 2,
+	        "output": "DP-1", "focused": false, "urgent": false, "nodes": []}})"
+	);
+
+	QTRY_COMPARE(focusSpy.count(), 1);
+	QCOMPARE(connection.focusedWorkspace(), two);
+	QVERIFY(two->focused());
+	QVERIFY(!one->focused());
+	QVERIFY(!one->visible());
+	QVERIFY(two->visible());
+	QCOMPARE(connection.monitors.valueList().at(0)->currentWorkspace(), QString("2"));
+
+	auto renameSpy = QSignalSpy(two, &I3Workspace::nameChanged);
+
+	server.sendEvent(
+	    EventType::Workspace,
+	    R"({"change": "rename", "current": {"id": 11, "type": "workspace", "name": "2:web",
+	        "num": 2, "output": "DP-1", "focused": false, "urgent": false, "nodes": []}})"
+	);
+
+	server.sendEvent(
+	    EventType::Workspace,
+	    R"({"change": "urgent", "current": {"id": 11, "type": "workspace", "name": "2:web",
+	        "num": 2, "output": "DP-1", "focused": false, "urgent": true, "nodes": []}})"
+	);
+
+	QTRY_VERIFY(two->urgent());
+	QCOMPARE(renameSpy.count(), 1);
+	QCOMPARE(two->name(), QString("2:web"));
+	QCOMPARE(connection.monitors.valueList().at(0)->currentWorkspace(), QString("2:web"));
+
+	// renaming and marking the focused workspace urgent leave focus alone
+	QVERIFY(two->focused());
+	QVERIFY(two->visible());
+	QCOMPARE(connection.focusedWorkspace(), two);
+	QCOMPARE(focusSpy.count(), 1);
+
+	server.sendEvent(
+	    EventType::Workspace,
+	    R"({"change": "empty", "current": {"id": 10, "name": "1", "num": 1}})"
+	);
+
+	QTRY_COMPARE(removeSpy.count(), 1);
+	QCOMPARE(connection.workspaces.valueList().length(), static_cast<qsizetype>(2));
+
+	server.sendEvent(
+	    EventType::Workspace,
+	    R"({"change": "init", "current": {"id": 13, "name": "0", "num": 0, "output": "DP-2"}})"
+	);
+
+	QTRY_COMPARE(insertSpy.count(), 1);
+	QCOMPARE(connection.workspaces.valueList().at(0)->name(), QString("0"));
+
+	auto* window = connection.windows.valueList().at(0);
+	auto titleSpy = QSignalSpy(window, &I3Window::titleChanged);
+
+	server.sendEvent(
+	    EventType::Window,
+	    R"({"change": "title", "container": {"id": 100, "name": "vim", "app_id": "foot", "focused": true}})"
+	);
+
+	QTRY_COMPARE(titleSpy.count(), 1);
+	QCOMPARE(window->title(), QString("vim"));
+
+	// none of the above needed the compositor to resend its state
+	QCOMPARE(server.requests.length(), requestCount);
+}
+
+void TestI3Ipc::treeFallback() { // NOLINT
+	auto server = StandInServer();
+	auto connection = I3IpcConnection(server.path());
+
+	QTRY_COMPARE(connection.windows.valueList().length(), static_cast<qsizetype>(1));
+	QTRY_VERIFY(server.eventSocket != nullptr);
+
+	auto* first = connection.windows.valueList().at(0);
+	auto insertSpy = QSignalSpy(&connection.windows, &UntypedObjectModel::rowsInserted);
+	auto removeSpy = QSignalSpy(&connection.windows, &UntypedObjectModel::rowsRemoved);
+
+	server.tree = TREE_TWO_WINDOWS;
+	server.sendEvent(EventType::Window, R"({"change": "new", "container": {"id": 101}})");
+
+	QTRY_COMPARE(connection.windows.valueList().length(), static_cast<qsizetype>(2));
+	QCOMPARE(server.requests.last(), static_cast<quint32>(MessageType::GetTree));
+
+	// the existing window is updated in place rather than recreated
+	QCOMPARE(insertSpy.count(), 1);
+	QCOMPARE(removeSpy.count(), 0);
+	QCOMPARE(connection.windows.valueList().at(0), first);
+	QVERIFY(!first->focused());
+	QVERIFY(connection.windows.valueList().at(1)->focused());
+
+	server.sendEvent(EventType::Window, R"({"change": "close", "container": {"id": 100}})");
+
+	QTRY_COMPARE(removeSpy.count(), 1);
+	QCOMPARE(connection.windows.valueList().at(0)->title(), QString("editor"));
+}
+
+QTEST_MAIN(TestI3Ipc);
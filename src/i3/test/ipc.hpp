@@ -0,0 +1,15 @@
+#pragma once
+
+#include <qobject.h>
+#include <qtmetamacros.h>
+
+class TestI3Ipc: public QObject {
+	Q_OBJECT;
+
+private slots:
+	void splitFrames();
+	void invalidMagic();
+	void initialState();
+	void incrementalEvents();
+	void treeFallback();
+};
@@ -0,0 +1,304 @@
+#include "coprocess.hpp"
+#include <algorithm>
+#include <utility>
+
+#include <qelapsedtimer.h>
+#include <qlist.h>
+#include <qlogging.h>
+#include <qloggingcategory.h>
+#include <qobject.h>
+#include <qprocess.h>
+#include <qtimer.h>
+#include <qtmetamacros.h>
+#include <qtypes.h>
+
+#include "datastream.hpp"
+#include "process.hpp"
+
+Q_LOGGING_CATEGORY(logCoprocess, "quickshell.io.coprocess", QtWarningMsg);
+
+Coprocess::Coprocess(QObject* parent): QObject(parent) {
+	this->clock.start();
+	this->timeoutTimer.setSingleShot(true);
+
+	QObject::connect(&this->timeoutTimer, &QTimer::timeout, this, &Coprocess::onTimeout);
+	QObject::connect(&this->framing, &DataStreamParser::read, this, &Coprocess::onResponse);
+}
+
+Coprocess::~Coprocess() {
+	// the helper is killed when destroyed along with this object
+	if (this->process != nullptr) QObject::disconnect(this->process, nullptr, this, nullptr);
+}
+
+qint64 Coprocess::request(const QString& data) {
+	if (this->process == nullptr && !this->startHelper()) return -1;
+
+	auto id = this->nextId++;
+
+	auto message = this->mIdSeparator.isEmpty() ? data
+	                                            : QString::number(id) + this->mIdSeparator + data;
+
+	message.append(this->framing.splitMarker());
+	this->process->write(message.toUtf8());
+
+	auto request = PendingRequest {.id = id};
+	request.latency.start();
+	if (this->mTimeout > 0) request.deadline = this->clock.elapsed() + this->mTimeout;
+
+	this->pending.append(request);
+	this->updateTimeoutTimer();
+	emit this->pendingRequestsChanged();
+
+	return id;
+}
+
+bool Coprocess::startHelper() {
+	if (this->mCommand.isEmpty()) {
+		qWarning() << "Coprocess request made without a command set. Dropping request.";
+		return false;
+	}
+
+	this->process = new QProcess(this);
+	this->process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+
+	// clang-format off
+	QObject::connect(this->process, &QProcess::finished, this, &Coprocess::onFinished);
+	QObject::connect(this->process, &QProcess::errorOccurred, this, &Coprocess::onErrorOccurred);
+	QObject::connect(this->process, &QProcess::readyReadStandardOutput, this, &Coprocess::onStdoutReadyRead);
+	// clang-format on
+
+	this->stdoutBuffer.clear();
+	this->uptime.start();
+
+	qCDebug(logCoprocess) << "Starting coprocess helper" << this->mCommand << "for" << this;
+
+	// writes made before the helper has finished starting are buffered by QProcess
+	this->process->start(this->mCommand.first(), this->mCommand.sliced(1));
+
+	// some failures are reported from inside start(), which has already cleared the process
+	if (this->process == nullptr) return false;
+
+	emit this->runningChanged();
+	return true;
+}
+
+void Coprocess::stopHelper(const QString& reason) {
+	if (this->process != nullptr) {
+		QObject::disconnect(this->process, nullptr, this, nullptr);
+		this->process->kill();
+		this->process->deleteLater();
+		this->process = nullptr;
+		this->stdoutBuffer.clear();
+		emit this->runningChanged();
+	}
+
+	this->failPending(reason);
+}
+
+void Coprocess::failPending(const QString& reason) {
+	if (this->pending.isEmpty()) return;
+
+	auto failed = std::exchange(this->pending, {});
+	this->timeoutTimer.stop();
+	emit this->pendingRequestsChanged();
+
+	for (const auto& request: failed) {
+		emit this->failed(request.id, reason);
+	}
+}
+
+void Coprocess::onFinished(qint32 exitCode, QProcess::ExitStatus exitStatus) {
+	qCDebug(logCoprocess) << "Coprocess helper for" << this << "exited with code" << exitCode
+	                      << exitStatus;
+
+	auto crashLooping = this->uptime.elapsed() < MIN_AUTO_RESTART_UPTIME;
+	ProcessStats::record(this->mCommand, ProcessUsage::takeReapedChildUsage());
+
+	this->process->deleteLater();
+	this->process = nullptr;
+	this->stdoutBuffer.clear();
+	emit this->runningChanged();
+
+	this->failPending(QStringLiteral("helper exited"));
+
+	if (this->mAutoRestart && !crashLooping) {
+		qCInfo(logCoprocess) << "Restarting coprocess helper" << this->mCommand;
+		this->mRestarts++;
+		emit this->restartsChanged();
+		this->startHelper();
+	}
+}
+
+void Coprocess::onErrorOccurred(QProcess::ProcessError error) {
+	if (error == QProcess::FailedToStart) { // other cases should be covered by other events
+		qWarning() << "Coprocess helper failed to start, likely because the binary could not be "
+		              "found. Command:"
+		           << this->mCommand;
+
+		this->process->deleteLater();
+		this->process = nullptr;
+		emit this->runningChanged();
+
+		this->failPending(QStringLiteral("helper failed to start"));
+	}
+}
+
+void Coprocess::onStdoutReadyRead() {
+	auto buf = this->process->readAllStandardOutput();
+	this->framing.parseBytes(buf, this->stdoutBuffer);
+}
+
+void Coprocess::onResponse(const QString& response) {
+	if (this->mIdSeparator.isEmpty()) {
+		if (this->pending.isEmpty()) {
+			qCDebug(logCoprocess) << "Dropping unsolicited response from coprocess helper for" << this;
+			return;
+		}
+
+		this->completeRequest(0, response);
+		return;
+	}
+
+	auto separator = response.indexOf(this->mIdSeparator);
+	auto ok = false;
+	auto id = separator == -1 ? -1 : response.first(separator).toLongLong(&ok);
+
+	qsizetype index = -1;
+	if (ok) {
+		for (qsizetype i = 0; i < this->pending.length(); i++) {
+			if (this->pending.at(i).id == id) {
+				index = i;
+				break;
+			}
+		}
+	}
+
+	if (index == -1) {
+		// responses to timed out requests end up here
+		qCDebug(logCoprocess) << "Dropping response with unknown id from coprocess helper for" << this
+		                      << response;
+		return;
+	}
+
+	this->completeRequest(index, response.sliced(separator + this->mIdSeparator.length()));
+}
+
+void Coprocess::completeRequest(qsizetype index, const QString& data) {
+	auto request = this->pending.takeAt(index);
+	this->recordLatency(request.latency.elapsed());
+	this->updateTimeoutTimer();
+	emit this->pendingRequestsChanged();
+	emit this->responded(request.id, data);
+}
+
+void Coprocess::recordLatency(qint64 ms) {
+	auto bucket = std::ranges::lower_bound(BUCKETS, ms) - BUCKETS.begin();
+	this->mLatencyHistogram[bucket]++;
+	emit this->latencyHistogramChanged();
+}
+
+void Coprocess::updateTimeoutTimer() {
+	qint64 earliest = 0;
+
+	for (const auto& request: this->pending) {
+		if (request.deadline != 0 && (earliest == 0 || request.deadline < earliest)) {
+			earliest = request.deadline;
+		}
+	}
+
+	if (earliest == 0) {
+		this->timeoutTimer.stop();
+	} else {
+		auto remaining = std::max(earliest - this->clock.elapsed(), static_cast<qint64>(0));
+		this->timeoutTimer.start(static_cast<qint32>(remaining));
+	}
+}
+
+void Coprocess::onTimeout() {
+	auto now = this->clock.elapsed();
+	auto expired = QList<qint64>();
+
+	this->pending.removeIf([&](const PendingRequest& request) {
+		if (request.deadline == 0 || request.deadline > now) return false;
+		expired.append(request.id);
+		return true;
+	});
+
+	if (expired.isEmpty()) {
+		this->updateTimeoutTimer();
+		return;
+	}
+
+	qCDebug(logCoprocess) << expired.length() << "requests timed out for" << this;
+	emit this->pendingRequestsChanged();
+
+	for (auto id: expired) {
+		emit this->failed(id, QStringLiteral("timed out"));
+	}
+
+	if (this->mIdSeparator.isEmpty()) {
+		// a late response would be matched to the wrong request
+		this->stopHelper(QStringLiteral("helper restarted after a timeout"));
+	} else {
+		this->updateTimeoutTimer();
+	}
+}
+
+void Coprocess::resetStatistics() {
+	this->mRestarts = 0;
+	this->mLatencyHistogram.fill(0);
+	emit this->restartsChanged();
+	emit this->latencyHistogramChanged();
+}
+
+QList<QString> Coprocess::command() const { return this->mCommand; }
+
+void Coprocess::setCommand(QList<QString> command) {
+	if (command == this->mCommand) return;
+	this->mCommand = std::move(command);
+	this->stopHelper(QStringLiteral("command changed"));
+	emit this->commandChanged();
+}
+
+bool Coprocess::isRunning() const { return this->process != nullptr; }
+
+QString Coprocess::splitMarker() const { return this->framing.splitMarker(); }
+
+void Coprocess::setSplitMarker(QString splitMarker) {
+	if (splitMarker == this->framing.splitMarker()) return;
+	this->framing.setSplitMarker(std::move(splitMarker));
+	emit this->splitMarkerChanged();
+}
+
+QString Coprocess::idSeparator() const { return this->mIdSeparator; }
+
+void Coprocess::setIdSeparator(QString idSeparator) {
+	if (idSeparator == this->mIdSeparator) return;
+	this->mIdSeparator = std::move(idSeparator);
+	emit this->idSeparatorChanged();
+}
+
+qint32 Coprocess::timeout() const { return this->mTimeout; }
+
+void Coprocess::setTimeout(qint32 timeout) {
+	timeout = std::max(timeout, 0);
+	if (timeout == this->mTimeout) return;
+	this->mTimeout = timeout;
+	emit this->timeoutChanged();
+}
+
+bool Coprocess::autoRestart() const { return this->mAutoRestart; }
+
+void Coprocess::setAutoRestart(bool autoRestart) {
+	if (autoRestart == this->mAutoRestart) return;
+	this->mAutoRestart = autoRestart;
+	emit this->autoRestartChanged();
+}
+
+qint32 Coprocess::pendingRequests() const { return static_cast<qint32>(this->pending.length()); }
+
+qint32 Coprocess::restarts() const { return this->mRestarts; }
+
+QList<qint32> Coprocess::latencyBuckets() const { return QList<qint32>(BUCKETS.begin(), BUCKETS.end()); }
+
+QList<qint32> Coprocess::latencyHistogram() const { return this->mLatencyHistogram; }
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <array>
+
+#include <qcontainerfwd.h>
+#include <qelapsedtimer.h>
+#include <qlist.h>
+#include <qloggingcategory.h>
+#include <qobject.h>
+#include <qprocess.h>
+#include <qqmlintegration.h>
+#include <qtclasshelpermacros.h>
+#include <qtimer.h>
+#include <qtmetamacros.h>
+#include <qtypes.h>
+
+#include "datastream.hpp"
+
+Q_DECLARE_LOGGING_CATEGORY(logCoprocess);
+
+///! Long running helper process answering requests.
+/// Keeps a helper process running and sends it requests over stdin, matching each
+/// response read from stdout back to its request. This avoids paying the startup cost of
+/// an interpreter such as python or jq every time a command would otherwise be run.
+///
+/// Requests and responses are delimited by [splitMarker](#prop.splitMarker), like
+/// [SplitParser](../splitparser). If [idSeparator](#prop.idSeparator) is set, each request is
+/// prefixed with its id and the separator, and the helper must prefix its response the same way.
+/// Otherwise the helper must answer requests in the order they were sent.
+///
+/// The helper is started when the first request is made, and is restarted if it exits.
+///
+/// #### Example
+/// ```qml
+/// Coprocess {
+///   id: calc
+///   command: [ "python3", "-u", "-c", "import sys\nfor l in sys.stdin: print(eval(l))" ]
+///   onResponded: (id, data) => console.log(`result: ${data}`)
+/// }
+///
+/// // ...
+/// calc.request("2 ** 16")
+/// ```
+class Coprocess: public QObject {
+	Q_OBJECT;
+	// clang-format off
+	/// The command used to start the helper. See [Process.command](../process#prop.command).
+	///
+	/// Changing the command will stop the running helper and fail any pending requests.
+	Q_PROPERTY(QList<QString> command READ command WRITE setCommand NOTIFY commandChanged);
+	/// If the helper process is currently running.
+	Q_PROPERTY(bool running READ isRunning NOTIFY runningChanged);
+	/// The delimiter between requests, and between responses. Defaults to `\n`.
+	///
+	/// Requests must not contain the delimiter.
+	Q_PROPERTY(QString splitMarker READ splitMarker WRITE setSplitMarker NOTIFY splitMarkerChanged);
+	/// The separator between a request id and its data. Defaults to an empty string,
+	/// meaning ids are not sent and responses are matched to requests in order.
+	Q_PROPERTY(QString idSeparator READ idSeparator WRITE setIdSeparator NOTIFY idSeparatorChanged);
+	/// Time in milliseconds before a request without a response fails. Defaults to 5000.
+	/// If 0, requests never time out.
+	///
+	/// If `idSeparator` is not set, a timed out request means later responses can no longer
+	/// be matched, so the helper is restarted.
+	Q_PROPERTY(qint32 timeout READ timeout WRITE setTimeout NOTIFY timeoutChanged);
+	/// If the helper should be restarted immediately when it exits unexpectedly. Defaults to true.
+	///
+	/// If false, or if the helper exits shortly after starting, it will instead be started
+	/// again when the next request is made.
+	Q_PROPERTY(bool autoRestart READ autoRestart WRITE setAutoRestart NOTIFY autoRestartChanged);
+	/// The number of requests waiting for a response.
+	Q_PROPERTY(qint32 pendingRequests READ pendingRequests NOTIFY pendingRequestsChanged);
+	/// The number of times the helper has been restarted after exiting unexpectedly.
+	Q_PROPERTY(qint32 restarts READ restarts NOTIFY restartsChanged);
+	/// Upper bounds in milliseconds of each bucket in [latencyHistogram](#prop.latencyHistogram).
+	/// The last bucket of the histogram has no upper bound.
+	Q_PROPERTY(QList<qint32> latencyBuckets READ latencyBuckets CONSTANT);
+	/// The number of responses received within each of [latencyBuckets](#prop.latencyBuckets).
+	Q_PROPERTY(QList<qint32> latencyHistogram READ latencyHistogram NOTIFY latencyHistogramChanged);
+	// clang-format on
+	QML_ELEMENT;
+
+public:
+	explicit Coprocess(QObject* parent = nullptr);
+	~Coprocess() override;
+	Q_DISABLE_COPY_MOVE(Coprocess);
+
+	/// Send a request to the helper, starting it if not running.
+	///
+	/// Returns the id of the request, which is passed to [responded()] or [failed()],
+	/// or -1 if the request could not be sent.
+	///
+	/// [responded()]: #sig.responded
+	/// [failed()]: #sig.failed
+	Q_INVOKABLE qint64 request(const QString& data);
+	/// Reset `restarts` and `latencyHistogram`.
+	Q_INVOKABLE void resetStatistics();
+
+	[[nodiscard]] QList<QString> command() const;
+	void setCommand(QList<QString> command);
+
+	[[nodiscard]] bool isRunning() const;
+
+	[[nodiscard]] QString splitMarker() const;
+	void setSplitMarker(QString splitMarker);
+
+	[[nodiscard]] QString idSeparator() const;
+	void setIdSeparator(QString idSeparator);
+
+	[[nodiscard]] qint32 timeout() const;
+	void setTimeout(qint32 timeout);
+
+	[[nodiscard]] bool autoRestart() const;
+	void setAutoRestart(bool autoRestart);
+
+	[[nodiscard]] qint32 pendingRequests() const;
+	[[nodiscard]] qint32 restarts() const;
+	[[nodiscard]] QList<qint32> latencyBuckets() const;
+	[[nodiscard]] QList<qint32> latencyHistogram() const;
+
+signals:
+	/// Emitted when the helper responds to a request.
+	void responded(qint64 id, QString data);
+	/// Emitted when a request times out or the helper exits before responding.
+	void failed(qint64 id, QString reason);
+
+	void commandChanged();
+	void runningChanged();
+	void splitMarkerChanged();
+	void idSeparatorChanged();
+	void timeoutChanged();
+	void autoRestartChanged();
+	void pendingRequestsChanged();
+	void restartsChanged();
+	void latencyHistogramChanged();
+
+private slots:
+	void onFinished(qint32 exitCode, QProcess::ExitStatus exitStatus);
+	void onErrorOccurred(QProcess::ProcessError error);
+	void onStdoutReadyRead();
+	void onResponse(const QString& response);
+	void onTimeout();
+
+private:
+	struct PendingRequest {
+		qint64 id = 0;
+		qint64 deadline = 0; // ms since `clock` started, 0 if none
+		QElapsedTimer latency;
+	};
+
+	bool startHelper();
+	void stopHelper(const QString& reason);
+	void failPending(const QString& reason);
+	void completeRequest(qsizetype index, const QString& data);
+	void recordLatency(qint64 ms);
+	void updateTimeoutTimer();
+
+	static constexpr std::array<qint32, 10> BUCKETS = {1, 2, 5, 10, 25, 50, 100, 250, 500, 1000};
+	static constexpr qint32 MIN_AUTO_RESTART_UPTIME = 1000;
+
+	QList<QString> mCommand;
+	QString mIdSeparator;
+	qint32 mTimeout = 5000;
+	bool mAutoRestart = true;
+
+	QProcess* process = nullptr;
+	QElapsedTimer uptime;
+	SplitParser framing;
+	QByteArray stdoutBuffer;
+
+	QList<PendingRequest> pending;
+	QElapsedTimer clock;
+	QTimer timeoutTimer;
+	qint64 nextId = 0;
+
+	qint32 mRestarts = 0;
+	QList<qint32> mLatencyHistogram = QList<qint32>(BUCKETS.size() + 1, 0);
+};
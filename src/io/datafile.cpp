@@ -0,0 +1,212 @@
+#include "datafile.hpp"
+#include <utility>
+
+#include <qcontainerfwd.h>
+#include <qfile.h>
+#include <qfileinfo.h>
+#include <qjsondocument.h>
+#include <qjsonvalue.h>
+#include <qlogging.h>
+#include <qloggingcategory.h>
+#include <qobject.h>
+#include <qpointer.h>
+#include <qthreadpool.h>
+#include <qtmetamacros.h>
+#include <qurl.h>
+#include <qvariant.h>
+
+Q_LOGGING_CATEGORY(logDataFile, "quickshell.io.datafile", QtWarningMsg);
+
+DataFile::~DataFile() {
+	if (!this->cacheKey.isEmpty()) DataFileCache::instance()->release(this->cacheKey);
+}
+
+QString DataFile::path() const { return this->mPath; }
+
+void DataFile::setPath(QString path) {
+	if (path.startsWith("file://")) path = QUrl(path).toLocalFile();
+	if (path == this->mPath) return;
+	this->mPath = std::move(path);
+	emit this->pathChanged();
+	this->queueLoad();
+}
+
+DataFile::Format DataFile::format() const { return this->mFormat; }
+
+void DataFile::setFormat(DataFile::Format format) {
+	if (format == this->mFormat) return;
+	this->mFormat = format;
+	emit this->formatChanged();
+	this->queueLoad();
+}
+
+QVariant DataFile::data() const { return this->mData; }
+bool DataFile::isLoading() const { return this->mLoading; }
+
+void DataFile::reload() { this->load(); }
+
+void DataFile::queueLoad() {
+	// path and format are usually set together during construction
+	if (this->loadQueued) return;
+	this->loadQueued = true;
+	QMetaObject::invokeMethod(this, &DataFile::load, Qt::QueuedConnection);
+}
+
+void DataFile::load() {
+	this->loadQueued = false;
+
+	if (this->mPath.isEmpty()) {
+		this->pendingKey.clear();
+		this->onLoadFinished(QString(), QVariant(), QString());
+		return;
+	}
+
+	this->setLoading(true);
+	DataFileCache::instance()->request(this, this->mPath, this->mFormat);
+}
+
+void DataFile::setLoading(bool loading) {
+	if (loading == this->mLoading) return;
+	this->mLoading = loading;
+	emit this->loadingChanged();
+}
+
+void DataFile::onLoadFinished(const QString& key, const QVariant& data, const QString& error) {
+	if (key != this->pendingKey) return;
+	this->pendingKey.clear();
+	this->setLoading(false);
+
+	auto* cache = DataFileCache::instance();
+	if (!this->cacheKey.isEmpty()) cache->release(this->cacheKey);
+	this->cacheKey.clear();
+
+	if (!error.isEmpty()) {
+		qCWarning(logDataFile) << "Failed to load" << this->mPath << error;
+
+		if (this->mData.isValid()) {
+			this->mData = QVariant();
+			emit this->dataChanged();
+		}
+
+		emit this->failed(error);
+		return;
+	}
+
+	if (!key.isEmpty()) {
+		cache->acquire(key);
+		this->cacheKey = key;
+	}
+
+	// Data served from the cache shares its contents with the current value, so comparing
+	// is cheap unless the file was parsed again.
+	if (data != this->mData) {
+		this->mData = data;
+		emit this->dataChanged();
+	}
+
+	if (!key.isEmpty()) emit this->loaded();
+}
+
+void DataFileCache::request(DataFile* file, const QString& path, DataFile::Format format) {
+	auto info = QFileInfo(path);
+	auto absolutePath = info.absoluteFilePath();
+	auto key = QString::number(format) + ':' + absolutePath;
+	file->pendingKey = key;
+
+	auto entry = this->entries.constFind(key);
+	if (entry != this->entries.constEnd() && info.exists() && entry->modified == info.lastModified()
+	    && entry->size == info.size())
+	{
+		qCDebug(logDataFile) << "Serving" << absolutePath << "from cache";
+		file->onLoadFinished(key, entry->data, QString());
+		return;
+	}
+
+	auto& waiting = this->pending[key];
+	auto alreadyLoading = !waiting.isEmpty();
+	if (!waiting.contains(file)) waiting.push_back(file);
+	if (alreadyLoading) return;
+
+	qCDebug(logDataFile) << "Loading" << absolutePath << "as" << format;
+
+	QThreadPool::globalInstance()->start([this, key, absolutePath, format]() {
+		auto entry = Entry();
+		QString error;
+
+		// stat before reading, so a write during the read is picked up by the next request
+		auto info = QFileInfo(absolutePath);
+		entry.modified = info.lastModified();
+		entry.size = info.size();
+
+		auto file = QFile(absolutePath);
+		if (!file.open(QFile::ReadOnly)) {
+			error = file.errorString();
+		} else {
+			auto bytes = file.readAll();
+
+			switch (format) {
+			case DataFile::Text: entry.data = QString::fromUtf8(bytes); break;
+			case DataFile::Lines: {
+				auto lines = QString::fromUtf8(bytes).split('\n');
+				if (!lines.isEmpty() && lines.last().isEmpty()) lines.removeLast();
+				entry.data = lines;
+			} break;
+			case DataFile::Json: {
+				auto parseError = QJsonParseError();
+				auto document = QJsonDocument::fromJson(bytes, &parseError);
+
+				if (parseError.error != QJsonParseError::NoError) {
+					error = parseError.errorString() + " at offset " + QString::number(parseError.offset);
+				} else {
+					entry.data = document.toVariant();
+				}
+			} break;
+			}
+		}
+
+		QMetaObject::invokeMethod(
+		    this,
+		    [this, key, entry, error]() { this->onParsed(key, entry, error); },
+		    Qt::QueuedConnection
+		);
+	});
+}
+
+void DataFileCache::onParsed(const QString& key, const Entry& parsed, const QString& error) {
+	auto waiting = this->pending.take(key);
+
+	if (error.isEmpty()) {
+		auto& entry = this->entries[key];
+		auto users = entry.users;
+		entry = parsed;
+		entry.users = users;
+	}
+
+	for (auto& file: waiting) {
+		if (file != nullptr) file->onLoadFinished(key, parsed.data, error);
+	}
+}
+
+void DataFileCache::acquire(const QString& key) {
+	auto entry = this->entries.find(key);
+	if (entry != this->entries.end()) entry->users++;
+}
+
+void DataFileCache::release(const QString& key) {
+	auto entry = this->entries.find(key);
+	if (entry != this->entries.end()) entry->users--;
+}
+
+void DataFileCache::collect() {
+	auto removed = this->entries.removeIf([this](QHash<QString, Entry>::iterator entry) {
+		return entry->users <= 0 && !this->pending.contains(entry.key());
+	});
+
+	if (removed != 0) qCDebug(logDataFile) << "Dropped" << removed << "unused files from cache";
+}
+
+DataFileCache* DataFileCache::instance() {
+	static DataFileCache* instance = nullptr; // NOLINT
+	if (instance == nullptr) instance = new DataFileCache();
+	return instance;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <qcontainerfwd.h>
+#include <qdatetime.h>
+#include <qhash.h>
+#include <qloggingcategory.h>
+#include <qobject.h>
+#include <qpointer.h>
+#include <qqmlintegration.h>
+#include <qtclasshelpermacros.h>
+#include <qtmetamacros.h>
+#include <qtypes.h>
+#include <qvariant.h>
+
+Q_DECLARE_LOGGING_CATEGORY(logDataFile);
+
+///! Asynchronously loaded data file.
+/// Reads and parses a local file on a background thread, without blocking the UI
+/// or round tripping the contents through a process.
+///
+/// Parsed data is cached by path and modification time, and the cache outlives
+/// config reloads, meaning unchanged files will not be read or parsed again after a reload.
+///
+/// #### Example
+/// ```qml
+/// DataFile {
+///   id: emojis
+///   path: "/usr/share/unicode/emoji.json"
+///   format: DataFile.Json
+/// }
+///
+/// Repeater {
+///   model: emojis.data ?? []
+///   // ...
+/// }
+/// ```
+class DataFile: public QObject {
+	Q_OBJECT;
+	/// The path of the file to load. Setting this property will start loading the file.
+	Q_PROPERTY(QString path READ path WRITE setPath NOTIFY pathChanged);
+	/// How the file should be parsed. Defaults to `DataFile.Text`.
+	Q_PROPERTY(DataFile::Format format READ format WRITE setFormat NOTIFY formatChanged);
+	/// The parsed contents of the file, or `null` if it has not been loaded or failed to load.
+	///
+	/// The data is shared between every `DataFile` loading the same file in the same format.
+	Q_PROPERTY(QVariant data READ data NOTIFY dataChanged);
+	/// If the file is currently being loaded.
+	Q_PROPERTY(bool loading READ isLoading NOTIFY loadingChanged);
+	QML_ELEMENT;
+
+public:
+	enum Format {
+		/// The file's contents as a single string.
+		Text = 0,
+		/// An array of strings, one per line.
+		Lines = 1,
+		/// The file parsed as json.
+		Json = 2,
+	};
+	Q_ENUM(Format);
+
+	explicit DataFile(QObject* parent = nullptr): QObject(parent) {}
+	~DataFile() override;
+	Q_DISABLE_COPY_MOVE(DataFile);
+
+	/// Load the file again if it has been modified since it was last loaded.
+	Q_INVOKABLE void reload();
+
+	[[nodiscard]] QString path() const;
+	void setPath(QString path);
+
+	[[nodiscard]] DataFile::Format format() const;
+	void setFormat(DataFile::Format format);
+
+	[[nodiscard]] QVariant data() const;
+	[[nodiscard]] bool isLoading() const;
+
+signals:
+	/// Emitted when the file has been loaded.
+	void loaded();
+	/// Emitted when the file could not be read or parsed.
+	void failed(QString error);
+
+	void pathChanged();
+	void formatChanged();
+	void dataChanged();
+	void loadingChanged();
+
+private:
+	void queueLoad();
+	void load();
+	void setLoading(bool loading);
+	void onLoadFinished(const QString& key, const QVariant& data, const QString& error);
+
+	QString mPath;
+	DataFile::Format mFormat = DataFile::Text;
+	QVariant mData;
+	QString cacheKey;
+	QString pendingKey;
+	bool mLoading = false;
+	bool loadQueued = false;
+
+	friend class DataFileCache;
+};
+
+class DataFileCache: public QObject {
+	Q_OBJECT;
+
+public:
+	void request(DataFile* file, const QString& path, DataFile::Format format);
+	void acquire(const QString& key);
+	void release(const QString& key);
+
+	// Drops all cached files which are not in use.
+	void collect();
+
+	static DataFileCache* instance();
+
+private:
+	struct Entry {
+		QDateTime modified;
+		qint64 size = 0;
+		QVariant data;
+		qint32 users = 0;
+	};
+
+	void onParsed(const QString& key, const Entry& entry, const QString& error);
+
+	QHash<QString, Entry> entries;
+	QHash<QString, QList<QPointer<DataFile>>> pending;
+};
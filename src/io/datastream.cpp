@@ -2,8 +2,14 @@
 #include <algorithm>
 #include <utility>
 
+#include <qbytearray.h>
+#include <qlist.h>
 #include <qlocalsocket.h>
+#include <qlogging.h>
+#include <qmetaobject.h>
 #include <qobject.h>
+#include <qqmllist.h>
+#include <qregularexpression.h>
 #include <qtmetamacros.h>
 #include <qtypes.h>
 
@@ -35,19 +41,25 @@ void DataStream::onReaderDestroyed() {
 }
 
 void DataStream::onBytesAvailable() {
+	auto* device = this->ioDevice();
+	if (this->mReader == nullptr || device == nullptr) return;
+	auto buf = device->readAll();
+	this->streamBytes(buf);
+}
+
+void DataStream::streamBytes(QByteArray& bytes) {
 	if (this->mReader == nullptr) return;
-	auto buf = this->ioDevice()->readAll();
-	this->mReader->parseBytes(buf, this->buffer);
+	this->mReader->parseBytes(bytes, this->buffer);
 }
 
 void SplitParser::parseBytes(QByteArray& incoming, QByteArray& buffer) {
 	if (this->mSplitMarker.isEmpty()) {
 		if (!buffer.isEmpty()) {
-			emit this->read(QString(buffer));
+			this->onRecord(buffer);
 			buffer.clear();
 		}
 
-		emit this->read(QString(incoming));
+		this->onRecord(incoming);
 		return;
 	}
 
@@ -82,7 +94,7 @@ void SplitParser::parseBytes(QByteArray& incoming, QByteArray& buffer) {
 			}
 			readi += mlen;
 			start = readi;
-			emit this->read(QString(slice));
+			this->onRecord(slice);
 		}
 
 	fail:;
@@ -98,6 +110,8 @@ void SplitParser::parseBytes(QByteArray& incoming, QByteArray& buffer) {
 	}
 }
 
+void SplitParser::onRecord(const QByteArray& record) { emit this->read(QString(record)); }
+
 QString SplitParser::splitMarker() const { return this->mSplitMarker; }
 
 void SplitParser::setSplitMarker(QString marker) {
@@ -107,3 +121,251 @@ void SplitParser::setSplitMarker(QString marker) {
 	this->mSplitMarkerChanged = true;
 	emit this->splitMarkerChanged();
 }
+
+void FilterParser::parseBytes(QByteArray& incoming, QByteArray& buffer) {
+	this->SplitParser::parseBytes(incoming, buffer);
+
+	// counters are reported once per read instead of once per chunk
+	if (this->countersDirty) {
+		this->countersDirty = false;
+		emit this->countersChanged();
+	}
+}
+
+void FilterParser::onRecord(const QByteArray& record) {
+	auto matches = (this->prefixBytes.isEmpty() || record.startsWith(this->prefixBytes))
+	            && (this->containsBytes.isEmpty() || record.contains(this->containsBytes));
+
+	// only decoded if a regex is set and the cheaper filters passed
+	QString text;
+	auto decoded = false;
+
+	if (matches && !this->regex.pattern().isEmpty()) {
+		text = QString(record);
+		decoded = true;
+		matches = this->regex.match(text).hasMatch();
+	}
+
+	this->countersDirty = true;
+
+	if (matches == this->mInvert) {
+		this->mDropped++;
+		return;
+	}
+
+	this->mForwarded++;
+
+	if (this->delimiterBytes.isEmpty()) {
+		emit this->read(decoded ? text : QString(record));
+		return;
+	}
+
+	auto fields = this->extractFields(record);
+
+	if (this->mFields.isEmpty()) emit this->read(decoded ? text : QString(record));
+	else emit this->read(QString(fields.join(this->delimiterBytes)));
+
+	if (this->isSignalConnected(QMetaMethod::fromSignal(&FilterParser::readFields))) {
+		auto strings = QList<QString>();
+		strings.reserve(fields.length());
+
+		for (const auto& field: fields) {
+			strings.append(QString(field));
+		}
+
+		emit this->readFields(strings);
+	}
+}
+
+QList<QByteArray> FilterParser::extractFields(const QByteArray& record) const {
+	auto all = QList<QByteArray>();
+	auto dlen = this->delimiterBytes.length();
+
+	qsizetype start = 0;
+	while (true) {
+		auto end = record.indexOf(this->delimiterBytes, start);
+
+		if (end == -1) {
+			all.append(record.sliced(start));
+			break;
+		}
+
+		all.append(record.sliced(start, end - start));
+		start = end + dlen;
+	}
+
+	if (this->mFields.isEmpty()) return all;
+
+	auto selected = QList<QByteArray>();
+	selected.reserve(this->mFields.length());
+
+	for (auto index: this->mFields) {
+		auto i = index < 0 ? all.length() + index : index;
+		selected.append(i >= 0 && i < all.length() ? all.at(i) : QByteArray());
+	}
+
+	return selected;
+}
+
+void FilterParser::resetCounters() {
+	if (this->mForwarded == 0 && this->mDropped == 0) return;
+	this->mForwarded = 0;
+	this->mDropped = 0;
+	emit this->countersChanged();
+}
+
+QString FilterParser::prefix() const { return this->mPrefix; }
+
+void FilterParser::setPrefix(QString prefix) {
+	if (prefix == this->mPrefix) return;
+	this->mPrefix = std::move(prefix);
+	this->prefixBytes = this->mPrefix.toUtf8();
+	emit this->prefixChanged();
+}
+
+QString FilterParser::contains() const { return this->mContains; }
+
+void FilterParser::setContains(QString contains) {
+	if (contains == this->mContains) return;
+	this->mContains = std::move(contains);
+	this->containsBytes = this->mContains.toUtf8();
+	emit this->containsChanged();
+}
+
+QString FilterParser::pattern() const { return this->regex.pattern(); }
+
+void FilterParser::setPattern(const QString& pattern) {
+	if (pattern == this->regex.pattern()) return;
+	this->regex.setPattern(pattern);
+
+	if (!this->regex.isValid()) {
+		qWarning() << "FilterParser pattern" << pattern
+		           << "is not a valid regular expression:" << this->regex.errorString();
+	}
+
+	this->regex.optimize();
+	emit this->patternChanged();
+}
+
+bool FilterParser::invert() const { return this->mInvert; }
+
+void FilterParser::setInvert(bool invert) {
+	if (invert == this->mInvert) return;
+	this->mInvert = invert;
+	emit this->invertChanged();
+}
+
+QString FilterParser::fieldDelimiter() const { return this->mFieldDelimiter; }
+
+void FilterParser::setFieldDelimiter(QString fieldDelimiter) {
+	if (fieldDelimiter == this->mFieldDelimiter) return;
+	this->mFieldDelimiter = std::move(fieldDelimiter);
+	this->delimiterBytes = this->mFieldDelimiter.toUtf8();
+	emit this->fieldDelimiterChanged();
+}
+
+QList<qint32> FilterParser::fields() const { return this->mFields; }
+
+void FilterParser::setFields(QList<qint32> fields) {
+	if (fields == this->mFields) return;
+	this->mFields = std::move(fields);
+	emit this->fieldsChanged();
+}
+
+qint64 FilterParser::forwarded() const { return this->mForwarded; }
+qint64 FilterParser::dropped() const { return this->mDropped; }
+
+void FanoutParser::parseBytes(QByteArray& incoming, QByteArray& buffer) {
+	// Branches keep their own carry buffers, so anything left in the stream's buffer
+	// (data read before this parser was set) is treated as the start of the stream.
+	QByteArray data;
+	if (&incoming == &buffer) {
+		data = buffer;
+	} else if (!buffer.isEmpty()) {
+		data = buffer;
+		data.append(incoming);
+	} else {
+		data = incoming;
+	}
+
+	buffer.clear();
+
+	// Handlers connected to a parser may add or remove branches, so nothing inside
+	// the list is referenced while a parser runs.
+	auto parsers = QList<DataStreamParser*>();
+	for (const auto& branch: this->branches) {
+		parsers.push_back(branch.parser);
+	}
+
+	for (auto* parser: parsers) {
+		auto index = this->branchIndex(parser);
+		if (index == -1) continue;
+
+		auto branchBuffer = std::move(this->branches[index].buffer);
+
+		// shares data with every other branch unless the parser modifies it
+		auto chunk = data;
+		parser->parseBytes(chunk, branchBuffer);
+
+		index = this->branchIndex(parser);
+		if (index != -1) this->branches[index].buffer = std::move(branchBuffer);
+	}
+}
+
+qsizetype FanoutParser::branchIndex(DataStreamParser* parser) const {
+	for (qsizetype i = 0; i < this->branches.length(); i++) {
+		if (this->branches.at(i).parser == parser) return i;
+	}
+
+	return -1;
+}
+
+QQmlListProperty<DataStreamParser> FanoutParser::parsers() {
+	return QQmlListProperty<DataStreamParser>(
+	    this,
+	    nullptr,
+	    &FanoutParser::parsersAppend,
+	    &FanoutParser::parsersCount,
+	    &FanoutParser::parserAt,
+	    &FanoutParser::parsersClear
+	);
+}
+
+void FanoutParser::onParserDestroyed(QObject* object) {
+	auto removed = this->branches.removeIf([object](const Branch& branch) {
+		return branch.parser == object;
+	});
+
+	if (removed != 0) emit this->parsersChanged();
+}
+
+void FanoutParser::parsersAppend(
+    QQmlListProperty<DataStreamParser>* prop,
+    DataStreamParser* parser
+) {
+	auto* self = static_cast<FanoutParser*>(prop->object); // NOLINT
+	if (parser == nullptr) return;
+
+	QObject::connect(parser, &QObject::destroyed, self, &FanoutParser::onParserDestroyed);
+	self->branches.append({.parser = parser, .buffer = QByteArray()});
+	emit self->parsersChanged();
+}
+
+DataStreamParser* FanoutParser::parserAt(QQmlListProperty<DataStreamParser>* prop, qsizetype i) {
+	return static_cast<FanoutParser*>(prop->object)->branches.at(i).parser; // NOLINT
+}
+
+void FanoutParser::parsersClear(QQmlListProperty<DataStreamParser>* prop) {
+	auto* self = static_cast<FanoutParser*>(prop->object); // NOLINT
+
+	for (auto& branch: self->branches) {
+		QObject::disconnect(branch.parser, nullptr, self, nullptr);
+	}
+
+	self->branches.clear();
+	emit self->parsersChanged();
+}
+
+qsizetype FanoutParser::parsersCount(QQmlListProperty<DataStreamParser>* prop) {
+	return static_cast<FanoutParser*>(prop->object)->branches.length(); // NOLINT
+}
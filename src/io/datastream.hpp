@@ -1,10 +1,14 @@
 #pragma once
 
 #include <qbytearray.h>
+#include <qlist.h>
 #include <qlocalsocket.h>
 #include <qobject.h>
 #include <qqmlintegration.h>
+#include <qqmllist.h>
+#include <qregularexpression.h>
 #include <qtmetamacros.h>
+#include <qtypes.h>
 #include <qvariant.h>
 
 class DataStreamParser;
@@ -33,6 +37,8 @@ public slots:
 
 protected:
 	[[nodiscard]] virtual QIODevice* ioDevice() const = 0;
+	// hands already read bytes to the current parser
+	void streamBytes(QByteArray& bytes);
 
 private slots:
 	void onReaderDestroyed();
@@ -84,7 +90,193 @@ public:
 signals:
 	void splitMarkerChanged();
 
+protected:
+	// called for each delimited chunk, before it is converted to a string
+	virtual void onRecord(const QByteArray& record);
+
 private:
 	QString mSplitMarker = "\n";
 	bool mSplitMarkerChanged = false;
 };
+
+///! Parser that filters delimited data before it reaches QML.
+/// A [SplitParser](../splitparser) that only emits [read()] for chunks matching its filters,
+/// and can optionally extract delimited fields from them.
+///
+/// Filtering happens before the data is converted into a string, so chunks that are
+/// dropped cost very little compared to filtering them in a `read` handler.
+///
+/// All set filters must match for a chunk to be forwarded.
+///
+/// ```qml
+/// Socket {
+///   path: "/path/to/socket"
+///   connected: true
+///
+///   parser: FilterParser {
+///     prefix: "workspace>>"
+///     fieldDelimiter: ">>"
+///     fields: [1]
+///     onRead: workspace => console.log(`switched to workspace ${workspace}`)
+///   }
+/// }
+/// ```
+///
+/// [read()]: ../datastreamparser#sig.read
+class FilterParser: public SplitParser {
+	Q_OBJECT;
+	// clang-format off
+	/// Only forward chunks starting with this string. Ignored if empty.
+	Q_PROPERTY(QString prefix READ prefix WRITE setPrefix NOTIFY prefixChanged);
+	/// Only forward chunks containing this string. Ignored if empty.
+	Q_PROPERTY(QString contains READ contains WRITE setContains NOTIFY containsChanged);
+	/// Only forward chunks matching this regular expression. Ignored if empty.
+	///
+	/// Matching a regular expression requires converting the chunk to a string,
+	/// so prefer `prefix` or `contains` to narrow down chunks first where possible.
+	Q_PROPERTY(QString pattern READ pattern WRITE setPattern NOTIFY patternChanged);
+	/// Forward the chunks that do *not* match the filters instead. Defaults to false.
+	Q_PROPERTY(bool invert READ invert WRITE setInvert NOTIFY invertChanged);
+	/// The delimiter between fields in a chunk. May be multiple characters.
+	/// If empty, no fields are extracted.
+	Q_PROPERTY(QString fieldDelimiter READ fieldDelimiter WRITE setFieldDelimiter NOTIFY fieldDelimiterChanged);
+	/// Indexes of the fields to extract, starting at 0. Negative indexes count from the end.
+	/// Fields that do not exist are empty.
+	///
+	/// When set along with `fieldDelimiter`, [read()] will be emitted with only the
+	/// selected fields, joined by the delimiter.
+	Q_PROPERTY(QList<qint32> fields READ fields WRITE setFields NOTIFY fieldsChanged);
+	/// The number of chunks forwarded since the counters were last reset.
+	Q_PROPERTY(qint64 forwarded READ forwarded NOTIFY countersChanged);
+	/// The number of chunks dropped since the counters were last reset.
+	Q_PROPERTY(qint64 dropped READ dropped NOTIFY countersChanged);
+	// clang-format on
+	QML_ELEMENT;
+
+public:
+	explicit FilterParser(QObject* parent = nullptr): SplitParser(parent) {}
+
+	void parseBytes(QByteArray& incoming, QByteArray& buffer) override;
+
+	/// Reset `forwarded` and `dropped` to 0.
+	Q_INVOKABLE void resetCounters();
+
+	[[nodiscard]] QString prefix() const;
+	void setPrefix(QString prefix);
+
+	[[nodiscard]] QString contains() const;
+	void setContains(QString contains);
+
+	[[nodiscard]] QString pattern() const;
+	void setPattern(const QString& pattern);
+
+	[[nodiscard]] bool invert() const;
+	void setInvert(bool invert);
+
+	[[nodiscard]] QString fieldDelimiter() const;
+	void setFieldDelimiter(QString fieldDelimiter);
+
+	[[nodiscard]] QList<qint32> fields() const;
+	void setFields(QList<qint32> fields);
+
+	[[nodiscard]] qint64 forwarded() const;
+	[[nodiscard]] qint64 dropped() const;
+
+signals:
+	/// Emitted alongside [read()] when `fieldDelimiter` is set, with the selected
+	/// fields, or every field if `fields` is empty.
+	///
+	/// [read()]: ../datastreamparser#sig.read
+	void readFields(QList<QString> fields);
+
+	void prefixChanged();
+	void containsChanged();
+	void patternChanged();
+	void invertChanged();
+	void fieldDelimiterChanged();
+	void fieldsChanged();
+	void countersChanged();
+
+protected:
+	void onRecord(const QByteArray& record) override;
+
+private:
+	[[nodiscard]] QList<QByteArray> extractFields(const QByteArray& record) const;
+
+	QString mPrefix;
+	QString mContains;
+	QString mFieldDelimiter;
+	QList<qint32> mFields;
+	bool mInvert = false;
+	QRegularExpression regex;
+
+	// utf8 encoded copies so chunks can be matched without decoding them
+	QByteArray prefixBytes;
+	QByteArray containsBytes;
+	QByteArray delimiterBytes;
+
+	qint64 mForwarded = 0;
+	qint64 mDropped = 0;
+	bool countersDirty = false;
+};
+
+///! Parser that hands the same stream to multiple parsers.
+/// Parser that hands every chunk of the stream to each of its child parsers, allowing
+/// a single source to be consumed in several ways without reading it more than once.
+///
+/// Each child parser keeps its own partially parsed data, and the chunks themselves
+/// are shared between parsers rather than copied.
+///
+/// ```qml
+/// Process {
+///   command: ["some-command"]
+///   running: true
+///
+///   stdout: FanoutParser {
+///     SplitParser {
+///       onRead: line => console.log(`line: ${line}`)
+///     }
+///
+///     SplitParser {
+///       splitMarker: ""
+///       onRead: data => buffer += data
+///     }
+///   }
+/// }
+/// ```
+class FanoutParser: public DataStreamParser {
+	Q_OBJECT;
+	/// The parsers data is handed to, in order.
+	Q_PROPERTY(QQmlListProperty<DataStreamParser> parsers READ parsers NOTIFY parsersChanged);
+	Q_CLASSINFO("DefaultProperty", "parsers");
+	QML_ELEMENT;
+
+public:
+	explicit FanoutParser(QObject* parent = nullptr): DataStreamParser(parent) {}
+
+	void parseBytes(QByteArray& incoming, QByteArray& buffer) override;
+
+	[[nodiscard]] QQmlListProperty<DataStreamParser> parsers();
+
+signals:
+	void parsersChanged();
+
+private slots:
+	void onParserDestroyed(QObject* object);
+
+private:
+	static void parsersAppend(QQmlListProperty<DataStreamParser>* prop, DataStreamParser* parser);
+	static DataStreamParser* parserAt(QQmlListProperty<DataStreamParser>* prop, qsizetype i);
+	static void parsersClear(QQmlListProperty<DataStreamParser>* prop);
+	static qsizetype parsersCount(QQmlListProperty<DataStreamParser>* prop);
+
+	// -1 if the parser is not a branch of this parser
+	[[nodiscard]] qsizetype branchIndex(DataStreamParser* parser) const;
+
+	struct Branch {
+		DataStreamParser* parser = nullptr;
+		QByteArray buffer;
+	};
+
+	QList<Branch> branches;
+};
@@ -1,10 +1,17 @@
 #include "../core/plugin.hpp"
+#include "datafile.hpp"
 #include "process.hpp"
 
 namespace {
 
 class IoPlugin: public QuickshellPlugin {
-	void onReload() override { DisownedProcessContext::destroyInstance(); }
+	void onReload() override {
+		DisownedProcessContext::destroyInstance();
+		// picks up changes to quickshell's own environment
+		Process::invalidateSystemEnvironment();
+		// files still referenced by the new generation are kept
+		DataFileCache::instance()->collect();
+	}
 };
 
 QS_REGISTER_PLUGIN(IoPlugin);
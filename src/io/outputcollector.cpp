@@ -0,0 +1,197 @@
+#include "outputcollector.hpp"
+#include <algorithm>
+#include <utility>
+
+#include <qabstractitemmodel.h>
+#include <qbytearray.h>
+#include <qhash.h>
+#include <qlist.h>
+#include <qobject.h>
+#include <qtmetamacros.h>
+#include <qtypes.h>
+#include <qvariant.h>
+
+#include "datastream.hpp"
+
+OutputLineModel::OutputLineModel(OutputCollector* collector)
+    : QAbstractListModel(collector)
+    , collector(collector) {}
+
+qint32 OutputLineModel::rowCount(const QModelIndex& parent) const {
+	if (parent.isValid()) return 0;
+	return this->collector->count();
+}
+
+QVariant OutputLineModel::data(const QModelIndex& index, qint32 role) const {
+	if (!index.isValid() || index.row() >= this->collector->count()) return QVariant();
+	if (role != LineRole && role != Qt::DisplayRole) return QVariant();
+	return this->collector->lineAt(index.row());
+}
+
+QHash<qint32, QByteArray> OutputLineModel::roleNames() const { return {{LineRole, "line"}}; }
+
+OutputCollector::OutputCollector(QObject* parent)
+    : SplitParser(parent)
+    , mModel(new OutputLineModel(this)) {}
+
+void OutputCollector::parseBytes(QByteArray& incoming, QByteArray& buffer) {
+	this->SplitParser::parseBytes(incoming, buffer);
+	this->flush();
+}
+
+void OutputCollector::onRecord(const QByteArray& record) {
+	auto size = record.size();
+
+	if (this->fullCapture() && this->mBytes + this->incomingBytes + size > this->mMemoryLimit) {
+		this->mDropped++;
+		return;
+	}
+
+	auto line = Line {.text = QString(record), .bytes = size};
+	this->incomingBytes += size;
+	this->incoming.append(line);
+
+	emit this->read(line.text);
+}
+
+bool OutputCollector::fullCapture() const { return this->mMaxLines == 0 && this->mMaxBytes == 0; }
+
+void OutputCollector::flush() {
+	auto droppedBefore = this->mDropped;
+
+	if (!this->incoming.isEmpty()) {
+		// lines that would be dropped as soon as they were added never reach the model
+		qsizetype skip = 0;
+		auto skipBytes = this->incomingBytes;
+
+		for (; skip != this->incoming.length(); skip++) {
+			auto linesFit = this->mMaxLines == 0 || this->incoming.length() - skip <= this->mMaxLines;
+			auto bytesFit = this->mMaxBytes == 0 || skipBytes <= this->mMaxBytes;
+			if (linesFit && bytesFit) break;
+			skipBytes -= this->incoming.at(skip).bytes;
+		}
+
+		if (skip != 0) {
+			this->incoming.remove(0, skip);
+			this->incomingBytes = skipBytes;
+			this->mDropped += skip;
+		}
+	}
+
+	if (!this->incoming.isEmpty()) {
+		this->trim(this->incoming.length(), this->incomingBytes);
+
+		auto first = static_cast<qint32>(this->lines.length());
+		auto last = static_cast<qint32>(first + this->incoming.length() - 1);
+
+		this->mModel->beginInsertRows(QModelIndex(), first, last);
+		this->lines.append(std::exchange(this->incoming, {}));
+		this->mBytes += std::exchange(this->incomingBytes, 0);
+		this->mModel->endInsertRows();
+
+		emit this->countChanged();
+	}
+
+	if (this->mDropped != droppedBefore) emit this->droppedChanged();
+}
+
+void OutputCollector::trim(qsizetype incomingLines, qint64 incomingBytes) {
+	if (this->fullCapture()) return;
+
+	qsizetype remove = 0;
+	qint64 removeBytes = 0;
+
+	for (; remove != this->lines.length(); remove++) {
+		auto lineCount = this->lines.length() - remove + incomingLines;
+		auto byteCount = this->mBytes - removeBytes + incomingBytes;
+
+		auto linesFit = this->mMaxLines == 0 || lineCount <= this->mMaxLines;
+		auto bytesFit = this->mMaxBytes == 0 || byteCount <= this->mMaxBytes;
+		if (linesFit && bytesFit) break;
+
+		removeBytes += this->lines.at(remove).bytes;
+	}
+
+	if (remove == 0) return;
+
+	this->mModel->beginRemoveRows(QModelIndex(), 0, static_cast<qint32>(remove - 1));
+	// QList keeps free space at the front, making this cheap like a ring buffer
+	this->lines.remove(0, remove);
+	this->mBytes -= removeBytes;
+	this->mModel->endRemoveRows();
+
+	this->mDropped += remove;
+}
+
+QString OutputCollector::text() const {
+	QString text;
+	text.reserve(this->mBytes + this->lines.length());
+
+	for (const auto& line: this->lines) {
+		if (!text.isEmpty()) text.append('\n');
+		text.append(line.text);
+	}
+
+	return text;
+}
+
+void OutputCollector::clear() {
+	if (!this->lines.isEmpty()) {
+		this->mModel->beginResetModel();
+		this->lines.clear();
+		this->mBytes = 0;
+		this->mModel->endResetModel();
+		emit this->countChanged();
+	}
+
+	if (this->mDropped != 0) {
+		this->mDropped = 0;
+		emit this->droppedChanged();
+	}
+}
+
+QString OutputCollector::lineAt(qsizetype index) const { return this->lines.at(index).text; }
+
+qint32 OutputCollector::maxLines() const { return this->mMaxLines; }
+
+void OutputCollector::setMaxLines(qint32 maxLines) {
+	maxLines = std::max(maxLines, 0);
+	if (maxLines == this->mMaxLines) return;
+	this->mMaxLines = maxLines;
+	emit this->maxLinesChanged();
+	this->applyLimits();
+}
+
+qint64 OutputCollector::maxBytes() const { return this->mMaxBytes; }
+
+void OutputCollector::setMaxBytes(qint64 maxBytes) {
+	maxBytes = std::max(maxBytes, static_cast<qint64>(0));
+	if (maxBytes == this->mMaxBytes) return;
+	this->mMaxBytes = maxBytes;
+	emit this->maxBytesChanged();
+	this->applyLimits();
+}
+
+qint64 OutputCollector::memoryLimit() const { return this->mMemoryLimit; }
+
+void OutputCollector::setMemoryLimit(qint64 memoryLimit) {
+	memoryLimit = std::max(memoryLimit, static_cast<qint64>(0));
+	if (memoryLimit == this->mMemoryLimit) return;
+	this->mMemoryLimit = memoryLimit;
+	emit this->memoryLimitChanged();
+}
+
+void OutputCollector::applyLimits() {
+	auto droppedBefore = this->mDropped;
+	auto countBefore = this->lines.length();
+
+	this->trim(0, 0);
+
+	if (this->lines.length() != countBefore) emit this->countChanged();
+	if (this->mDropped != droppedBefore) emit this->droppedChanged();
+}
+
+OutputLineModel* OutputCollector::model() const { return this->mModel; }
+qint32 OutputCollector::count() const { return static_cast<qint32>(this->lines.length()); }
+qint64 OutputCollector::bytes() const { return this->mBytes; }
+qint64 OutputCollector::dropped() const { return this->mDropped; }
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <qabstractitemmodel.h>
+#include <qbytearray.h>
+#include <qhash.h>
+#include <qlist.h>
+#include <qobject.h>
+#include <qqmlintegration.h>
+#include <qtclasshelpermacros.h>
+#include <qtmetamacros.h>
+#include <qtypes.h>
+#include <qvariant.h>
+
+#include "datastream.hpp"
+
+class OutputCollector;
+
+///! List model of lines captured by an OutputCollector.
+/// Each row has a single `line` role.
+class OutputLineModel: public QAbstractListModel {
+	Q_OBJECT;
+	QML_ELEMENT;
+	QML_UNCREATABLE("OutputLineModel can only be acquired from OutputCollector");
+
+public:
+	explicit OutputLineModel(OutputCollector* collector);
+
+	enum Roles {
+		LineRole = Qt::UserRole,
+	};
+
+	[[nodiscard]] qint32 rowCount(const QModelIndex& parent = QModelIndex()) const override;
+	[[nodiscard]] QVariant data(const QModelIndex& index, qint32 role = Qt::DisplayRole) const override;
+	[[nodiscard]] QHash<qint32, QByteArray> roleNames() const override;
+
+private:
+	OutputCollector* collector;
+
+	friend class OutputCollector;
+};
+
+///! Parser that keeps the most recent output of a stream.
+/// A [SplitParser](../splitparser) that stores the chunks it reads, keeping at most
+/// [maxLines](#prop.maxLines) chunks and [maxBytes](#prop.maxBytes) bytes by dropping the oldest
+/// ones, so chatty commands can be displayed without building strings in javascript.
+///
+/// If both limits are 0 all output is kept until [memoryLimit](#prop.memoryLimit) is reached,
+/// after which new output is discarded.
+///
+/// #### Example
+/// ```qml
+/// Process {
+///   command: [ "journalctl", "-f" ]
+///   running: true
+///   stdout: OutputCollector { id: log; maxLines: 500 }
+/// }
+///
+/// ListView {
+///   model: log.model
+///   delegate: Text { required property string line; text: line }
+/// }
+/// ```
+class OutputCollector: public SplitParser {
+	Q_OBJECT;
+	// clang-format off
+	/// The maximum number of lines to keep. Defaults to 1000. If 0, lines are not limited by count.
+	Q_PROPERTY(qint32 maxLines READ maxLines WRITE setMaxLines NOTIFY maxLinesChanged);
+	/// The maximum number of bytes to keep. Defaults to 0. If 0, lines are not limited by size.
+	Q_PROPERTY(qint64 maxBytes READ maxBytes WRITE setMaxBytes NOTIFY maxBytesChanged);
+	/// The maximum number of bytes kept when both `maxLines` and `maxBytes` are 0.
+	/// Defaults to 16MiB.
+	Q_PROPERTY(qint64 memoryLimit READ memoryLimit WRITE setMemoryLimit NOTIFY memoryLimitChanged);
+	/// The captured lines as a list model.
+	Q_PROPERTY(OutputLineModel* model READ model CONSTANT);
+	/// The number of lines currently kept.
+	Q_PROPERTY(qint32 count READ count NOTIFY countChanged);
+	/// The size in bytes of the lines currently kept.
+	Q_PROPERTY(qint64 bytes READ bytes NOTIFY countChanged);
+	/// The number of lines dropped or discarded due to the limits since the last [clear](#func.clear).
+	Q_PROPERTY(qint64 dropped READ dropped NOTIFY droppedChanged);
+	// clang-format on
+	QML_ELEMENT;
+
+public:
+	explicit OutputCollector(QObject* parent = nullptr);
+
+	void parseBytes(QByteArray& incoming, QByteArray& buffer) override;
+
+	/// Returns every kept line, joined by newlines.
+	Q_INVOKABLE [[nodiscard]] QString text() const;
+	/// Removes every kept line.
+	Q_INVOKABLE void clear();
+
+	[[nodiscard]] QString lineAt(qsizetype index) const;
+
+	[[nodiscard]] qint32 maxLines() const;
+	void setMaxLines(qint32 maxLines);
+
+	[[nodiscard]] qint64 maxBytes() const;
+	void setMaxBytes(qint64 maxBytes);
+
+	[[nodiscard]] qint64 memoryLimit() const;
+	void setMemoryLimit(qint64 memoryLimit);
+
+	[[nodiscard]] OutputLineModel* model() const;
+	[[nodiscard]] qint32 count() const;
+	[[nodiscard]] qint64 bytes() const;
+	[[nodiscard]] qint64 dropped() const;
+
+signals:
+	void maxLinesChanged();
+	void maxBytesChanged();
+	void memoryLimitChanged();
+	void countChanged();
+	void droppedChanged();
+
+protected:
+	void onRecord(const QByteArray& record) override;
+
+private:
+	struct Line {
+		QString text;
+		qsizetype bytes = 0;
+	};
+
+	// applies lines collected during the last read to the model in one batch
+	void flush();
+	// drops the oldest lines so incoming lines will fit within the limits
+	void trim(qsizetype incomingLines, qint64 incomingBytes);
+	void applyLimits();
+	[[nodiscard]] bool fullCapture() const;
+
+	qint32 mMaxLines = 1000;
+	qint64 mMaxBytes = 0;
+	qint64 mMemoryLimit = 16 * 1024 * 1024;
+
+	OutputLineModel* mModel;
+	QList<Line> lines;
+	QList<Line> incoming;
+	qint64 mBytes = 0;
+	qint64 incomingBytes = 0;
+	qint64 mDropped = 0;
+};
@@ -0,0 +1,231 @@
+#include "pipeline.hpp"
+#include <utility>
+
+#include <qdir.h>
+#include <qlist.h>
+#include <qlogging.h>
+#include <qobject.h>
+#include <qprocess.h>
+#include <qtmetamacros.h>
+#include <qtypes.h>
+#include <qvariant.h>
+
+#include "datastream.hpp"
+#include "process.hpp"
+
+ProcessPipeline::~ProcessPipeline() {
+	// the stages are killed when destroyed along with this object
+	for (auto* stage: this->stages) {
+		QObject::disconnect(stage, nullptr, this, nullptr);
+	}
+}
+
+bool ProcessPipeline::isRunning() const { return !this->stages.isEmpty(); }
+
+void ProcessPipeline::setRunning(bool running) {
+	this->targetRunning = running;
+	if (running) this->startPipelineIfReady();
+	else {
+		for (auto* stage: this->stages) {
+			if (stage->state() != QProcess::NotRunning) stage->terminate();
+		}
+	}
+}
+
+QList<QVariant> ProcessPipeline::commands() const { return this->mCommands; }
+
+void ProcessPipeline::setCommands(QList<QVariant> commands) {
+	if (commands == this->mCommands) return;
+	this->mCommands = std::move(commands);
+	emit this->commandsChanged();
+
+	this->startPipelineIfReady();
+}
+
+QString ProcessPipeline::workingDirectory() const {
+	if (this->mWorkingDirectory.isEmpty()) return QDir::current().absolutePath();
+	else return this->mWorkingDirectory;
+}
+
+void ProcessPipeline::setWorkingDirectory(const QString& workingDirectory) {
+	auto absolute =
+	    workingDirectory.isEmpty() ? workingDirectory : QDir(workingDirectory).absolutePath();
+	if (absolute == this->mWorkingDirectory) return;
+	this->mWorkingDirectory = absolute;
+	emit this->workingDirectoryChanged();
+}
+
+DataStreamParser* ProcessPipeline::stdoutParser() const { return this->mStdoutParser; }
+
+void ProcessPipeline::setStdoutParser(DataStreamParser* parser) {
+	if (parser == this->mStdoutParser) return;
+
+	if (this->mStdoutParser != nullptr) {
+		QObject::disconnect(this->mStdoutParser, nullptr, this, nullptr);
+
+		if (!this->stages.isEmpty()) {
+			auto* last = this->stages.last();
+			last->closeReadChannel(QProcess::StandardOutput);
+			last->readAllStandardOutput(); // discard
+			this->stdoutBuffer.clear();
+		}
+	}
+
+	this->mStdoutParser = parser;
+
+	if (parser != nullptr) {
+		QObject::connect(
+		    parser,
+		    &QObject::destroyed,
+		    this,
+		    &ProcessPipeline::onStdoutParserDestroyed
+		);
+	}
+
+	emit this->stdoutParserChanged();
+
+	if (parser != nullptr && !this->stdoutBuffer.isEmpty()) {
+		parser->parseBytes(this->stdoutBuffer, this->stdoutBuffer);
+	}
+}
+
+void ProcessPipeline::onStdoutParserDestroyed() {
+	this->mStdoutParser = nullptr;
+	emit this->stdoutParserChanged();
+}
+
+QList<qint32> ProcessPipeline::exitCodes() const { return this->mExitCodes; }
+
+void ProcessPipeline::startPipelineIfReady() {
+	if (!this->stages.isEmpty() || !this->targetRunning || this->mCommands.isEmpty()) return;
+
+	auto commands = QList<QList<QString>>();
+	commands.reserve(this->mCommands.length());
+
+	for (const auto& command: this->mCommands) {
+		auto list = command.toStringList();
+
+		if (list.isEmpty()) {
+			qWarning() << "ProcessPipeline has an empty stage, not starting. Commands:"
+			           << this->mCommands;
+			return;
+		}
+
+		commands.append(list);
+	}
+
+	this->targetRunning = false;
+	this->stdoutBuffer.clear();
+	this->mExitCodes = QList<qint32>(commands.length(), -1);
+
+	QProcess* previous = nullptr;
+	for (const auto& command: commands) {
+		auto* stage = new QProcess(this);
+
+		// clang-format off
+		QObject::connect(stage, &QProcess::finished, this, &ProcessPipeline::onStageFinished);
+		QObject::connect(stage, &QProcess::errorOccurred, this, &ProcessPipeline::onStageErrorOccurred);
+		// clang-format on
+
+		stage->setStandardErrorFile(QProcess::nullDevice());
+
+		if (!this->mWorkingDirectory.isEmpty()) {
+			stage->setWorkingDirectory(this->mWorkingDirectory);
+		}
+
+		// the pipe is set up by QProcess when both ends are started,
+		// and data between stages never passes through this process
+		if (previous != nullptr) previous->setStandardOutputProcess(stage);
+		else stage->setStandardInputFile(QProcess::nullDevice());
+
+		this->stages.append(stage);
+		previous = stage;
+	}
+
+	auto* last = this->stages.last();
+	QObject::connect(
+	    last,
+	    &QProcess::readyReadStandardOutput,
+	    this,
+	    &ProcessPipeline::onStdoutReadyRead
+	);
+
+	// as with Process, no pipe is created for output nothing will read
+	if (this->mStdoutParser == nullptr) last->setStandardOutputFile(QProcess::nullDevice());
+
+	this->runningStages = this->stages.length();
+
+	// stages may fail synchronously, the pipeline exiting is reported after started
+	this->starting = true;
+	for (qsizetype i = 0; i < this->stages.length(); i++) {
+		this->stages.at(i)->start(commands.at(i).first(), commands.at(i).sliced(1));
+	}
+	this->starting = false;
+
+	emit this->exitCodesChanged();
+	emit this->runningChanged();
+	emit this->started();
+
+	if (this->runningStages == 0) this->finishPipeline();
+}
+
+void ProcessPipeline::onStageFinished(qint32 exitCode, QProcess::ExitStatus exitStatus) {
+	// keeps the usage of this stage from being attributed to the next Process
+	ProcessUsage::takeReapedChildUsage();
+
+	auto index = this->stages.indexOf(qobject_cast<QProcess*>(this->sender()));
+	if (index == -1) return;
+	this->finishStage(index, exitCode, exitStatus);
+}
+
+void ProcessPipeline::onStageErrorOccurred(QProcess::ProcessError error) {
+	auto index = this->stages.indexOf(qobject_cast<QProcess*>(this->sender()));
+	if (index == -1) return;
+
+	if (error == QProcess::FailedToStart) { // other cases should be covered by other events
+		qWarning() << "ProcessPipeline stage" << index
+		           << "failed to start, likely because the binary could not be found. Command:"
+		           << this->mCommands.value(index);
+
+		// finished will not be emitted for this stage
+		this->finishStage(index, -1, QProcess::CrashExit);
+	}
+}
+
+void ProcessPipeline::finishStage(
+    qsizetype index,
+    qint32 exitCode,
+    QProcess::ExitStatus exitStatus
+) {
+	if (exitStatus == QProcess::NormalExit) {
+		this->mExitCodes[index] = exitCode;
+		emit this->exitCodesChanged();
+	}
+
+	emit this->stageExited(static_cast<qint32>(index), exitCode, exitStatus);
+
+	if (--this->runningStages != 0 || this->starting) return;
+	this->finishPipeline();
+}
+
+void ProcessPipeline::finishPipeline() {
+	for (auto* stage: this->stages) {
+		QObject::disconnect(stage, nullptr, this, nullptr);
+		stage->deleteLater();
+	}
+
+	this->stages.clear();
+	this->stdoutBuffer.clear();
+
+	emit this->exited(this->mExitCodes);
+	emit this->runningChanged();
+
+	// running was set again while the last run was in flight
+	this->startPipelineIfReady();
+}
+
+void ProcessPipeline::onStdoutReadyRead() {
+	if (this->mStdoutParser == nullptr || this->stages.isEmpty()) return;
+	auto buf = this->stages.last()->readAllStandardOutput();
+	this->mStdoutParser->parseBytes(buf, this->stdoutBuffer);
+}
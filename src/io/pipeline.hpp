@@ -0,0 +1,127 @@
+#pragma once
+
+#include <qbytearray.h>
+#include <qcontainerfwd.h>
+#include <qlist.h>
+#include <qobject.h>
+#include <qprocess.h>
+#include <qqmlintegration.h>
+#include <qtclasshelpermacros.h>
+#include <qtmetamacros.h>
+#include <qtypes.h>
+#include <qvariant.h>
+
+#include "datastream.hpp"
+
+///! Chain of processes connected by pipes.
+/// Runs multiple commands with the standard output of each connected to the standard input
+/// of the next, like a shell pipeline, but without starting a shell.
+///
+/// Data passes between stages through pipes directly and is never read by quickshell.
+/// Only the last stage's output is read, into the [stdout](#prop.stdout) parser.
+///
+/// #### Example
+/// ```qml
+/// // equivalent to `sh -c "pactl subscribe | grep --line-buffered sink"`
+/// ProcessPipeline {
+///   running: true
+///   commands: [
+///     [ "pactl", "subscribe" ],
+///     [ "grep", "--line-buffered", "sink" ],
+///   ]
+///   stdout: SplitParser {
+///     onRead: data => console.log(`sink event: ${data}`)
+///   }
+/// }
+/// ```
+class ProcessPipeline: public QObject {
+	Q_OBJECT;
+	// clang-format off
+	/// If the pipeline is currently running. Defaults to false.
+	///
+	/// Setting this property to true will start every stage if `commands` is not empty.
+	/// Setting it to false will send SIGTERM to every stage that is still running.
+	/// Setting it to true while the pipeline is running will start it again once every
+	/// stage has exited.
+	///
+	/// The pipeline is considered running until every stage has exited.
+	Q_PROPERTY(bool running READ isRunning WRITE setRunning NOTIFY runningChanged);
+	/// The commands to execute, one list of arguments per stage. See [Process.command]
+	/// for details.
+	///
+	/// If the pipeline is already running changing this property will affect the next
+	/// started pipeline.
+	///
+	/// [Process.command]: ../process#prop.command
+	Q_PROPERTY(QList<QVariant> commands READ commands WRITE setCommands NOTIFY commandsChanged);
+	/// The working directory of every stage. Defaults to [quickshell's working directory].
+	///
+	/// If the pipeline is already running changing this property will affect the next
+	/// started pipeline.
+	///
+	/// [quickshell's working directory]: ../../quickshell/quickshell#prop.workingDirectory
+	Q_PROPERTY(QString workingDirectory READ workingDirectory WRITE setWorkingDirectory NOTIFY workingDirectoryChanged);
+	/// The parser for the last stage's stdout. If the parser is null the output will be discarded.
+	///
+	/// The stderr of every stage is discarded.
+	Q_PROPERTY(DataStreamParser* stdout READ stdoutParser WRITE setStdoutParser NOTIFY stdoutParserChanged);
+	/// The exit code of each stage from the last run, or -1 for stages that crashed,
+	/// failed to start, or have not exited yet.
+	Q_PROPERTY(QList<qint32> exitCodes READ exitCodes NOTIFY exitCodesChanged);
+	// clang-format on
+	QML_ELEMENT;
+
+public:
+	explicit ProcessPipeline(QObject* parent = nullptr): QObject(parent) {}
+	~ProcessPipeline() override;
+	Q_DISABLE_COPY_MOVE(ProcessPipeline);
+
+	[[nodiscard]] bool isRunning() const;
+	void setRunning(bool running);
+
+	[[nodiscard]] QList<QVariant> commands() const;
+	void setCommands(QList<QVariant> commands);
+
+	[[nodiscard]] QString workingDirectory() const;
+	void setWorkingDirectory(const QString& workingDirectory);
+
+	[[nodiscard]] DataStreamParser* stdoutParser() const;
+	void setStdoutParser(DataStreamParser* parser);
+
+	[[nodiscard]] QList<qint32> exitCodes() const;
+
+signals:
+	void started();
+	/// Emitted when a single stage exits.
+	void stageExited(qint32 stage, qint32 exitCode, QProcess::ExitStatus exitStatus);
+	/// Emitted once every stage has exited, with the exit code of each stage.
+	void exited(QList<qint32> exitCodes);
+
+	void runningChanged();
+	void commandsChanged();
+	void workingDirectoryChanged();
+	void stdoutParserChanged();
+	void exitCodesChanged();
+
+private slots:
+	void onStageFinished(qint32 exitCode, QProcess::ExitStatus exitStatus);
+	void onStageErrorOccurred(QProcess::ProcessError error);
+	void onStdoutReadyRead();
+	void onStdoutParserDestroyed();
+
+private:
+	void startPipelineIfReady();
+	void finishStage(qsizetype index, qint32 exitCode, QProcess::ExitStatus exitStatus);
+	void finishPipeline();
+
+	QList<QVariant> mCommands;
+	QString mWorkingDirectory;
+	DataStreamParser* mStdoutParser = nullptr;
+	QByteArray stdoutBuffer;
+
+	QList<QProcess*> stages;
+	QList<qint32> mExitCodes;
+	qsizetype runningStages = 0;
+	bool starting = false;
+	bool targetRunning = false;
+};
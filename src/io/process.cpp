@@ -1,8 +1,11 @@
 #include "process.hpp"
+#include <algorithm>
 #include <csignal> // NOLINT
 #include <utility>
 
 #include <qdir.h>
+#include <qelapsedtimer.h>
+#include <qhash.h>
 #include <qlist.h>
 #include <qlogging.h>
 #include <qmap.h>
@@ -11,6 +14,7 @@
 #include <qtmetamacros.h>
 #include <qtypes.h>
 #include <qvariant.h>
+#include <sys/resource.h>
 
 #include "../core/qmlglobal.hpp"
 #include "datastream.hpp"
@@ -19,6 +23,26 @@
 // meaning the destructor never runs and they are never killed.
 static DisownedProcessContext* disownedCtx; // NOLINT
 
+namespace {
+
+// QProcessEnvironment is implicitly shared, so every process shares this snapshot
+// until it modifies its own copy.
+QProcessEnvironment systemEnvironment; // NOLINT
+quint64 systemEnvironmentGeneration = 0; // NOLINT
+bool systemEnvironmentValid = false;     // NOLINT
+
+const QProcessEnvironment& sharedSystemEnvironment() {
+	if (!systemEnvironmentValid) {
+		systemEnvironment = QProcessEnvironment::systemEnvironment();
+		systemEnvironmentValid = true;
+		systemEnvironmentGeneration++;
+	}
+
+	return systemEnvironment;
+}
+
+} // namespace
+
 Process::Process(QObject* parent): QObject(parent) {
 	QObject::connect(
 	    QuickshellSettings::instance(),
@@ -31,7 +55,9 @@ Process::Process(QObject* parent): QObject(parent) {
 Process::~Process() {
 	if (!this->mLifetimeManaged && this->process != nullptr) {
 		if (disownedCtx == nullptr) disownedCtx = new DisownedProcessContext(); // NOLINT
+		QObject::disconnect(this->process, nullptr, this, nullptr);
 		disownedCtx->reparent(this->process);
+		this->process = nullptr;
 	}
 }
 
@@ -82,6 +108,7 @@ QMap<QString, QVariant> Process::environment() const { return this->mEnvironment
 void Process::setEnvironment(QMap<QString, QVariant> environment) {
 	if (environment == this->mEnvironment) return;
 	this->mEnvironment = std::move(environment);
+	this->environmentDirty = true;
 	emit this->environmentChanged();
 }
 
@@ -90,6 +117,7 @@ bool Process::environmentCleared() const { return this->mClearEnvironment; }
 void Process::setEnvironmentCleared(bool cleared) {
 	if (cleared == this->mClearEnvironment) return;
 	this->mClearEnvironment = cleared;
+	this->environmentDirty = true;
 	emit this->environmentClearChanged();
 }
 
@@ -186,6 +214,7 @@ void Process::startProcessIfReady() {
 
 	auto& cmd = this->mCommand.first();
 	auto args = this->mCommand.sliced(1);
+	this->runningCommand = this->mCommand;
 
 	this->process = new QProcess(this);
 
@@ -200,45 +229,79 @@ void Process::startProcessIfReady() {
 	this->stdoutBuffer.clear();
 	this->stderrBuffer.clear();
 
-	if (this->mStdoutParser == nullptr) this->process->closeReadChannel(QProcess::StandardOutput);
-	if (this->mStderrParser == nullptr) this->process->closeReadChannel(QProcess::StandardError);
-	if (!this->mStdinEnabled) this->process->closeWriteChannel();
+	// Unused channels are connected to the null device, so no pipe or notifier is created for
+	// them. This matters most for processes that outlive their Process with manageLifetime off.
+	if (this->mStdoutParser == nullptr) {
+		this->process->setStandardOutputFile(QProcess::nullDevice());
+	}
+
+	if (this->mStderrParser == nullptr) {
+		this->process->setStandardErrorFile(QProcess::nullDevice());
+	}
+
+	if (!this->mStdinEnabled) this->process->setStandardInputFile(QProcess::nullDevice());
 
 	if (!this->mWorkingDirectory.isEmpty()) {
 		this->process->setWorkingDirectory(this->mWorkingDirectory);
 	}
 
 	if (!this->mEnvironment.isEmpty() || this->mClearEnvironment) {
-		auto sysenv = QProcessEnvironment::systemEnvironment();
-		auto env = this->mClearEnvironment ? QProcessEnvironment() : sysenv;
-
-		for (auto& name: this->mEnvironment.keys()) {
-			auto value = this->mEnvironment.value(name);
-			if (!value.isValid()) continue;
-
-			if (this->mClearEnvironment) {
-				if (value.isNull()) {
-					if (sysenv.contains(name)) env.insert(name, sysenv.value(name));
-				} else env.insert(name, value.toString());
-			} else {
-				if (value.isNull()) env.remove(name);
-				else env.insert(name, value.toString());
-			}
-		}
-
-		this->process->setProcessEnvironment(env);
+		this->process->setProcessEnvironment(this->processEnvironment());
 	}
 
 	this->process->start(cmd, args);
 }
 
+QProcessEnvironment Process::processEnvironment() {
+	const auto& sysenv = sharedSystemEnvironment();
+
+	auto upToDate = this->cachedEnvironmentGeneration == systemEnvironmentGeneration;
+	if (!this->environmentDirty && upToDate) return this->cachedEnvironment;
+
+	auto env = this->mClearEnvironment ? QProcessEnvironment() : sysenv;
+
+	for (auto [name, value]: this->mEnvironment.asKeyValueRange()) {
+		if (!value.isValid()) continue;
+
+		if (this->mClearEnvironment) {
+			if (value.isNull()) {
+				if (sysenv.contains(name)) env.insert(name, sysenv.value(name));
+			} else env.insert(name, value.toString());
+		} else {
+			if (value.isNull()) env.remove(name);
+			else env.insert(name, value.toString());
+		}
+	}
+
+	this->cachedEnvironment = env;
+	this->cachedEnvironmentGeneration = systemEnvironmentGeneration;
+	this->environmentDirty = false;
+	return env;
+}
+
+void Process::invalidateSystemEnvironment() { systemEnvironmentValid = false; }
+
+ProcessUsage Process::usage() const { return this->mUsage; }
+
 void Process::onStarted() {
+	this->runTime.start();
 	emit this->processIdChanged();
 	emit this->runningChanged();
 	emit this->started();
 }
 
 void Process::onFinished(qint32 exitCode, QProcess::ExitStatus exitStatus) {
+	auto usage = ProcessUsage::takeReapedChildUsage();
+	usage.wallTime = this->runTime.isValid() ? this->runTime.elapsed() : 0;
+	this->runTime.invalidate();
+
+	ProcessStats::record(this->runningCommand, usage);
+
+	if (usage != this->mUsage) {
+		this->mUsage = usage;
+		emit this->usageChanged();
+	}
+
 	this->process->deleteLater();
 	this->process = nullptr;
 	this->stdoutBuffer.clear();
@@ -281,9 +344,92 @@ void Process::write(const QString& data) {
 	this->process->write(data.toUtf8());
 }
 
+namespace {
+
+rusage lastChildUsage {}; // NOLINT
+
+qint64 toMs(const timeval& time) { return time.tv_sec * 1000 + time.tv_usec / 1000; }
+
+QHash<QList<QString>, ProcessUsage> commandUsage; // NOLINT
+
+} // namespace
+
+ProcessUsage ProcessUsage::takeReapedChildUsage() {
+	rusage children {};
+	if (getrusage(RUSAGE_CHILDREN, &children) != 0) return ProcessUsage();
+
+	auto usage = ProcessUsage();
+	usage.userTime = toMs(children.ru_utime) - toMs(lastChildUsage.ru_utime);
+	usage.systemTime = toMs(children.ru_stime) - toMs(lastChildUsage.ru_stime);
+	usage.runs = 1;
+
+	lastChildUsage = children;
+	return usage;
+}
+
+ProcessUsage& ProcessUsage::operator+=(const ProcessUsage& other) {
+	this->userTime += other.userTime;
+	this->systemTime += other.systemTime;
+	this->wallTime += other.wallTime;
+	this->runs += other.runs;
+	return *this;
+}
+
+QList<QVariant> ProcessStats::commands() {
+	auto entries = commandUsage.asKeyValueRange();
+	auto sorted = QList<std::pair<QList<QString>, ProcessUsage>>(entries.begin(), entries.end());
+
+	std::ranges::sort(sorted, [](const auto& a, const auto& b) {
+		return a.second.userTime + a.second.systemTime > b.second.userTime + b.second.systemTime;
+	});
+
+	auto list = QList<QVariant>();
+	list.reserve(sorted.length());
+
+	for (const auto& [command, usage]: sorted) {
+		list.append(QVariantMap {
+		    {"command", QVariant::fromValue(command)},
+		    {"usage", QVariant::fromValue(usage)},
+		});
+	}
+
+	return list;
+}
+
+ProcessUsage ProcessStats::usageOf(const QList<QString>& command) {
+	return commandUsage.value(command);
+}
+
+void ProcessStats::reset() { commandUsage.clear(); }
+
+void ProcessStats::record(const QList<QString>& command, const ProcessUsage& usage) {
+	if (command.isEmpty()) return;
+	commandUsage[command] += usage;
+}
+
 void DisownedProcessContext::reparent(QProcess* process) {
+	// Nothing can write to the process anymore, closing stdin sends the child EOF and releases
+	// the pipe once pending writes are done. QProcess has no way to release read pipes early,
+	// closing them only discards incoming data until the child exits. Channels without a parser
+	// never had a pipe (see Process::startProcessIfReady). The QProcess itself is kept, as it
+	// owns reaping the child and would kill it if destroyed.
+	process->closeWriteChannel();
+	process->closeReadChannel(QProcess::StandardOutput);
+	process->closeReadChannel(QProcess::StandardError);
+	process->readAllStandardOutput(); // discard
+	process->readAllStandardError();  // discard
+
 	process->setParent(this);
-	QObject::connect(process, &QProcess::finished, this, [process]() { process->deleteLater(); });
+	QObject::connect(process, &QProcess::finished, this, &DisownedProcessContext::onProcessFinished);
+}
+
+void DisownedProcessContext::onProcessFinished() {
+	// keeps the usage of this child from being attributed to the next one
+	ProcessUsage::takeReapedChildUsage();
+
+	if (auto* process = qobject_cast<QProcess*>(this->sender())) {
+		process->deleteLater();
+	}
 }
 
 void DisownedProcessContext::destroyInstance() {
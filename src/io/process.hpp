@@ -1,6 +1,7 @@
 #pragma once
 
 #include <qcontainerfwd.h>
+#include <qelapsedtimer.h>
 #include <qobject.h>
 #include <qprocess.h>
 #include <qqmlintegration.h>
@@ -11,6 +12,39 @@
 
 #include "datastream.hpp"
 
+///! Resource usage of a child process.
+/// See [Process.usage](../process#prop.usage) and [ProcessStats](../processstats).
+///
+/// > [!WARNING] CPU times are approximate. The kernel only reports the total usage of every
+/// > child quickshell has reaped, so usage of children that exit without being measured,
+/// > such as processes killed on reload, is counted towards the next process to exit.
+class ProcessUsage {
+	Q_GADGET;
+	/// CPU time spent in user mode, in milliseconds.
+	Q_PROPERTY(qint64 userTime MEMBER userTime CONSTANT);
+	/// CPU time spent in the kernel, in milliseconds.
+	Q_PROPERTY(qint64 systemTime MEMBER systemTime CONSTANT);
+	/// Time between the process starting and exiting, in milliseconds.
+	Q_PROPERTY(qint64 wallTime MEMBER wallTime CONSTANT);
+	/// The number of runs this usage covers.
+	Q_PROPERTY(qint64 runs MEMBER runs CONSTANT);
+	QML_VALUE_TYPE(processUsage);
+
+public:
+	// Usage of children reaped since the last call. Qt emits QProcess::finished synchronously
+	// after reaping the child, so calling this from a finished handler measures that child,
+	// plus any child reaped without a call since.
+	static ProcessUsage takeReapedChildUsage();
+
+	ProcessUsage& operator+=(const ProcessUsage& other);
+	[[nodiscard]] bool operator==(const ProcessUsage& other) const = default;
+
+	qint64 userTime = 0;
+	qint64 systemTime = 0;
+	qint64 wallTime = 0;
+	qint64 runs = 0;
+};
+
 ///! Child process.
 /// #### Example
 /// ```qml
@@ -122,6 +156,10 @@ class Process: public QObject {
 	/// > [!WARNING] If set to false the process will still be killed if the quickshell config reloads.
 	/// > It will not be killed if quickshell exits normally or crashes.
 	Q_PROPERTY(bool manageLifetime READ isLifetimeManaged WRITE setLifetimeManaged NOTIFY lifetimeManagedChanged);
+	/// Resource usage of the last process that exited.
+	///
+	/// Usage for every command run is also accumulated in [ProcessStats](../processstats).
+	Q_PROPERTY(ProcessUsage usage READ usage NOTIFY usageChanged);
 	// clang-format on
 	QML_ELEMENT;
 
@@ -165,6 +203,12 @@ public:
 	[[nodiscard]] bool isLifetimeManaged() const;
 	void setLifetimeManaged(bool managed);
 
+	[[nodiscard]] ProcessUsage usage() const;
+
+	// Drops the cached copy of quickshell's environment, which is otherwise
+	// reused for every process with a custom environment.
+	static void invalidateSystemEnvironment();
+
 signals:
 	void started();
 	void exited(qint32 exitCode, QProcess::ExitStatus exitStatus);
@@ -179,6 +223,7 @@ signals:
 	void stderrParserChanged();
 	void stdinEnabledChanged();
 	void lifetimeManagedChanged();
+	void usageChanged();
 
 private slots:
 	void onStarted();
@@ -192,6 +237,7 @@ private slots:
 
 private:
 	void startProcessIfReady();
+	QProcessEnvironment processEnvironment();
 
 	QProcess* process = nullptr;
 	QList<QString> mCommand;
@@ -206,8 +252,46 @@ private:
 	bool mStdinEnabled = false;
 	bool mClearEnvironment = false;
 	bool mLifetimeManaged = true;
+
+	QList<QString> runningCommand;
+	QElapsedTimer runTime;
+	ProcessUsage mUsage;
+
+	// reused until environment, clearEnvironment or the system environment change
+	QProcessEnvironment cachedEnvironment;
+	quint64 cachedEnvironmentGeneration = 0;
+	bool environmentDirty = true;
+};
+
+///! Accumulated resource usage of every command run.
+/// Resource usage of processes started with [Process](../process), accumulated per command
+/// for the lifetime of quickshell. Useful for finding scripts that use more resources than expected.
+///
+/// ```qml
+/// for (const entry of ProcessStats.commands()) {
+///   console.log(`${entry.command.join(" ")}: ${entry.usage.runs} runs, ${entry.usage.userTime}ms`);
+/// }
+/// ```
+class ProcessStats: public QObject {
+	Q_OBJECT;
+	QML_SINGLETON;
+	QML_ELEMENT;
+
+public:
+	explicit ProcessStats(QObject* parent = nullptr): QObject(parent) {}
+
+	/// Returns an object with `command` and `usage` for every command that has exited,
+	/// sorted by total CPU time, highest first.
+	Q_INVOKABLE [[nodiscard]] static QList<QVariant> commands();
+	/// Returns the accumulated usage of the given command.
+	Q_INVOKABLE [[nodiscard]] static ProcessUsage usageOf(const QList<QString>& command);
+	/// Clear all accumulated usage.
+	Q_INVOKABLE static void reset();
+
+	static void record(const QList<QString>& command, const ProcessUsage& usage);
 };
 
+// Holds processes whose Process was destroyed with manageLifetime set to false until they exit.
 class DisownedProcessContext: public QObject {
 	Q_OBJECT;
 
@@ -216,4 +300,7 @@ class DisownedProcessContext: public QObject {
 
 public:
 	static void destroyInstance();
+
+private slots:
+	void onProcessFinished();
 };
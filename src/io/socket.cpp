@@ -1,20 +1,38 @@
 #include "socket.hpp"
+#include <algorithm>
 #include <utility>
 
+#include <qbytearray.h>
 #include <qfile.h>
+#include <qfileinfo.h>
+#include <qfilesystemwatcher.h>
+#include <qhash.h>
 #include <qlocalserver.h>
 #include <qlocalsocket.h>
 #include <qlogging.h>
 #include <qloggingcategory.h>
 #include <qobject.h>
+#include <qpointer.h>
 #include <qqmlcomponent.h>
 #include <qqmlengine.h>
+#include <qrandom.h>
+#include <qtimer.h>
 #include <qtmetamacros.h>
+#include <qtypes.h>
 
 #include "datastream.hpp"
 
 Q_LOGGING_CATEGORY(logSocket, "quickshell.io.socket", QtWarningMsg);
 
+Socket::Socket(QObject* parent): DataStream(parent) {
+	this->reconnectTimer.setSingleShot(true);
+	QObject::connect(&this->reconnectTimer, &QTimer::timeout, this, &Socket::onReconnectTimeout);
+}
+
+Socket::~Socket() {
+	if (this->sharedConnection != nullptr) this->sharedConnection->release(this);
+}
+
 void Socket::setSocket(QLocalSocket* socket) {
 	if (this->socket != nullptr) this->socket->deleteLater();
 	this->socket = socket;
@@ -40,7 +58,17 @@ void Socket::setPath(QString path) {
 	this->mPath = std::move(path);
 	emit this->pathChanged();
 
-	if (this->targetConnected && this->socket == nullptr) this->connectPathSocket();
+	// a new path gets a fresh set of attempts
+	this->stopReconnecting();
+	this->setReconnectAttempts(0);
+
+	// a shared connection is tied to its path
+	if (this->sharedConnection != nullptr) this->dropSocket();
+
+	auto* socket = this->activeSocket();
+	if (this->targetConnected && (socket == nullptr || !socket->isOpen())) {
+		this->connectPathSocket();
+	}
 }
 
 void Socket::onSocketConnected() {
@@ -48,60 +76,446 @@ void Socket::onSocketConnected() {
 	this->connected = true;
 	this->targetConnected = false;
 	this->disconnecting = false;
+	this->stopReconnecting();
+	this->setReconnectAttempts(0);
 	qCDebug(logSocket) << "Socket connected:" << this;
+
+	if (this->socket != nullptr && !this->pendingWrites.isEmpty()) {
+		this->socket->write(std::exchange(this->pendingWrites, {}));
+		this->socket->flush();
+	}
+
 	emit this->connectionStateChanged();
 }
 
 void Socket::onSocketDisconnected() {
 	qCDebug(logSocket) << "Socket disconnected:" << this;
+	auto requested = this->disconnecting;
 	this->connected = false;
 	this->disconnecting = false;
-	this->socket->deleteLater();
-	this->socket = nullptr;
+
+	// shared connections stay subscribed so they can be reopened
+	if (this->socket != nullptr) {
+		this->socket->deleteLater();
+		this->socket = nullptr;
+	}
+
 	this->buffer.clear();
+	this->pendingWrites.clear();
 	emit this->connectionStateChanged();
 
 	if (this->targetConnected) this->connectPathSocket();
+	else if (!requested && this->mAutoReconnect && this->keepConnected) this->scheduleReconnect();
 }
 
 void Socket::onSocketError(QLocalSocket::LocalSocketError error) {
-	qCWarning(logSocket) << "Socket error for" << this << error;
+	// any error before the connection is established means the attempt failed
+	auto connectFailed = !this->connected && this->activeSocket() != nullptr;
+
+	// failing to connect while reconnecting is expected, only warn about the first one
+	if (connectFailed && this->mReconnectAttempts != 0) {
+		qCDebug(logSocket) << "Reconnection attempt" << this->mReconnectAttempts << "failed for" << this
+		                   << error;
+	} else {
+		qCWarning(logSocket) << "Socket error for" << this << error;
+	}
+
 	emit this->error(error);
+
+	if (connectFailed && this->mAutoReconnect && this->keepConnected) this->scheduleReconnect();
 }
 
 bool Socket::isConnected() const { return this->connected; }
 
 void Socket::setConnected(bool connected) {
 	this->targetConnected = connected;
+	this->keepConnected = connected;
 
 	if (!connected) {
-		if (this->socket != nullptr && !this->disconnecting) {
+		this->stopReconnecting();
+
+		if (this->sharedConnection != nullptr) {
+			// other sockets may still be using the connection, so only this socket disconnects
+			auto wasConnected = this->connected;
+			this->dropSocket();
+
+			if (wasConnected) {
+				qCDebug(logSocket) << "Socket disconnected:" << this;
+				this->connected = false;
+				this->buffer.clear();
+				emit this->connectionStateChanged();
+			}
+		} else if (this->socket != nullptr && !this->socket->isOpen()) {
+			// a failed or pending connection attempt, which will not emit disconnected
+			this->dropSocket();
+		} else if (this->socket != nullptr && !this->disconnecting) {
 			this->disconnecting = true;
 			this->socket->disconnectFromServer();
 		}
-	} else if (this->socket == nullptr) this->connectPathSocket();
+	} else if (this->activeSocket() == nullptr
+	           || this->activeSocket()->state() == QLocalSocket::UnconnectedState)
+	{
+		this->connectPathSocket();
+	}
+}
+
+bool Socket::autoReconnect() const { return this->mAutoReconnect; }
+
+void Socket::setAutoReconnect(bool autoReconnect) {
+	if (autoReconnect == this->mAutoReconnect) return;
+	this->mAutoReconnect = autoReconnect;
+	emit this->autoReconnectChanged();
+
+	if (!autoReconnect) {
+		this->stopReconnecting();
+		return;
+	}
+
+	auto* socket = this->activeSocket();
+	auto idle = socket == nullptr || socket->state() == QLocalSocket::UnconnectedState;
+	if (this->keepConnected && idle) this->scheduleReconnect();
+}
+
+qint32 Socket::reconnectDelay() const { return this->mReconnectDelay; }
+
+void Socket::setReconnectDelay(qint32 reconnectDelay) {
+	reconnectDelay = std::max(reconnectDelay, 0);
+	if (reconnectDelay == this->mReconnectDelay) return;
+	this->mReconnectDelay = reconnectDelay;
+	emit this->reconnectDelayChanged();
+}
+
+qint32 Socket::maxReconnectDelay() const { return this->mMaxReconnectDelay; }
+
+void Socket::setMaxReconnectDelay(qint32 maxReconnectDelay) {
+	maxReconnectDelay = std::max(maxReconnectDelay, 0);
+	if (maxReconnectDelay == this->mMaxReconnectDelay) return;
+	this->mMaxReconnectDelay = maxReconnectDelay;
+	emit this->maxReconnectDelayChanged();
+}
+
+qint32 Socket::reconnectAttempts() const { return this->mReconnectAttempts; }
+
+void Socket::setReconnectAttempts(qint32 attempts) {
+	if (attempts == this->mReconnectAttempts) return;
+	this->mReconnectAttempts = attempts;
+	emit this->reconnectAttemptsChanged();
+}
+
+bool Socket::isShared() const { return this->mShared; }
+
+void Socket::setShared(bool shared) {
+	if (this->connected || shared == this->mShared) return;
+
+	// drop any pending attempt made in the previous mode
+	this->dropSocket();
+	this->mShared = shared;
+	emit this->sharedChanged();
+
+	if (this->targetConnected) this->connectPathSocket();
 }
 
 QIODevice* Socket::ioDevice() const { return this->socket; }
 
+QLocalSocket* Socket::activeSocket() const {
+	if (this->sharedConnection != nullptr) return this->sharedConnection->socket();
+	else return this->socket;
+}
+
 void Socket::connectPathSocket() {
-	if (!this->mPath.isEmpty()) {
+	if (this->mPath.isEmpty()) return;
+
+	if (this->mShared) {
+		if (this->sharedConnection == nullptr) {
+			this->sharedConnection = SharedSocketConnection::acquire(this->mPath, this);
+
+			// clang-format off
+			QObject::connect(this->sharedConnection, &SharedSocketConnection::connected, this, &Socket::onSocketConnected);
+			QObject::connect(this->sharedConnection, &SharedSocketConnection::disconnected, this, &Socket::onSocketDisconnected);
+			QObject::connect(this->sharedConnection, &SharedSocketConnection::errorOccurred, this, &Socket::onSocketError);
+			// clang-format on
+		}
+
+		if (this->sharedConnection->socket()->state() == QLocalSocket::ConnectedState) {
+			this->onSocketConnected();
+		} else {
+			this->sharedConnection->open();
+		}
+
+		return;
+	}
+
+	// reuse the socket left behind by a failed attempt instead of allocating a new one
+	if (this->socket == nullptr) {
 		auto* socket = new QLocalSocket();
-		socket->setServerName(this->mPath);
 		this->setSocket(socket);
-		this->socket->connectToServer(QIODevice::ReadWrite);
 	}
+
+	this->socket->setServerName(this->mPath);
+	this->socket->connectToServer(QIODevice::ReadWrite);
 }
 
-void Socket::write(const QString& data) {
+void Socket::dropSocket() {
+	this->pendingWrites.clear();
+
+	if (this->sharedConnection != nullptr) {
+		QObject::disconnect(this->sharedConnection, nullptr, this, nullptr);
+		this->sharedConnection->release(this);
+		this->sharedConnection = nullptr;
+	}
+
 	if (this->socket != nullptr) {
-		this->socket->write(data.toUtf8());
+		this->socket->deleteLater();
+		this->socket = nullptr;
+	}
+}
+
+void Socket::scheduleReconnect() {
+	if (this->mPath.isEmpty() || this->reconnectTimer.isActive()) return;
+
+	// nothing can accept a connection until the socket file exists, so wait for it to be
+	// created instead of polling. Falls back to polling if the directory can't be watched.
+	if (!QFileInfo::exists(this->mPath) && this->waitForSocketPath()) {
+		qCDebug(logSocket) << "Waiting for socket file" << this->mPath << "to be created for" << this;
+		return;
+	}
+
+	// exponential backoff, capped at maxReconnectDelay, with the upper half randomized so
+	// multiple clients don't reconnect in lockstep when a server restarts.
+	auto shift = std::min(this->mReconnectAttempts, 20);
+	auto delay = std::min(
+	    static_cast<qint64>(this->mReconnectDelay) << shift, // NOLINT
+	    static_cast<qint64>(this->mMaxReconnectDelay)
+	);
+
+	auto jitter = QRandomGenerator::global()->bounded(delay / 2 + 1);
+	auto interval = static_cast<qint32>(delay - delay / 2 + jitter);
+
+	qCDebug(logSocket) << "Reconnecting" << this << "in" << interval << "ms";
+	this->reconnectTimer.start(interval);
+}
+
+void Socket::stopReconnecting() {
+	this->reconnectTimer.stop();
+
+	if (this->pathWatcher != nullptr) {
+		this->pathWatcher->deleteLater();
+		this->pathWatcher = nullptr;
+	}
+}
+
+bool Socket::waitForSocketPath() {
+	auto dir = QFileInfo(this->mPath).absolutePath();
+
+	if (this->pathWatcher == nullptr) {
+		this->pathWatcher = new QFileSystemWatcher(this);
+
+		QObject::connect(
+		    this->pathWatcher,
+		    &QFileSystemWatcher::directoryChanged,
+		    this,
+		    &Socket::onSocketDirectoryChanged
+		);
+	}
+
+	if (this->pathWatcher->directories().contains(dir)) return true;
+	return this->pathWatcher->addPath(dir);
+}
+
+void Socket::onReconnectTimeout() {
+	if (!this->mAutoReconnect || !this->keepConnected || this->connected) return;
+	this->setReconnectAttempts(this->mReconnectAttempts + 1);
+	this->connectPathSocket();
+}
+
+void Socket::onSocketDirectoryChanged() {
+	if (!QFileInfo::exists(this->mPath)) return;
+
+	if (this->pathWatcher != nullptr) {
+		this->pathWatcher->deleteLater();
+		this->pathWatcher = nullptr;
+	}
+
+	this->onReconnectTimeout();
+}
+
+void Socket::write(const QString& data) { this->writeBytes(data.toUtf8()); }
+
+void Socket::writeBytes(const QByteArray& data) {
+	if (this->sharedConnection != nullptr) {
+		this->sharedConnection->write(data);
+	} else if (this->connected) {
+		this->socket->write(data);
+	} else if (this->socket != nullptr && !this->disconnecting) {
+		// sent once connected
+		this->pendingWrites.append(data);
 	}
 }
 
 void Socket::flush() {
-	if (this->socket != nullptr) {
-		this->socket->flush();
+	// pending writes are flushed when the connection is made
+	if (this->sharedConnection != nullptr) this->sharedConnection->flush();
+	else if (this->connected) this->socket->flush();
+}
+
+// Splits data once for every subscriber whose parser is a plain SplitParser with the same marker,
+// and hands each record to all of their parsers.
+class SharedRecordSplitter: public SplitParser {
+public:
+	explicit SharedRecordSplitter(const QString& marker, QObject* parent): SplitParser(parent) {
+		this->setSplitMarker(marker);
+	}
+
+	QList<QPointer<DataStreamParser>> targets;
+	QByteArray buffer;
+
+protected:
+	void onRecord(const QByteArray& record) override {
+		auto data = QString(record);
+
+		for (const auto& target: this->targets) {
+			if (target != nullptr) emit target->read(data);
+		}
+	}
+};
+
+namespace {
+
+QHash<QString, SharedSocketConnection*> sharedConnections; // NOLINT
+
+// Subclasses handle records in their own parseBytes and onRecord instead of emitting read,
+// so only exact SplitParsers can share records.
+SplitParser* plainSplitParser(DataStreamParser* parser) {
+	if (parser == nullptr) return nullptr;
+
+	// parsers declaring properties in qml get a generated metaobject on top of the c++ one
+	const auto* metaObject = parser->metaObject();
+	while (metaObject != nullptr && QByteArray(metaObject->className()).contains("_QML")) {
+		metaObject = metaObject->superClass();
+	}
+
+	if (metaObject != &SplitParser::staticMetaObject) return nullptr;
+	return static_cast<SplitParser*>(parser);
+}
+
+} // namespace
+
+SharedSocketConnection::SharedSocketConnection(QString path)
+    : path(std::move(path))
+    , mSocket(new QLocalSocket(this)) {
+	this->mSocket->setServerName(this->path);
+
+	// clang-format off
+	QObject::connect(this->mSocket, &QLocalSocket::connected, this, &SharedSocketConnection::onConnected);
+	QObject::connect(this->mSocket, &QLocalSocket::disconnected, this, &SharedSocketConnection::onDisconnected);
+	QObject::connect(this->mSocket, &QLocalSocket::errorOccurred, this, &SharedSocketConnection::onErrorOccurred);
+	QObject::connect(this->mSocket, &QLocalSocket::readyRead, this, &SharedSocketConnection::onReadyRead);
+	// clang-format on
+}
+
+SharedSocketConnection* SharedSocketConnection::acquire(const QString& path, Socket* subscriber) {
+	auto*& connection = sharedConnections[path];
+
+	if (connection == nullptr) {
+		qCDebug(logSocket) << "Creating shared connection to" << path;
+		connection = new SharedSocketConnection(path);
+	}
+
+	connection->subscribers.append(subscriber);
+	return connection;
+}
+
+void SharedSocketConnection::release(Socket* subscriber) {
+	this->subscribers.removeOne(subscriber);
+	if (!this->subscribers.isEmpty()) return;
+
+	qCDebug(logSocket) << "Closing unused shared connection to" << this->path;
+	sharedConnections.remove(this->path);
+
+	QObject::disconnect(this->mSocket, nullptr, this, nullptr);
+	this->mSocket->abort();
+
+	// may be called from one of this connection's signals
+	this->deleteLater();
+}
+
+void SharedSocketConnection::open() {
+	if (this->mSocket->state() != QLocalSocket::UnconnectedState) return;
+	this->mSocket->connectToServer(QIODevice::ReadWrite);
+}
+
+void SharedSocketConnection::write(const QByteArray& data) {
+	if (this->mSocket->state() == QLocalSocket::ConnectedState) this->mSocket->write(data);
+	else this->pendingWrites.append(data);
+}
+
+void SharedSocketConnection::flush() {
+	if (this->mSocket->state() == QLocalSocket::ConnectedState) this->mSocket->flush();
+}
+
+QLocalSocket* SharedSocketConnection::socket() const { return this->mSocket; }
+
+void SharedSocketConnection::onConnected() {
+	if (!this->pendingWrites.isEmpty()) {
+		this->mSocket->write(std::exchange(this->pendingWrites, {}));
+		this->mSocket->flush();
+	}
+
+	emit this->connected();
+}
+
+void SharedSocketConnection::onDisconnected() {
+	this->pendingWrites.clear();
+	emit this->disconnected();
+}
+
+void SharedSocketConnection::onErrorOccurred(QLocalSocket::LocalSocketError error) {
+	// writes for a connection that could not be made are dropped, as they would be unshared
+	if (this->mSocket->state() != QLocalSocket::ConnectedState) this->pendingWrites.clear();
+	emit this->errorOccurred(error);
+}
+
+void SharedSocketConnection::onReadyRead() {
+	auto bytes = this->mSocket->readAll();
+
+	// Handlers may connect or disconnect sockets, so the subscribers are grouped up front.
+	auto splitTargets = QHash<QString, QList<QPointer<DataStreamParser>>>();
+	auto rawTargets = QList<QPointer<Socket>>();
+
+	for (auto* socket: this->subscribers) {
+		if (!socket->isConnected() || socket->reader() == nullptr) continue;
+
+		if (auto* parser = plainSplitParser(socket->reader())) {
+			splitTargets[parser->splitMarker()].append(parser);
+		} else {
+			rawTargets.append(socket);
+		}
+	}
+
+	// markers no longer in use lose their partial record
+	for (auto iter = this->splitters.begin(); iter != this->splitters.end();) {
+		if (splitTargets.contains(iter.key())) {
+			iter++;
+		} else {
+			delete iter.value();
+			iter = this->splitters.erase(iter);
+		}
+	}
+
+	for (auto [marker, targets]: splitTargets.asKeyValueRange()) {
+		auto*& splitter = this->splitters[marker];
+		if (splitter == nullptr) splitter = new SharedRecordSplitter(marker, this);
+
+		splitter->targets = targets;
+		auto incoming = bytes;
+		splitter->parseBytes(incoming, splitter->buffer);
+		splitter->targets.clear();
+	}
+
+	for (const auto& socket: rawTargets) {
+		// implicitly shared, so no subscriber copies the data unless its parser modifies it
+		auto incoming = bytes;
+		if (socket != nullptr && socket->isConnected()) socket->streamBytes(incoming);
 	}
 }
 
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <qbytearray.h>
+#include <qfilesystemwatcher.h>
+#include <qhash.h>
+#include <qlist.h>
 #include <qlocalserver.h>
 #include <qlocalsocket.h>
 #include <qloggingcategory.h>
@@ -7,16 +11,22 @@
 #include <qqmlcomponent.h>
 #include <qqmlintegration.h>
 #include <qtclasshelpermacros.h>
+#include <qtimer.h>
 #include <qtmetamacros.h>
+#include <qtypes.h>
 
 #include "../core/reload.hpp"
 #include "datastream.hpp"
 
 Q_DECLARE_LOGGING_CATEGORY(logSocket);
 
+class SharedSocketConnection;
+class SharedRecordSplitter;
+
 ///! Unix socket listener.
 class Socket: public DataStream {
 	Q_OBJECT;
+	// clang-format off
 	/// Returns if the socket is currently connected.
 	///
 	/// Writing to this property will set the target connection state and will not
@@ -27,15 +37,54 @@ class Socket: public DataStream {
 	///
 	/// Changing this property will have no effect while the connection is active.
 	Q_PROPERTY(QString path READ path WRITE setPath NOTIFY pathChanged);
+	/// If the socket should keep trying to connect to `path` after a failed connection
+	/// attempt or after the connection is lost. Defaults to false.
+	///
+	/// Attempts are spaced out with an exponentially increasing, randomized delay between
+	/// [reconnectDelay](#prop.reconnectDelay) and [maxReconnectDelay](#prop.maxReconnectDelay).
+	/// While the socket file does not exist no attempts are made, and the socket will
+	/// connect as soon as it is created.
+	///
+	/// Setting `connected` to false stops reconnecting.
+	Q_PROPERTY(bool autoReconnect READ autoReconnect WRITE setAutoReconnect NOTIFY autoReconnectChanged);
+	/// The delay in milliseconds before the first reconnection attempt. Defaults to 100.
+	Q_PROPERTY(qint32 reconnectDelay READ reconnectDelay WRITE setReconnectDelay NOTIFY reconnectDelayChanged);
+	/// The maximum delay in milliseconds between reconnection attempts. Defaults to 30000.
+	Q_PROPERTY(qint32 maxReconnectDelay READ maxReconnectDelay WRITE setMaxReconnectDelay NOTIFY maxReconnectDelayChanged);
+	/// The number of reconnection attempts made since the socket was last connected.
+	Q_PROPERTY(qint32 reconnectAttempts READ reconnectAttempts NOTIFY reconnectAttemptsChanged);
+	/// If the connection to `path` should be shared with other sockets that also have `shared` set.
+	/// Defaults to false.
+	///
+	/// Shared sockets use a single underlying connection which is read once. This avoids having
+	/// the server send the same data once per socket when many sockets listen to the same
+	/// event stream.
+	///
+	/// Data is split once for all sockets whose parser is a [SplitParser](../splitparser)
+	/// with the same `splitMarker`, and each record is handed to all of their parsers. Sockets
+	/// with any other parser receive the raw data and parse it themselves.
+	///
+	/// Writes from any shared socket go to the same connection. A socket that joins an already
+	/// open connection only receives data read after it joined, which may start partway into
+	/// a message unless its records are split along with other sockets.
+	///
+	/// Changing this property will have no effect while the connection is active.
+	Q_PROPERTY(bool shared READ isShared WRITE setShared NOTIFY sharedChanged);
+	// clang-format on
 	QML_ELEMENT;
 
 public:
-	explicit Socket(QObject* parent = nullptr): DataStream(parent) {}
+	explicit Socket(QObject* parent = nullptr);
+	~Socket() override;
+	Q_DISABLE_COPY_MOVE(Socket);
 
-	/// Write data to the socket. Does nothing if not connected.
+	/// Write data to the socket. Writes made while the socket is connecting are sent once it
+	/// connects. Does nothing if the socket is not connected or connecting.
 	///
 	/// Remember to call flush after your last write.
 	Q_INVOKABLE void write(const QString& data);
+	// writes binary data as is, for protocols implemented in C++
+	void writeBytes(const QByteArray& data);
 
 	/// Flush any queued writes to the socket.
 	Q_INVOKABLE void flush();
@@ -49,12 +98,31 @@ public:
 	[[nodiscard]] QString path() const;
 	void setPath(QString path);
 
+	[[nodiscard]] bool autoReconnect() const;
+	void setAutoReconnect(bool autoReconnect);
+
+	[[nodiscard]] qint32 reconnectDelay() const;
+	void setReconnectDelay(qint32 reconnectDelay);
+
+	[[nodiscard]] qint32 maxReconnectDelay() const;
+	void setMaxReconnectDelay(qint32 maxReconnectDelay);
+
+	[[nodiscard]] qint32 reconnectAttempts() const;
+
+	[[nodiscard]] bool isShared() const;
+	void setShared(bool shared);
+
 signals:
 	/// This signal is sent whenever a socket error is encountered.
 	void error(QLocalSocket::LocalSocketError error);
 
 	void connectionStateChanged();
 	void pathChanged();
+	void autoReconnectChanged();
+	void reconnectDelayChanged();
+	void maxReconnectDelayChanged();
+	void reconnectAttemptsChanged();
+	void sharedChanged();
 
 protected:
 	[[nodiscard]] QIODevice* ioDevice() const override;
@@ -63,15 +131,79 @@ private slots:
 	void onSocketConnected();
 	void onSocketDisconnected();
 	void onSocketError(QLocalSocket::LocalSocketError error);
+	void onReconnectTimeout();
+	void onSocketDirectoryChanged();
 
 private:
 	void connectPathSocket();
+	void dropSocket();
+	[[nodiscard]] QLocalSocket* activeSocket() const;
+	void scheduleReconnect();
+	void stopReconnecting();
+	bool waitForSocketPath();
+	void setReconnectAttempts(qint32 attempts);
 
 	QLocalSocket* socket = nullptr;
 	bool connected = false;
 	bool disconnecting = false;
 	bool targetConnected = false;
 	QString mPath;
+
+	bool mAutoReconnect = false;
+	// set while the user wants a connection, unlike targetConnected which is cleared on connect
+	bool keepConnected = false;
+	qint32 mReconnectDelay = 100;
+	qint32 mMaxReconnectDelay = 30000;
+	qint32 mReconnectAttempts = 0;
+	QTimer reconnectTimer;
+	QFileSystemWatcher* pathWatcher = nullptr;
+
+	// writes made while connecting
+	QByteArray pendingWrites;
+
+	bool mShared = false;
+	SharedSocketConnection* sharedConnection = nullptr;
+
+	friend class SharedSocketConnection;
+};
+
+/// A connection to a socket path shared between every Socket with `shared` set.
+class SharedSocketConnection: public QObject {
+	Q_OBJECT;
+
+public:
+	static SharedSocketConnection* acquire(const QString& path, Socket* subscriber);
+	void release(Socket* subscriber);
+
+	// starts connecting if not already connected or connecting
+	void open();
+
+	// buffered until connected
+	void write(const QByteArray& data);
+	void flush();
+
+	[[nodiscard]] QLocalSocket* socket() const;
+
+signals:
+	void connected();
+	void disconnected();
+	void errorOccurred(QLocalSocket::LocalSocketError error);
+
+private slots:
+	void onConnected();
+	void onDisconnected();
+	void onErrorOccurred(QLocalSocket::LocalSocketError error);
+	void onReadyRead();
+
+private:
+	explicit SharedSocketConnection(QString path);
+
+	QString path;
+	QLocalSocket* mSocket = nullptr;
+	QList<Socket*> subscribers;
+	QByteArray pendingWrites;
+	// one per split marker used by subscribers' SplitParsers
+	QHash<QString, SharedRecordSplitter*> splitters;
 };
 
 ///! Unix socket server.
@@ -0,0 +1,36 @@
+#include "coprocess.hpp"
+
+#include <qobject.h>
+#include <qsignalspy.h>
+#include <qtest.h>
+#include <qtestcase.h>
+#include <qtypes.h>
+
+#include "../coprocess.hpp"
+
+void TestCoprocess::failedStart() { // NOLINT
+	auto coprocess = Coprocess();
+	coprocess.setCommand({"/nonexistent/quickshell-test-helper"});
+
+	auto failedSpy = QSignalSpy(&coprocess, &Coprocess::failed);
+
+	// depending on the platform start() fails immediately or once the helper is spawned
+	auto id = coprocess.request("ping");
+
+	if (id == -1) {
+		QCOMPARE(failedSpy.count(), 0);
+	} else {
+		QTRY_COMPARE(failedSpy.count(), 1);
+		QCOMPARE(failedSpy.at(0).at(0).toLongLong(), id);
+	}
+
+	QTRY_VERIFY(!coprocess.isRunning());
+	QCOMPARE(coprocess.pendingRequests(), 0);
+
+	// a later request tries to start the helper again instead of using a dead one
+	auto retry = coprocess.request("ping");
+	if (retry != -1) QTRY_COMPARE(failedSpy.count(), id == -1 ? 1 : 2);
+	QTRY_VERIFY(!coprocess.isRunning());
+}
+
+QTEST_MAIN(TestCoprocess);
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <qobject.h>
+#include <qtmetamacros.h>
+
+class TestCoprocess: public QObject {
+	Q_OBJECT;
+
+private slots:
+	void failedStart();
+};
@@ -0,0 +1,97 @@
+#include "datafile.hpp"
+
+#include <qbytearray.h>
+#include <qfile.h>
+#include <qlist.h>
+#include <qobject.h>
+#include <qsignalspy.h>
+#include <qstringlist.h>
+#include <qtemporarydir.h>
+#include <qtest.h>
+#include <qtestcase.h>
+#include <qtypes.h>
+#include <qvariant.h>
+
+#include "../datafile.hpp"
+
+namespace {
+
+void writeFile(const QString& path, const QByteArray& contents) {
+	auto file = QFile(path);
+	QVERIFY(file.open(QFile::WriteOnly | QFile::Truncate));
+	file.write(contents);
+}
+
+} // namespace
+
+void TestDataFile::load() { // NOLINT
+	auto dir = QTemporaryDir();
+	auto path = dir.filePath("data.json");
+	writeFile(path, R"({"name": "quickshell", "values": [1, 2]})");
+
+	auto file = DataFile();
+	auto loadedSpy = QSignalSpy(&file, &DataFile::loaded);
+	file.setPath(path);
+	file.setFormat(DataFile::Json);
+
+	QTRY_COMPARE(loadedSpy.count(), 1);
+	QVERIFY(!file.isLoading());
+
+	auto data = file.data().toMap();
+	QCOMPARE(data.value("name").toString(), QString("quickshell"));
+	QCOMPARE(data.value("values").toList().length(), static_cast<qsizetype>(2));
+
+	// a second file for the same path is served from the cache
+	auto other = DataFile();
+	auto otherSpy = QSignalSpy(&other, &DataFile::loaded);
+	other.setPath(path);
+	other.setFormat(DataFile::Json);
+
+	QTRY_COMPARE(otherSpy.count(), 1);
+	QCOMPARE(other.data(), file.data());
+}
+
+void TestDataFile::reloadUnchanged() { // NOLINT
+	auto dir = QTemporaryDir();
+	auto path = dir.filePath("lines");
+	writeFile(path, "a\nb\n");
+
+	auto file = DataFile();
+	auto loadedSpy = QSignalSpy(&file, &DataFile::loaded);
+	auto dataSpy = QSignalSpy(&file, &DataFile::dataChanged);
+	file.setFormat(DataFile::Lines);
+	file.setPath(path);
+
+	QTRY_COMPARE(loadedSpy.count(), 1);
+	QCOMPARE(dataSpy.count(), 1);
+	QCOMPARE(file.data().toStringList(), QStringList({"a", "b"}));
+
+	// reloading an unmodified file still reports the load, but not a change
+	file.reload();
+	QTRY_COMPARE(loadedSpy.count(), 2);
+	QCOMPARE(dataSpy.count(), 1);
+}
+
+void TestDataFile::writeRoundTrip() { // NOLINT
+	auto dir = QTemporaryDir();
+	auto path = dir.filePath("text");
+	writeFile(path, "first");
+
+	auto file = DataFile();
+	auto loadedSpy = QSignalSpy(&file, &DataFile::loaded);
+	auto dataSpy = QSignalSpy(&file, &DataFile::dataChanged);
+	file.setPath(path);
+
+	QTRY_COMPARE(loadedSpy.count(), 1);
+	QCOMPARE(file.data().toString(), QString("first"));
+
+	// a different size makes sure the change is seen even with coarse modification times
+	writeFile(path, "second write");
+	file.reload();
+
+	QTRY_COMPARE(loadedSpy.count(), 2);
+	QCOMPARE(file.data().toString(), QString("second write"));
+	QCOMPARE(dataSpy.count(), 2);
+}
+
+QTEST_MAIN(TestDataFile);
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <qobject.h>
+#include <qtmetamacros.h>
+
+class TestDataFile: public QObject {
+	Q_OBJECT;
+
+private slots:
+	void load();
+	void reloadUnchanged();
+	void writeRoundTrip();
+};
@@ -0,0 +1,143 @@
+#include "fanoutparser.hpp"
+
+#include <qbytearray.h>
+#include <qlist.h>
+#include <qobject.h>
+#include <qsignalspy.h>
+#include <qtest.h>
+#include <qtestcase.h>
+#include <qtypes.h>
+
+#include "../datastream.hpp"
+
+namespace {
+
+QList<QString> results(const QSignalSpy& spy) {
+	auto list = QList<QString>();
+	for (const auto& read: spy) {
+		list.push_back(read[0].toString());
+	}
+
+	return list;
+}
+
+} // namespace
+
+void TestFanoutParser::independentBuffers() { // NOLINT
+	auto fanout = FanoutParser();
+	auto dash = SplitParser();
+	auto comma = SplitParser();
+	dash.setSplitMarker("-");
+	comma.setSplitMarker(",");
+
+	auto parsers = fanout.parsers();
+	parsers.append(&parsers, &dash);
+	parsers.append(&parsers, &comma);
+
+	auto dashSpy = QSignalSpy(&dash, &DataStreamParser::read);
+	auto commaSpy = QSignalSpy(&comma, &DataStreamParser::read);
+
+	auto streamBuffer = QByteArray();
+	auto first = QByteArray("a-b,c");
+	auto second = QByteArray("-d,e");
+	fanout.parseBytes(first, streamBuffer);
+	fanout.parseBytes(second, streamBuffer);
+
+	QCOMPARE(results(dashSpy), QList<QString>({"a", "b,c"}));
+	QCOMPARE(results(commaSpy), QList<QString>({"a-b", "c-d"}));
+	QVERIFY(streamBuffer.isEmpty());
+}
+
+void TestFanoutParser::initBuffer() { // NOLINT
+	auto fanout = FanoutParser();
+	auto first = SplitParser();
+	auto second = SplitParser();
+	first.setSplitMarker("-");
+	second.setSplitMarker("-");
+
+	auto parsers = fanout.parsers();
+	parsers.append(&parsers, &first);
+	parsers.append(&parsers, &second);
+
+	auto firstSpy = QSignalSpy(&first, &DataStreamParser::read);
+	auto secondSpy = QSignalSpy(&second, &DataStreamParser::read);
+
+	// data buffered by the stream before the parser was set
+	auto buf = QByteArray("foo-bar");
+	fanout.parseBytes(buf, buf);
+
+	auto incoming = QByteArray("-baz");
+	fanout.parseBytes(incoming, buf);
+
+	auto expected = QList<QString>({"foo", "bar"});
+	QCOMPARE(results(firstSpy), expected);
+	QCOMPARE(results(secondSpy), expected);
+	QVERIFY(buf.isEmpty());
+}
+
+void TestFanoutParser::destroyedParsers() { // NOLINT
+	auto fanout = FanoutParser();
+	auto first = SplitParser();
+	auto second = SplitParser();
+
+	auto parsers = fanout.parsers();
+	parsers.append(&parsers, &first);
+	parsers.append(&parsers, &second);
+	QCOMPARE(parsers.count(&parsers), static_cast<qsizetype>(2));
+
+	{
+		auto removed = SplitParser();
+		parsers.append(&parsers, &removed);
+		QCOMPARE(parsers.count(&parsers), static_cast<qsizetype>(3));
+	}
+
+	// destroyed parsers are dropped
+	QCOMPARE(parsers.count(&parsers), static_cast<qsizetype>(2));
+
+	auto firstSpy = QSignalSpy(&first, &DataStreamParser::read);
+	auto secondSpy = QSignalSpy(&second, &DataStreamParser::read);
+
+	auto buffer = QByteArray();
+	auto incoming = QByteArray("one\ntwo\n");
+	fanout.parseBytes(incoming, buffer);
+
+	auto expected = QList<QString>({"one", "two"});
+	QCOMPARE(results(firstSpy), expected);
+	QCOMPARE(results(secondSpy), expected);
+}
+
+void TestFanoutParser::removedInHandler() { // NOLINT
+	auto fanout = FanoutParser();
+	auto first = SplitParser();
+	auto second = SplitParser();
+	auto third = SplitParser();
+
+	auto parsers = fanout.parsers();
+	parsers.append(&parsers, &first);
+	parsers.append(&parsers, &second);
+	parsers.append(&parsers, &third);
+
+	// like a qml handler replacing the parser list
+	QObject::connect(&first, &DataStreamParser::read, &fanout, [&] {
+		parsers.clear(&parsers);
+		parsers.append(&parsers, &third);
+	});
+
+	auto secondSpy = QSignalSpy(&second, &DataStreamParser::read);
+	auto thirdSpy = QSignalSpy(&third, &DataStreamParser::read);
+
+	auto buffer = QByteArray();
+	auto incoming = QByteArray("one\ntw");
+	fanout.parseBytes(incoming, buffer);
+
+	// removed parsers are skipped, remaining ones are still handed the data
+	QCOMPARE(results(secondSpy), QList<QString>());
+	QCOMPARE(results(thirdSpy), QList<QString>({"one"}));
+	QCOMPARE(parsers.count(&parsers), static_cast<qsizetype>(1));
+
+	incoming = QByteArray("o\n");
+	fanout.parseBytes(incoming, buffer);
+	QCOMPARE(results(thirdSpy), QList<QString>({"one", "two"}));
+}
+
+QTEST_MAIN(TestFanoutParser);
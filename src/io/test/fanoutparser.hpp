@@ -0,0 +1,14 @@
+#pragma once
+
+#include <qobject.h>
+#include <qtmetamacros.h>
+
+class TestFanoutParser: public QObject {
+	Q_OBJECT;
+
+private slots:
+	void independentBuffers();
+	void initBuffer();
+	void destroyedParsers();
+	void removedInHandler();
+};
@@ -0,0 +1,148 @@
+#include "filterparser.hpp"
+
+#include <qbytearray.h>
+#include <qlist.h>
+#include <qobject.h>
+#include <qsignalspy.h>
+#include <qtest.h>
+#include <qtestcase.h>
+#include <qtypes.h>
+
+#include "../datastream.hpp"
+
+namespace {
+
+QList<QString> results(const QSignalSpy& spy) {
+	auto list = QList<QString>();
+	for (const auto& read: spy) {
+		list.push_back(read[0].toString());
+	}
+
+	return list;
+}
+
+} // namespace
+
+void TestFilterParser::filters_data() { // NOLINT
+	QTest::addColumn<QString>("prefix");
+	QTest::addColumn<QString>("contains");
+	QTest::addColumn<QString>("pattern");
+	QTest::addColumn<bool>("invert");
+	QTest::addColumn<QList<QString>>("results");
+
+	// NOLINTBEGIN
+	// clang-format off
+	QTest::addRow("none") << "" << "" << "" << false
+		<< QList<QString>({ "workspace>>1", "focus>>a", "workspace>>2", "urgent>>b" });
+
+	QTest::addRow("prefix") << "workspace>>" << "" << "" << false
+		<< QList<QString>({ "workspace>>1", "workspace>>2" });
+
+	QTest::addRow("contains") << "" << ">>b" << "" << false
+		<< QList<QString>({ "urgent>>b" });
+
+	QTest::addRow("pattern") << "" << "" << "^[a-z]+>>[0-9]$" << false
+		<< QList<QString>({ "workspace>>1", "workspace>>2" });
+
+	QTest::addRow("combined") << "workspace>>" << "" << "2$" << false
+		<< QList<QString>({ "workspace>>2" });
+
+	QTest::addRow("inverted") << "workspace>>" << "" << "" << true
+		<< QList<QString>({ "focus>>a", "urgent>>b" });
+	// clang-format on
+	// NOLINTEND
+}
+
+void TestFilterParser::filters() { // NOLINT
+	// NOLINTBEGIN
+	QFETCH(QString, prefix);
+	QFETCH(QString, contains);
+	QFETCH(QString, pattern);
+	QFETCH(bool, invert);
+	QFETCH(QList<QString>, results);
+	// NOLINTEND
+
+	auto parser = FilterParser();
+	auto spy = QSignalSpy(&parser, &DataStreamParser::read);
+
+	parser.setPrefix(prefix);
+	parser.setContains(contains);
+	parser.setPattern(pattern);
+	parser.setInvert(invert);
+
+	auto buffer = QByteArray();
+	auto incoming = QByteArray("workspace>>1\nfocus>>a\nworkspace>>2\nurgent>>b\n");
+	parser.parseBytes(incoming, buffer);
+
+	QCOMPARE(::results(spy), results);
+	QCOMPARE(parser.forwarded(), static_cast<qint64>(results.length()));
+	QCOMPARE(parser.dropped(), static_cast<qint64>(4 - results.length()));
+}
+
+void TestFilterParser::fields_data() { // NOLINT
+	QTest::addColumn<QList<qint32>>("fields");
+	QTest::addColumn<QString>("read");
+	QTest::addColumn<QList<QString>>("extracted");
+
+	// NOLINTBEGIN
+	// clang-format off
+	QTest::addRow("all") << QList<qint32>()
+		<< "createwindow>>80a0,2,kitty" << QList<QString>({ "createwindow", "80a0,2,kitty" });
+
+	QTest::addRow("single") << QList<qint32>({ 1 })
+		<< "80a0,2,kitty" << QList<QString>({ "80a0,2,kitty" });
+
+	QTest::addRow("negative") << QList<qint32>({ -1, 0 })
+		<< "80a0,2,kitty>>createwindow" << QList<QString>({ "80a0,2,kitty", "createwindow" });
+
+	QTest::addRow("missing") << QList<qint32>({ 0, 5 })
+		<< "createwindow>>" << QList<QString>({ "createwindow", "" });
+	// clang-format on
+	// NOLINTEND
+}
+
+void TestFilterParser::fields() { // NOLINT
+	// NOLINTBEGIN
+	QFETCH(QList<qint32>, fields);
+	QFETCH(QString, read);
+	QFETCH(QList<QString>, extracted);
+	// NOLINTEND
+
+	auto parser = FilterParser();
+	auto readSpy = QSignalSpy(&parser, &DataStreamParser::read);
+	auto fieldSpy = QSignalSpy(&parser, &FilterParser::readFields);
+
+	parser.setFieldDelimiter(">>");
+	parser.setFields(fields);
+
+	auto buffer = QByteArray();
+	auto incoming = QByteArray("createwindow>>80a0,2,kitty\n");
+	parser.parseBytes(incoming, buffer);
+
+	QCOMPARE(readSpy.length(), static_cast<qsizetype>(1));
+	QCOMPARE(fieldSpy.length(), static_cast<qsizetype>(1));
+	QCOMPARE(readSpy[0][0].toString(), read);
+	QCOMPARE(fieldSpy[0][0].value<QList<QString>>(), extracted);
+}
+
+void TestFilterParser::counters() { // NOLINT
+	auto parser = FilterParser();
+	auto spy = QSignalSpy(&parser, &FilterParser::countersChanged);
+	parser.setPrefix("a");
+
+	auto buffer = QByteArray();
+	auto incoming = QByteArray("a\nb\na\nb\nb\n");
+	parser.parseBytes(incoming, buffer);
+
+	// reported once per read, not once per chunk
+	QCOMPARE(spy.length(), static_cast<qsizetype>(1));
+	QCOMPARE(parser.forwarded(), static_cast<qint64>(2));
+	QCOMPARE(parser.dropped(), static_cast<qint64>(3));
+
+	parser.resetCounters();
+	QCOMPARE(spy.length(), static_cast<qsizetype>(2));
+	QCOMPARE(parser.forwarded(), static_cast<qint64>(0));
+	QCOMPARE(parser.dropped(), static_cast<qint64>(0));
+}
+
+QTEST_MAIN(TestFilterParser);
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <qobject.h>
+#include <qtmetamacros.h>
+
+class TestFilterParser: public QObject {
+	Q_OBJECT;
+
+private slots:
+	void filters_data(); // NOLINT
+	void filters();
+	void fields_data(); // NOLINT
+	void fields();
+	void counters();
+};
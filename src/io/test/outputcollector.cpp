@@ -0,0 +1,115 @@
+#include "outputcollector.hpp"
+
+#include <qbytearray.h>
+#include <qlist.h>
+#include <qobject.h>
+#include <qsignalspy.h>
+#include <qtest.h>
+#include <qtestcase.h>
+#include <qtypes.h>
+
+#include "../outputcollector.hpp"
+
+namespace {
+
+void feed(OutputCollector& collector, const char* data) {
+	auto buffer = QByteArray();
+	auto incoming = QByteArray(data);
+	collector.parseBytes(incoming, buffer);
+}
+
+QList<QString> lines(const OutputCollector& collector) {
+	auto list = QList<QString>();
+	for (auto i = 0; i < collector.count(); i++) {
+		list.push_back(collector.lineAt(i));
+	}
+
+	return list;
+}
+
+} // namespace
+
+void TestOutputCollector::maxLines() { // NOLINT
+	auto collector = OutputCollector();
+	collector.setMaxLines(3);
+
+	feed(collector, "a\nb\n");
+	feed(collector, "c\nd\ne\n");
+
+	QCOMPARE(lines(collector), QList<QString>({"c", "d", "e"}));
+	QCOMPARE(collector.dropped(), static_cast<qint64>(2));
+	QCOMPARE(collector.text(), "c\nd\ne");
+
+	// more lines in one read than fit
+	feed(collector, "f\ng\nh\ni\n");
+	QCOMPARE(lines(collector), QList<QString>({"g", "h", "i"}));
+	QCOMPARE(collector.dropped(), static_cast<qint64>(6));
+}
+
+void TestOutputCollector::maxBytes() { // NOLINT
+	auto collector = OutputCollector();
+	collector.setMaxLines(0);
+	collector.setMaxBytes(6);
+
+	feed(collector, "abc\nde\nf\n");
+	QCOMPARE(lines(collector), QList<QString>({"abc", "de", "f"}));
+	QCOMPARE(collector.bytes(), static_cast<qint64>(6));
+
+	feed(collector, "gh\n");
+	QCOMPARE(lines(collector), QList<QString>({"de", "f", "gh"}));
+	QCOMPARE(collector.bytes(), static_cast<qint64>(5));
+}
+
+void TestOutputCollector::memoryLimit() { // NOLINT
+	auto collector = OutputCollector();
+	collector.setMaxLines(0);
+	collector.setMemoryLimit(4);
+
+	feed(collector, "ab\ncd\nef\n");
+
+	// full capture keeps the oldest output and discards what doesn't fit
+	QCOMPARE(lines(collector), QList<QString>({"ab", "cd"}));
+	QCOMPARE(collector.dropped(), static_cast<qint64>(1));
+}
+
+void TestOutputCollector::rowSignals() { // NOLINT
+	auto collector = OutputCollector();
+	collector.setMaxLines(2);
+
+	auto* model = collector.model();
+	auto inserted = QSignalSpy(model, &QAbstractItemModel::rowsInserted);
+	auto removed = QSignalSpy(model, &QAbstractItemModel::rowsRemoved);
+
+	feed(collector, "a\nb\n");
+	QCOMPARE(inserted.length(), static_cast<qsizetype>(1));
+	QCOMPARE(inserted[0][1].toInt(), 0);
+	QCOMPARE(inserted[0][2].toInt(), 1);
+	QCOMPARE(removed.length(), static_cast<qsizetype>(0));
+
+	feed(collector, "c\n");
+	QCOMPARE(removed.length(), static_cast<qsizetype>(1));
+	QCOMPARE(removed[0][1].toInt(), 0);
+	QCOMPARE(removed[0][2].toInt(), 0);
+	QCOMPARE(inserted.length(), static_cast<qsizetype>(2));
+	QCOMPARE(inserted[1][1].toInt(), 1);
+
+	QCOMPARE(model->rowCount(), 2);
+	QCOMPARE(model->data(model->index(1), OutputLineModel::LineRole).toString(), "c");
+}
+
+void TestOutputCollector::shrinkLimit() { // NOLINT
+	auto collector = OutputCollector();
+	feed(collector, "a\nb\nc\nd\n");
+
+	auto spy = QSignalSpy(&collector, &OutputCollector::countChanged);
+	collector.setMaxLines(1);
+
+	QCOMPARE(lines(collector), QList<QString>({"d"}));
+	QCOMPARE(spy.length(), static_cast<qsizetype>(1));
+
+	collector.clear();
+	QCOMPARE(collector.count(), 0);
+	QCOMPARE(collector.dropped(), static_cast<qint64>(0));
+}
+
+QTEST_MAIN(TestOutputCollector);
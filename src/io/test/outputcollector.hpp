@@ -0,0 +1,15 @@
+#pragma once
+
+#include <qobject.h>
+#include <qtmetamacros.h>
+
+class TestOutputCollector: public QObject {
+	Q_OBJECT;
+
+private slots:
+	void maxLines();
+	void maxBytes();
+	void memoryLimit();
+	void rowSignals();
+	void shrinkLimit();
+};
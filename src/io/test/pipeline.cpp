@@ -0,0 +1,86 @@
+#include "pipeline.hpp"
+
+#include <qlist.h>
+#include <qobject.h>
+#include <qsignalspy.h>
+#include <qtest.h>
+#include <qtestcase.h>
+#include <qtypes.h>
+#include <qvariant.h>
+
+#include "../pipeline.hpp"
+
+namespace {
+
+QList<QVariant> sleepPipeline() {
+	return {
+	    QVariant(QStringList {"sleep", "0.2"}),
+	    QVariant(QStringList {"cat"}),
+	};
+}
+
+} // namespace
+
+void TestProcessPipeline::restartWhileRunning() { // NOLINT
+	auto pipeline = ProcessPipeline();
+	pipeline.setCommands(sleepPipeline());
+
+	auto startedSpy = QSignalSpy(&pipeline, &ProcessPipeline::started);
+	auto exitedSpy = QSignalSpy(&pipeline, &ProcessPipeline::exited);
+
+	pipeline.setRunning(true);
+	QCOMPARE(startedSpy.count(), 1);
+	QVERIFY(pipeline.isRunning());
+
+	// setting running again mid-run starts a new run after the current one exits
+	pipeline.setRunning(true);
+	QCOMPARE(startedSpy.count(), 1);
+
+	QTRY_COMPARE(exitedSpy.count(), 1);
+	QCOMPARE(startedSpy.count(), 2);
+	QVERIFY(pipeline.isRunning());
+
+	QTRY_COMPARE(exitedSpy.count(), 2);
+	QCOMPARE(startedSpy.count(), 2);
+	QVERIFY(!pipeline.isRunning());
+	QCOMPARE(exitedSpy.at(1).at(0).value<QList<qint32>>(), QList<qint32>({0, 0}));
+}
+
+void TestProcessPipeline::stopWhileRunning() { // NOLINT
+	auto pipeline = ProcessPipeline();
+	pipeline.setCommands(sleepPipeline());
+
+	auto startedSpy = QSignalSpy(&pipeline, &ProcessPipeline::started);
+	auto exitedSpy = QSignalSpy(&pipeline, &ProcessPipeline::exited);
+
+	pipeline.setRunning(true);
+
+	// a later false cancels the restart requested mid-run
+	pipeline.setRunning(true);
+	pipeline.setRunning(false);
+
+	QTRY_COMPARE(exitedSpy.count(), 1);
+	QVERIFY(!pipeline.isRunning());
+	QCOMPARE(startedSpy.count(), 1);
+}
+
+void TestProcessPipeline::failedStart() { // NOLINT
+	auto pipeline = ProcessPipeline();
+	pipeline.setCommands({
+	    QVariant(QStringList {"/nonexistent/quickshell-test-stage"}),
+	    QVariant(QStringList {"/nonexistent/quickshell-test-stage"}),
+	});
+
+	auto events = QList<QString>();
+	QObject::connect(&pipeline, &ProcessPipeline::started, [&] { events.append("started"); });
+	QObject::connect(&pipeline, &ProcessPipeline::exited, [&] { events.append("exited"); });
+
+	// stages may fail inside start(), which must not be reported before started
+	pipeline.setRunning(true);
+
+	QTRY_COMPARE(events, QList<QString>({"started", "exited"}));
+	QVERIFY(!pipeline.isRunning());
+	QCOMPARE(pipeline.exitCodes(), QList<qint32>({-1, -1}));
+}
+
+QTEST_MAIN(TestProcessPipeline);
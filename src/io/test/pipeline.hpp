@@ -0,0 +1,13 @@
+#pragma once
+
+#include <qobject.h>
+#include <qtmetamacros.h>
+
+class TestProcessPipeline: public QObject {
+	Q_OBJECT;
+
+private slots:
+	void restartWhileRunning();
+	void stopWhileRunning();
+	void failedStart();
+};
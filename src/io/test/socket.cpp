@@ -0,0 +1,211 @@
+#include "socket.hpp"
+
+#include <qbytearray.h>
+#include <qfile.h>
+#include <qlist.h>
+#include <qlocalserver.h>
+#include <qlocalsocket.h>
+#include <qobject.h>
+#include <qsignalspy.h>
+#include <qtemporarydir.h>
+#include <qtest.h>
+#include <qtestcase.h>
+#include <qtypes.h>
+
+#include "../datastream.hpp"
+#include "../outputcollector.hpp"
+#include "../socket.hpp"
+
+namespace {
+
+QList<QString> results(const QSignalSpy& spy) {
+	auto list = QList<QString>();
+	for (const auto& read: spy) {
+		list.push_back(read[0].toString());
+	}
+
+	return list;
+}
+
+} // namespace
+
+void TestSocket::writeWhileConnecting_data() { // NOLINT
+	QTest::addColumn<bool>("shared");
+	QTest::newRow("unshared") << false;
+	QTest::newRow("shared") << true;
+}
+
+void TestSocket::writeWhileConnecting() { // NOLINT
+	QFETCH(bool, shared);
+
+	auto dir = QTemporaryDir();
+	auto server = QLocalServer();
+	QVERIFY(server.listen(dir.filePath("socket")));
+
+	auto socket = Socket();
+	socket.setShared(shared);
+	socket.setPath(server.fullServerName());
+	socket.setConnected(true);
+
+	// written before the connection is known to be established
+	socket.write("hello\n");
+	socket.flush();
+
+	QTRY_VERIFY(server.hasPendingConnections());
+	auto* connection = server.nextPendingConnection();
+
+	QTRY_COMPARE(connection->readAll(), QByteArray("hello\n"));
+	QVERIFY(socket.isConnected());
+}
+
+void TestSocket::sharedRecords() { // NOLINT
+	auto dir = QTemporaryDir();
+	auto server = QLocalServer();
+	QVERIFY(server.listen(dir.filePath("socket")));
+
+	auto first = Socket();
+	auto second = Socket();
+	auto other = Socket();
+	auto firstParser = SplitParser();
+	auto secondParser = SplitParser();
+	auto otherParser = SplitParser();
+	otherParser.setSplitMarker(",");
+
+	first.setReader(&firstParser);
+	second.setReader(&secondParser);
+	other.setReader(&otherParser);
+
+	for (auto* socket: {&first, &second, &other}) {
+		socket->setShared(true);
+		socket->setPath(server.fullServerName());
+		socket->setConnected(true);
+	}
+
+	QTRY_VERIFY(first.isConnected() && second.isConnected() && other.isConnected());
+
+	// one connection for all three sockets
+	QTRY_VERIFY(server.hasPendingConnections());
+	auto* connection = server.nextPendingConnection();
+	QVERIFY(!server.hasPendingConnections());
+
+	auto firstSpy = QSignalSpy(&firstParser, &DataStreamParser::read);
+	auto secondSpy = QSignalSpy(&secondParser, &DataStreamParser::read);
+	auto otherSpy = QSignalSpy(&otherParser, &DataStreamParser::read);
+
+	connection->write("a,b\nc");
+	connection->flush();
+	QTRY_COMPARE(results(firstSpy), QList<QString>({"a,b"}));
+
+	connection->write("\n");
+	connection->flush();
+
+	// sockets splitting on the same marker share records, others parse on their own
+	auto expected = QList<QString>({"a,b", "c"});
+	QTRY_COMPARE(results(firstSpy), expected);
+	QCOMPARE(results(secondSpy), expected);
+	QCOMPARE(results(otherSpy), QList<QString>({"a"}));
+}
+
+void TestSocket::sharedSubclass() { // NOLINT
+	auto dir = QTemporaryDir();
+	auto server = QLocalServer();
+	QVERIFY(server.listen(dir.filePath("socket")));
+
+	auto plain = Socket();
+	auto collecting = Socket();
+	auto plainParser = SplitParser();
+	auto collector = OutputCollector();
+
+	plain.setReader(&plainParser);
+	collecting.setReader(&collector);
+
+	for (auto* socket: {&plain, &collecting}) {
+		socket->setShared(true);
+		socket->setPath(server.fullServerName());
+		socket->setConnected(true);
+	}
+
+	QTRY_VERIFY(plain.isConnected() && collecting.isConnected());
+	QTRY_VERIFY(server.hasPendingConnections());
+	auto* connection = server.nextPendingConnection();
+
+	auto plainSpy = QSignalSpy(&plainParser, &DataStreamParser::read);
+
+	connection->write("a\nb\n");
+	connection->flush();
+
+	// the subclass parses on its own instead of receiving the plain parser's records
+	QTRY_COMPARE(results(plainSpy), QList<QString>({"a", "b"}));
+	QTRY_COMPARE(collector.count(), 2);
+	QCOMPARE(collector.text(), QString("a\nb"));
+}
+
+void TestSocket::reconnectAfterRestart() { // NOLINT
+	auto dir = QTemporaryDir();
+	auto server = QLocalServer();
+	QVERIFY(server.listen(dir.filePath("socket")));
+
+	auto socket = Socket();
+	socket.setAutoReconnect(true);
+	socket.setReconnectDelay(10);
+	socket.setPath(server.fullServerName());
+	socket.setConnected(true);
+
+	QTRY_VERIFY(socket.isConnected());
+	QTRY_VERIFY(server.hasPendingConnections());
+	auto* connection = server.nextPendingConnection();
+
+	auto attemptsSpy = QSignalSpy(&socket, &Socket::reconnectAttemptsChanged);
+
+	// closing the server removes the socket file, so the socket waits for it to come back
+	server.close();
+	connection->disconnectFromServer();
+	QTRY_VERIFY(!socket.isConnected());
+
+	QTest::qWait(50);
+	QCOMPARE(socket.reconnectAttempts(), 0);
+
+	QVERIFY(server.listen(dir.filePath("socket")));
+	QTRY_VERIFY(socket.isConnected());
+	QTRY_VERIFY(server.hasPendingConnections());
+
+	// attempts are counted once the file appears, and reset by connecting
+	QVERIFY(attemptsSpy.count() >= 2);
+	QCOMPARE(socket.reconnectAttempts(), 0);
+}
+
+void TestSocket::reconnectBackoff() { // NOLINT
+	auto dir = QTemporaryDir();
+	auto path = dir.filePath("socket");
+
+	// a file nothing listens on, so every attempt fails and is retried on a timer
+	auto file = QFile(path);
+	QVERIFY(file.open(QFile::WriteOnly));
+	file.close();
+
+	auto socket = Socket();
+	socket.setAutoReconnect(true);
+	socket.setReconnectDelay(10);
+	socket.setMaxReconnectDelay(20);
+	socket.setPath(path);
+	socket.setConnected(true);
+
+	QTRY_VERIFY(socket.reconnectAttempts() >= 3);
+	QVERIFY(!socket.isConnected());
+
+	QVERIFY(QFile::remove(path));
+	auto server = QLocalServer();
+	QVERIFY(server.listen(path));
+
+	QTRY_VERIFY(socket.isConnected());
+	QCOMPARE(socket.reconnectAttempts(), 0);
+
+	// a requested disconnect is not reconnected
+	socket.setConnected(false);
+	QTRY_VERIFY(!socket.isConnected());
+	QTest::qWait(50);
+	QVERIFY(!socket.isConnected());
+	QCOMPARE(socket.reconnectAttempts(), 0);
+}
+
+QTEST_MAIN(TestSocket);
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <qobject.h>
+#include <qtmetamacros.h>
+
+class TestSocket: public QObject {
+	Q_OBJECT;
+
+private slots:
+	void writeWhileConnecting_data();
+	void writeWhileConnecting();
+	void sharedRecords();
+	void sharedSubclass();
+	void reconnectAfterRestart();
+	void reconnectBackoff();
+};
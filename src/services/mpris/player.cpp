@@ -0,0 +1,310 @@
+#include "player.hpp"
+#include <algorithm>
+#include <utility>
+
+#include <qcontainerfwd.h>
+#include <qdbusconnection.h>
+#include <qdbusextratypes.h>
+#include <qlogging.h>
+#include <qloggingcategory.h>
+#include <qmetatype.h>
+#include <qobject.h>
+#include <qstring.h>
+#include <qtypes.h>
+#include <qvariant.h>
+
+#include "../../dbus/properties.hpp"
+#include "dbus_player.h"
+#include "dbus_player_app.h"
+
+using namespace qs::dbus;
+
+Q_LOGGING_CATEGORY(logMprisPlayer, "quickshell.service.mpris.player", QtWarningMsg);
+
+namespace qs::service::mpris {
+
+MprisPlayer::MprisPlayer(const QDBusConnection& connection, QString dbusName, QObject* parent)
+    : QObject(parent)
+    , mDbusName(std::move(dbusName)) {
+	this->app =
+	    new DBusMprisPlayerApp(this->mDbusName, "/org/mpris/MediaPlayer2", connection, this);
+	this->player = new DBusMprisPlayer(this->mDbusName, "/org/mpris/MediaPlayer2", connection, this);
+
+	if (!this->player->isValid()) {
+		qCWarning(logMprisPlayer) << "Cannot create MprisPlayer for" << this->mDbusName;
+		return;
+	}
+
+	// clang-format off
+	QObject::connect(&this->pIdentity, &AbstractDBusProperty::changed, this, &MprisPlayer::identityChanged);
+	QObject::connect(&this->pDesktopEntry, &AbstractDBusProperty::changed, this, &MprisPlayer::desktopEntryChanged);
+	QObject::connect(&this->pCanQuit, &AbstractDBusProperty::changed, this, &MprisPlayer::canQuitChanged);
+	QObject::connect(&this->pCanRaise, &AbstractDBusProperty::changed, this, &MprisPlayer::canRaiseChanged);
+
+	QObject::connect(&this->pCanControl, &AbstractDBusProperty::changed, this, &MprisPlayer::canControlChanged);
+	QObject::connect(&this->pCanPlay, &AbstractDBusProperty::changed, this, &MprisPlayer::canPlayChanged);
+	QObject::connect(&this->pCanPause, &AbstractDBusProperty::changed, this, &MprisPlayer::canPauseChanged);
+	QObject::connect(&this->pCanSeek, &AbstractDBusProperty::changed, this, &MprisPlayer::canSeekChanged);
+	QObject::connect(&this->pCanGoNext, &AbstractDBusProperty::changed, this, &MprisPlayer::canGoNextChanged);
+	QObject::connect(&this->pCanGoPrevious, &AbstractDBusProperty::changed, this, &MprisPlayer::canGoPreviousChanged);
+	QObject::connect(&this->pLoopStatus, &AbstractDBusProperty::changed, this, &MprisPlayer::loopStateChanged);
+	QObject::connect(&this->pShuffle, &AbstractDBusProperty::changed, this, &MprisPlayer::shuffleChanged);
+	QObject::connect(&this->pVolume, &AbstractDBusProperty::changed, this, &MprisPlayer::volumeChanged);
+
+	QObject::connect(&this->pPosition, &AbstractDBusProperty::changed, this, &MprisPlayer::onPositionChanged);
+	QObject::connect(&this->pPlaybackStatus, &AbstractDBusProperty::changed, this, &MprisPlayer::onPlaybackStatusChanged);
+	QObject::connect(&this->pRate, &AbstractDBusProperty::changed, this, &MprisPlayer::onRateChanged);
+	QObject::connect(&this->pMetadata, &AbstractDBusProperty::changed, this, &MprisPlayer::onMetadataChanged);
+	QObject::connect(this->player, &DBusMprisPlayer::Seeked, this, &MprisPlayer::onSeeked);
+
+	QObject::connect(&this->playerProperties, &DBusPropertyGroup::getAllFinished, this, &MprisPlayer::onGetAllFinished);
+	// clang-format on
+
+	this->positionTimer.start();
+
+	this->appProperties.setInterface(this->app);
+	this->playerProperties.setInterface(this->player);
+	this->appProperties.updateAllViaGetAll();
+	this->playerProperties.updateAllViaGetAll();
+}
+
+void MprisPlayer::onGetAllFinished() {
+	if (this->mReady) return;
+
+	qCDebug(logMprisPlayer) << "MprisPlayer" << this->mDbusName << "is ready.";
+	this->mReady = true;
+	emit this->readyChanged();
+}
+
+// Position is never sent in PropertiesChanged, and reading it constantly would mean a
+// round trip per player per update. Instead it is extrapolated from the last known
+// position, and only read again when something makes the extrapolation invalid.
+
+qlonglong MprisPlayer::positionUs() const {
+	auto position = this->positionBaseUs;
+
+	if (this->mPlaybackState == MprisPlaybackState::Playing) {
+		auto elapsedUs = static_cast<qreal>(this->positionTimer.nsecsElapsed()) / 1000;
+		position += static_cast<qlonglong>(elapsedUs * this->positionRate);
+	}
+
+	if (this->mLengthUs > 0) position = std::min(position, this->mLengthUs);
+	return std::max(position, 0ll);
+}
+
+void MprisPlayer::rebasePosition(qlonglong positionUs) {
+	this->positionBaseUs = positionUs;
+	this->positionRate = this->pRate.get();
+	this->positionTimer.restart();
+}
+
+void MprisPlayer::requestPosition() {
+	// position is part of the initial GetAll
+	if (!this->mReady) return;
+	this->pPosition.update();
+}
+
+void MprisPlayer::onPositionChanged() {
+	this->rebasePosition(this->pPosition.get());
+	emit this->positionChanged();
+}
+
+void MprisPlayer::onSeeked(qlonglong position) {
+	// Seeked carries the new position, so there is no need to read it back
+	this->pPosition.set(position);
+}
+
+void MprisPlayer::onPlaybackStatusChanged() {
+	auto status = this->pPlaybackStatus.get();
+	auto state = MprisPlaybackState::Stopped;
+
+	if (status == "Playing") state = MprisPlaybackState::Playing;
+	else if (status == "Paused") state = MprisPlaybackState::Paused;
+	else if (status != "Stopped") {
+		qCWarning(logMprisPlayer) << "Nonconformant playback status" << status << "returned for"
+		                          << this->mDbusName;
+	}
+
+	if (state == this->mPlaybackState) return;
+
+	// freeze or resume extrapolation where it currently is until the player responds
+	this->rebasePosition(this->positionUs());
+	this->mPlaybackState = state;
+	emit this->playbackStateChanged();
+
+	this->requestPosition();
+}
+
+void MprisPlayer::onRateChanged() {
+	// the time since the last rebase was spent at the previous rate
+	auto position = this->positionUs();
+	this->rebasePosition(position);
+	emit this->rateChanged();
+}
+
+void MprisPlayer::onMetadataChanged() {
+	auto metadata = this->pMetadata.get();
+
+	auto trackIdVariant = metadata.value("mpris:trackid");
+	// some players send the track id as a string instead of an object path
+	auto trackId = trackIdVariant.metaType() == QMetaType::fromType<QDBusObjectPath>()
+	                 ? trackIdVariant.value<QDBusObjectPath>().path()
+	                 : trackIdVariant.toString();
+
+	this->mLengthUs = metadata.value("mpris:length").toLongLong();
+
+	if (trackId != this->mTrackId) {
+		this->mTrackId = trackId;
+		this->requestPosition();
+	}
+
+	emit this->metadataChanged();
+}
+
+void MprisPlayer::raise() {
+	if (!this->canRaise()) {
+		qCWarning(logMprisPlayer) << "Cannot raise" << this->mDbusName << "as CanRaise is false.";
+		return;
+	}
+
+	this->app->Raise();
+}
+
+void MprisPlayer::quit() {
+	if (!this->canQuit()) {
+		qCWarning(logMprisPlayer) << "Cannot quit" << this->mDbusName << "as CanQuit is false.";
+		return;
+	}
+
+	this->app->Quit();
+}
+
+void MprisPlayer::togglePlaying() {
+	if (this->mPlaybackState == MprisPlaybackState::Playing) this->pause();
+	else this->play();
+}
+
+void MprisPlayer::play() {
+	if (!this->canPlay()) {
+		qCWarning(logMprisPlayer) << "Cannot play" << this->mDbusName << "as CanPlay is false.";
+		return;
+	}
+
+	this->player->Play();
+}
+
+void MprisPlayer::pause() {
+	if (!this->canPause()) {
+		qCWarning(logMprisPlayer) << "Cannot pause" << this->mDbusName << "as CanPause is false.";
+		return;
+	}
+
+	this->player->Pause();
+}
+
+void MprisPlayer::stop() {
+	if (!this->canControl()) {
+		qCWarning(logMprisPlayer) << "Cannot stop" << this->mDbusName << "as CanControl is false.";
+		return;
+	}
+
+	this->player->Stop();
+}
+
+void MprisPlayer::next() {
+	if (!this->canGoNext()) {
+		qCWarning(logMprisPlayer) << "Cannot go to the next track of" << this->mDbusName
+		                          << "as CanGoNext is false.";
+		return;
+	}
+
+	this->player->Next();
+}
+
+void MprisPlayer::previous() {
+	if (!this->canGoPrevious()) {
+		qCWarning(logMprisPlayer) << "Cannot go to the previous track of" << this->mDbusName
+		                          << "as CanGoPrevious is false.";
+		return;
+	}
+
+	this->player->Previous();
+}
+
+void MprisPlayer::seek(qreal offset) {
+	if (!this->canSeek()) {
+		qCWarning(logMprisPlayer) << "Cannot seek" << this->mDbusName << "as CanSeek is false.";
+		return;
+	}
+
+	this->player->Seek(static_cast<qlonglong>(offset * 1000000));
+}
+
+void MprisPlayer::setPosition(qreal position) {
+	if (!this->canSeek()) {
+		qCWarning(logMprisPlayer) << "Cannot set position of" << this->mDbusName
+		                          << "as CanSeek is false.";
+		return;
+	}
+
+	if (this->mTrackId.isEmpty()) {
+		qCWarning(logMprisPlayer) << "Cannot set position of" << this->mDbusName
+		                          << "as the current track has no id.";
+		return;
+	}
+
+	auto positionUs = static_cast<qlonglong>(position * 1000000);
+	this->player->SetPosition(QDBusObjectPath(this->mTrackId), positionUs);
+}
+
+bool MprisPlayer::isValid() const { return this->player->isValid(); }
+bool MprisPlayer::isReady() const { return this->mReady; }
+QString MprisPlayer::dbusName() const { return this->mDbusName; }
+QString MprisPlayer::identity() const { return this->pIdentity.get(); }
+QString MprisPlayer::desktopEntry() const { return this->pDesktopEntry.get(); }
+bool MprisPlayer::canQuit() const { return this->pCanQuit.get(); }
+bool MprisPlayer::canRaise() const { return this->pCanRaise.get(); }
+bool MprisPlayer::canControl() const { return this->pCanControl.get(); }
+bool MprisPlayer::canPlay() const { return this->canControl() && this->pCanPlay.get(); }
+bool MprisPlayer::canPause() const { return this->canControl() && this->pCanPause.get(); }
+bool MprisPlayer::canSeek() const { return this->canControl() && this->pCanSeek.get(); }
+bool MprisPlayer::canGoNext() const { return this->canControl() && this->pCanGoNext.get(); }
+
+bool MprisPlayer::canGoPrevious() const {
+	return this->canControl() && this->pCanGoPrevious.get();
+}
+
+MprisPlaybackState::Enum MprisPlayer::playbackState() const { return this->mPlaybackState; }
+
+MprisLoopState::Enum MprisPlayer::loopState() const {
+	auto status = this->pLoopStatus.get();
+
+	if (status == "Track") return MprisLoopState::Track;
+	if (status == "Playlist") return MprisLoopState::Playlist;
+	return MprisLoopState::None;
+}
+
+bool MprisPlayer::shuffle() const { return this->pShuffle.get(); }
+qreal MprisPlayer::rate() const { return this->pRate.get(); }
+qreal MprisPlayer::volume() const { return this->pVolume.get(); }
+qreal MprisPlayer::position() const { return static_cast<qreal>(this->positionUs()) / 1000000; }
+qreal MprisPlayer::length() const { return static_cast<qreal>(this->mLengthUs) / 1000000; }
+QVariantMap MprisPlayer::metadata() const { return this->pMetadata.get(); }
+
+QString MprisPlayer::trackTitle() const {
+	return this->pMetadata.get().value("xesam:title").toString();
+}
+
+QString MprisPlayer::trackAlbum() const {
+	return this->pMetadata.get().value("xesam:album").toString();
+}
+
+QString MprisPlayer::trackArtists() const {
+	return this->pMetadata.get().value("xesam:artist").toStringList().join(", ");
+}
+
+QString MprisPlayer::trackArtUrl() const {
+	return this->pMetadata.get().value("mpris:artUrl").toString();
+}
+
+} // namespace qs::service::mpris
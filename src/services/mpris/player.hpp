@@ -0,0 +1,231 @@
+#pragma once
+
+#include <qcontainerfwd.h>
+#include <qdbusconnection.h>
+#include <qelapsedtimer.h>
+#include <qloggingcategory.h>
+#include <qobject.h>
+#include <qqmlintegration.h>
+#include <qtmetamacros.h>
+#include <qtypes.h>
+
+#include "../../dbus/properties.hpp"
+
+class DBusMprisPlayerApp;
+class DBusMprisPlayer;
+
+Q_DECLARE_LOGGING_CATEGORY(logMprisPlayer);
+
+namespace qs::service::mpris {
+
+namespace MprisPlaybackState { // NOLINT
+Q_NAMESPACE;
+QML_ELEMENT;
+
+enum Enum {
+	Stopped = 0,
+	Playing = 1,
+	Paused = 2,
+};
+Q_ENUM_NS(Enum);
+
+} // namespace MprisPlaybackState
+
+namespace MprisLoopState { // NOLINT
+Q_NAMESPACE;
+QML_ELEMENT;
+
+enum Enum {
+	/// Playback stops at the end of the playlist.
+	None = 0,
+	/// The current track repeats.
+	Track = 1,
+	/// The playlist repeats.
+	Playlist = 2,
+};
+Q_ENUM_NS(Enum);
+
+} // namespace MprisLoopState
+
+///! A media player exposed over MPRIS.
+/// A media player exposed over [MPRIS].
+///
+/// > [!INFO] MPRIS players do not send updates for their position, so `position` is
+/// > calculated from the last known position, the playback rate and the time since then.
+/// > `positionChanged` is only emitted when the player reports a new position, such as when
+/// > seeking, pausing or changing tracks.
+/// >
+/// > To show a live position, emit `positionChanged` from a `Timer` while
+/// > `playbackState` is `Playing`. This does not involve the player at all.
+///
+/// [MPRIS]: https://specifications.freedesktop.org/mpris-spec/latest/
+class MprisPlayer: public QObject {
+	Q_OBJECT;
+	// clang-format off
+	/// The name of the player on the bus, such as `org.mpris.MediaPlayer2.spotify`.
+	Q_PROPERTY(QString dbusName READ dbusName CONSTANT);
+	/// A human readable name for the player.
+	Q_PROPERTY(QString identity READ identity NOTIFY identityChanged);
+	/// The name of the player's desktop entry, without the `.desktop` extension.
+	Q_PROPERTY(QString desktopEntry READ desktopEntry NOTIFY desktopEntryChanged);
+	Q_PROPERTY(bool canQuit READ canQuit NOTIFY canQuitChanged);
+	Q_PROPERTY(bool canRaise READ canRaise NOTIFY canRaiseChanged);
+	/// If the player can be controlled at all. If false, all other `can*` properties are false.
+	Q_PROPERTY(bool canControl READ canControl NOTIFY canControlChanged);
+	Q_PROPERTY(bool canPlay READ canPlay NOTIFY canPlayChanged);
+	Q_PROPERTY(bool canPause READ canPause NOTIFY canPauseChanged);
+	Q_PROPERTY(bool canSeek READ canSeek NOTIFY canSeekChanged);
+	Q_PROPERTY(bool canGoNext READ canGoNext NOTIFY canGoNextChanged);
+	Q_PROPERTY(bool canGoPrevious READ canGoPrevious NOTIFY canGoPreviousChanged);
+	Q_PROPERTY(qs::service::mpris::MprisPlaybackState::Enum playbackState READ playbackState NOTIFY playbackStateChanged);
+	Q_PROPERTY(qs::service::mpris::MprisLoopState::Enum loopState READ loopState NOTIFY loopStateChanged);
+	Q_PROPERTY(bool shuffle READ shuffle NOTIFY shuffleChanged);
+	/// The playback rate, where 1 is normal speed.
+	Q_PROPERTY(qreal rate READ rate NOTIFY rateChanged);
+	/// The volume of the player, from 0 to 1.
+	Q_PROPERTY(qreal volume READ volume NOTIFY volumeChanged);
+	/// The position in the current track, in seconds.
+	///
+	/// Setting the position seeks to it if `canSeek` is true. See the type documentation
+	/// for how the position is updated.
+	Q_PROPERTY(qreal position READ position WRITE setPosition NOTIFY positionChanged);
+	/// The length of the current track in seconds, or 0 if unknown.
+	Q_PROPERTY(qreal length READ length NOTIFY metadataChanged);
+	/// The metadata of the current track, as described in the [MPRIS metadata spec].
+	///
+	/// [MPRIS metadata spec]: https://www.freedesktop.org/wiki/Specifications/mpris-spec/metadata/
+	Q_PROPERTY(QVariantMap metadata READ metadata NOTIFY metadataChanged);
+	Q_PROPERTY(QString trackTitle READ trackTitle NOTIFY metadataChanged);
+	Q_PROPERTY(QString trackAlbum READ trackAlbum NOTIFY metadataChanged);
+	/// The artists of the current track, separated by commas.
+	Q_PROPERTY(QString trackArtists READ trackArtists NOTIFY metadataChanged);
+	Q_PROPERTY(QString trackArtUrl READ trackArtUrl NOTIFY metadataChanged);
+	/// If the player's state has been read at least once.
+	Q_PROPERTY(bool ready READ isReady NOTIFY readyChanged);
+	// clang-format on
+	QML_ELEMENT;
+	QML_UNCREATABLE("MprisPlayers can only be acquired from Mpris");
+
+public:
+	explicit MprisPlayer(
+	    const QDBusConnection& connection,
+	    QString dbusName,
+	    QObject* parent = nullptr
+	);
+
+	/// Bring the player's window to the front, if `canRaise` is true.
+	Q_INVOKABLE void raise();
+	/// Close the player, if `canQuit` is true.
+	Q_INVOKABLE void quit();
+	/// Pause if playing, otherwise start playing.
+	Q_INVOKABLE void togglePlaying();
+	Q_INVOKABLE void play();
+	Q_INVOKABLE void pause();
+	Q_INVOKABLE void stop();
+	Q_INVOKABLE void next();
+	Q_INVOKABLE void previous();
+	/// Seek by the given number of seconds, which may be negative.
+	Q_INVOKABLE void seek(qreal offset);
+
+	[[nodiscard]] bool isValid() const;
+	[[nodiscard]] bool isReady() const;
+	[[nodiscard]] QString dbusName() const;
+	[[nodiscard]] QString identity() const;
+	[[nodiscard]] QString desktopEntry() const;
+	[[nodiscard]] bool canQuit() const;
+	[[nodiscard]] bool canRaise() const;
+	[[nodiscard]] bool canControl() const;
+	[[nodiscard]] bool canPlay() const;
+	[[nodiscard]] bool canPause() const;
+	[[nodiscard]] bool canSeek() const;
+	[[nodiscard]] bool canGoNext() const;
+	[[nodiscard]] bool canGoPrevious() const;
+	[[nodiscard]] MprisPlaybackState::Enum playbackState() const;
+	[[nodiscard]] MprisLoopState::Enum loopState() const;
+	[[nodiscard]] bool shuffle() const;
+	[[nodiscard]] qreal rate() const;
+	[[nodiscard]] qreal volume() const;
+	[[nodiscard]] qreal position() const;
+	void setPosition(qreal position);
+	[[nodiscard]] qreal length() const;
+	[[nodiscard]] QVariantMap metadata() const;
+	[[nodiscard]] QString trackTitle() const;
+	[[nodiscard]] QString trackAlbum() const;
+	[[nodiscard]] QString trackArtists() const;
+	[[nodiscard]] QString trackArtUrl() const;
+
+	// clang-format off
+	dbus::DBusPropertyGroup appProperties;
+	dbus::DBusProperty<QString> pIdentity {this->appProperties, "Identity"};
+	dbus::DBusProperty<QString> pDesktopEntry {this->appProperties, "DesktopEntry"};
+	dbus::DBusProperty<bool> pCanQuit {this->appProperties, "CanQuit"};
+	dbus::DBusProperty<bool> pCanRaise {this->appProperties, "CanRaise"};
+
+	dbus::DBusPropertyGroup playerProperties;
+	dbus::DBusProperty<QString> pPlaybackStatus {this->playerProperties, "PlaybackStatus"};
+	dbus::DBusProperty<QString> pLoopStatus {this->playerProperties, "LoopStatus"};
+	dbus::DBusProperty<qreal> pRate {this->playerProperties, "Rate", nullptr, 1};
+	dbus::DBusProperty<bool> pShuffle {this->playerProperties, "Shuffle"};
+	dbus::DBusProperty<QVariantMap> pMetadata {this->playerProperties, "Metadata"};
+	dbus::DBusProperty<qreal> pVolume {this->playerProperties, "Volume", nullptr, 1};
+	dbus::DBusProperty<qlonglong> pPosition {this->playerProperties, "Position"};
+	dbus::DBusProperty<bool> pCanControl {this->playerProperties, "CanControl"};
+	dbus::DBusProperty<bool> pCanPlay {this->playerProperties, "CanPlay"};
+	dbus::DBusProperty<bool> pCanPause {this->playerProperties, "CanPause"};
+	dbus::DBusProperty<bool> pCanSeek {this->playerProperties, "CanSeek"};
+	dbus::DBusProperty<bool> pCanGoNext {this->playerProperties, "CanGoNext"};
+	dbus::DBusProperty<bool> pCanGoPrevious {this->playerProperties, "CanGoPrevious"};
+	// clang-format on
+
+signals:
+	void identityChanged();
+	void desktopEntryChanged();
+	void canQuitChanged();
+	void canRaiseChanged();
+	void canControlChanged();
+	void canPlayChanged();
+	void canPauseChanged();
+	void canSeekChanged();
+	void canGoNextChanged();
+	void canGoPreviousChanged();
+	void playbackStateChanged();
+	void loopStateChanged();
+	void shuffleChanged();
+	void rateChanged();
+	void volumeChanged();
+	void positionChanged();
+	void metadataChanged();
+	void readyChanged();
+
+private slots:
+	void onGetAllFinished();
+	void onPositionChanged();
+	void onPlaybackStatusChanged();
+	void onRateChanged();
+	void onMetadataChanged();
+	void onSeeked(qlonglong position);
+
+private:
+	// microseconds, as used by mpris
+	[[nodiscard]] qlonglong positionUs() const;
+	// restarts extrapolation from the current position
+	void rebasePosition(qlonglong positionUs);
+	void requestPosition();
+
+	QString mDbusName;
+	DBusMprisPlayerApp* app = nullptr;
+	DBusMprisPlayer* player = nullptr;
+
+	MprisPlaybackState::Enum mPlaybackState = MprisPlaybackState::Stopped;
+	QString mTrackId;
+	qlonglong mLengthUs = 0;
+
+	// last position reported by the player and when it was received
+	qlonglong positionBaseUs = 0;
+	qreal positionRate = 1;
+	QElapsedTimer positionTimer;
+
+	bool mReady = false;
+};
+
+} // namespace qs::service::mpris
@@ -0,0 +1,194 @@
+#include "mpris.hpp"
+
+#include <qcontainerfwd.h>
+#include <qdbusconnection.h>
+#include <qdbusextratypes.h>
+#include <qdbusmessage.h>
+#include <qobject.h>
+#include <qprocess.h>
+#include <qstandardpaths.h>
+#include <qtest.h>
+#include <qtestcase.h>
+#include <qtypes.h>
+#include <qvariant.h>
+
+#include "../../../core/model.hpp"
+#include "../player.hpp"
+#include "../watcher.hpp"
+
+using namespace qs::service::mpris;
+
+namespace {
+
+constexpr const char* PATH = "/org/mpris/MediaPlayer2";
+constexpr const char* FIRST = "org.mpris.MediaPlayer2.first";
+constexpr const char* SECOND = "org.mpris.MediaPlayer2.second";
+
+QDBusConnection serverConnection() {
+	static auto connection = [] {
+		auto address = qEnvironmentVariable("DBUS_SESSION_BUS_ADDRESS");
+		return QDBusConnection::connectToBus(address, "quickshell-test-server");
+	}();
+
+	return connection;
+}
+
+void sendPropertiesChanged(const QVariantMap& changed) {
+	auto signal =
+	    QDBusMessage::createSignal(PATH, "org.freedesktop.DBus.Properties", "PropertiesChanged");
+
+	signal << "org.mpris.MediaPlayer2.Player" << changed << QStringList();
+	serverConnection().send(signal);
+}
+
+QVariantMap trackMetadata(const QString& trackId) {
+	return {
+	    {"mpris:trackid", QVariant::fromValue(QDBusObjectPath(trackId))},
+	    {"mpris:length", 300000000ll},
+	    {"xesam:title", "Track"},
+	    {"xesam:artist", QStringList {"First", "Second"}},
+	};
+}
+
+// Exports a mock player under FIRST.
+class MockSession {
+public:
+	MockSession() {
+		this->player->mMetadata = trackMetadata("/track/1");
+
+		auto connection = serverConnection();
+		connection.registerObject(PATH, &this->object, QDBusConnection::ExportAdaptors);
+		connection.registerService(FIRST);
+	}
+
+	~MockSession() {
+		auto connection = serverConnection();
+		connection.unregisterService(FIRST);
+		connection.unregisterObject(PATH);
+	}
+
+	Q_DISABLE_COPY_MOVE(MockSession);
+
+	QObject object;
+	MockAppAdaptor* app = new MockAppAdaptor(&this->object);
+	MockPlayerAdaptor* player = new MockPlayerAdaptor(&this->object);
+};
+
+MprisPlayer* firstPlayer(const MprisWatcher& watcher) {
+	auto players = watcher.players.valueList();
+	return players.isEmpty() ? nullptr : players.first();
+}
+
+} // namespace
+
+qlonglong MockPlayerAdaptor::position() const {
+	this->positionReads++;
+	return this->mPosition;
+}
+
+void TestMpris::initTestCase() { // NOLINT
+	auto daemonPath = QStandardPaths::findExecutable("dbus-daemon");
+	if (daemonPath.isEmpty()) QSKIP("dbus-daemon is not installed");
+
+	this->daemon.start(daemonPath, {"--session", "--nofork", "--print-address"});
+	QVERIFY(this->daemon.waitForStarted());
+	QTRY_VERIFY(this->daemon.canReadLine());
+
+	auto address = QString::fromUtf8(this->daemon.readLine()).trimmed();
+
+	// must be set before anything connects to the session bus
+	qputenv("DBUS_SESSION_BUS_ADDRESS", address.toUtf8());
+	QVERIFY(QDBusConnection::sessionBus().isConnected());
+	QVERIFY(serverConnection().isConnected());
+}
+
+void TestMpris::cleanupTestCase() { // NOLINT
+	QDBusConnection::disconnectFromBus("quickshell-test-server");
+	this->daemon.kill();
+	this->daemon.waitForFinished();
+}
+
+void TestMpris::playerDiscovery() { // NOLINT
+	auto mock = MockSession();
+	auto watcher = MprisWatcher(QDBusConnection::sessionBus());
+
+	// present before the watcher
+	QTRY_COMPARE(watcher.players.valueList().length(), static_cast<qsizetype>(1));
+	QCOMPARE(firstPlayer(watcher)->dbusName(), QString(FIRST));
+	QTRY_COMPARE(firstPlayer(watcher)->identity(), QString("Mock Player"));
+
+	// appears after the watcher
+	auto connection = serverConnection();
+	QVERIFY(connection.registerService(SECOND));
+	QVERIFY(connection.registerService("org.quickshell.NotAPlayer"));
+	QTRY_COMPARE(watcher.players.valueList().length(), static_cast<qsizetype>(2));
+
+	QVERIFY(connection.unregisterService(FIRST));
+	QTRY_COMPARE(watcher.players.valueList().length(), static_cast<qsizetype>(1));
+	QCOMPARE(firstPlayer(watcher)->dbusName(), QString(SECOND));
+
+	connection.unregisterService(SECOND);
+	connection.unregisterService("org.quickshell.NotAPlayer");
+	QTRY_COMPARE(watcher.players.valueList().length(), static_cast<qsizetype>(0));
+}
+
+void TestMpris::positionExtrapolation() { // NOLINT
+	auto mock = MockSession();
+	auto watcher = MprisWatcher(QDBusConnection::sessionBus());
+
+	QTRY_VERIFY(firstPlayer(watcher) != nullptr);
+	auto* player = firstPlayer(watcher);
+
+	QCOMPARE(player->playbackState(), MprisPlaybackState::Playing);
+	QCOMPARE(player->trackTitle(), QString("Track"));
+	QCOMPARE(player->trackArtists(), QString("First, Second"));
+	QCOMPARE(player->length(), 300.0);
+
+	auto reads = mock.player->positionReads;
+	auto start = player->position();
+	QVERIFY(start >= 10.0);
+
+	QTest::qWait(300);
+	QVERIFY(player->position() >= start + 0.25);
+	QVERIFY(player->position() < start + 1);
+
+	// the position moved without asking the player
+	QCOMPARE(mock.player->positionReads, reads);
+
+	// Seeked carries its position, so it doesn't need a read either
+	emit mock.player->Seeked(60000000);
+	QTRY_VERIFY(player->position() >= 60.0);
+	QVERIFY(player->position() < 61.0);
+	QCOMPARE(mock.player->positionReads, reads);
+}
+
+void TestMpris::positionResync() { // NOLINT
+	auto mock = MockSession();
+	auto watcher = MprisWatcher(QDBusConnection::sessionBus());
+
+	QTRY_VERIFY(firstPlayer(watcher) != nullptr);
+	auto* player = firstPlayer(watcher);
+	auto reads = mock.player->positionReads;
+
+	// pausing reads the position the player stopped at
+	mock.player->mPlaybackStatus = "Paused";
+	mock.player->mPosition = 20000000;
+	sendPropertiesChanged({{"PlaybackStatus", "Paused"}});
+
+	QTRY_COMPARE(player->playbackState(), MprisPlaybackState::Paused);
+	QTRY_COMPARE(player->position(), 20.0);
+	QCOMPARE(mock.player->positionReads, reads + 1);
+
+	QTest::qWait(100);
+	QCOMPARE(player->position(), 20.0);
+
+	// so does changing tracks
+	mock.player->mPosition = 0;
+	mock.player->mMetadata = trackMetadata("/track/2");
+	sendPropertiesChanged({{"Metadata", mock.player->mMetadata}});
+
+	QTRY_COMPARE(player->position(), 0.0);
+	QCOMPARE(mock.player->positionReads, reads + 2);
+}
+
+QTEST_MAIN(TestMpris);
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <qcontainerfwd.h>
+#include <qdbusabstractadaptor.h>
+#include <qobject.h>
+#include <qprocess.h>
+#include <qtmetamacros.h>
+#include <qtypes.h>
+
+// Stands in for the org.mpris.MediaPlayer2 interface of a player.
+class MockAppAdaptor: public QDBusAbstractAdaptor {
+	Q_OBJECT;
+	Q_CLASSINFO("D-Bus Interface", "org.mpris.MediaPlayer2");
+	Q_PROPERTY(QString Identity READ identity);
+	Q_PROPERTY(bool CanQuit READ canQuit);
+	Q_PROPERTY(bool CanRaise READ canRaise);
+
+public:
+	explicit MockAppAdaptor(QObject* parent): QDBusAbstractAdaptor(parent) {}
+
+	[[nodiscard]] QString identity() const { return "Mock Player"; }
+	[[nodiscard]] bool canQuit() const { return false; }
+	[[nodiscard]] bool canRaise() const { return false; }
+};
+
+// Stands in for the org.mpris.MediaPlayer2.Player interface of a player.
+class MockPlayerAdaptor: public QDBusAbstractAdaptor {
+	Q_OBJECT;
+	Q_CLASSINFO("D-Bus Interface", "org.mpris.MediaPlayer2.Player");
+	Q_PROPERTY(QString PlaybackStatus READ playbackStatus);
+	Q_PROPERTY(double Rate READ rate);
+	Q_PROPERTY(qlonglong Position READ position);
+	Q_PROPERTY(QVariantMap Metadata READ metadata);
+	Q_PROPERTY(bool CanControl READ canControl);
+	Q_PROPERTY(bool CanSeek READ canControl);
+
+public:
+	explicit MockPlayerAdaptor(QObject* parent): QDBusAbstractAdaptor(parent) {}
+
+	[[nodiscard]] QString playbackStatus() const { return this->mPlaybackStatus; }
+	[[nodiscard]] double rate() const { return this->mRate; }
+	[[nodiscard]] qlonglong position() const;
+	[[nodiscard]] QVariantMap metadata() const { return this->mMetadata; }
+	[[nodiscard]] bool canControl() const { return true; }
+
+	QString mPlaybackStatus = "Playing";
+	double mRate = 1;
+	qlonglong mPosition = 10000000;
+	QVariantMap mMetadata;
+
+	// number of times Position has been read
+	mutable qint32 positionReads = 0;
+
+signals:
+	void Seeked(qlonglong position); // NOLINT
+};
+
+class TestMpris: public QObject {
+	Q_OBJECT;
+
+private slots:
+	void initTestCase();
+	void cleanupTestCase();
+	void playerDiscovery();
+	void positionExtrapolation();
+	void positionResync();
+
+private:
+	QProcess daemon;
+};
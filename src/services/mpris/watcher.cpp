@@ -0,0 +1,120 @@
+#include "watcher.hpp"
+
+#include <qcontainerfwd.h>
+#include <qdbusconnection.h>
+#include <qdbusconnectioninterface.h>
+#include <qdbuspendingcall.h>
+#include <qdbuspendingreply.h>
+#include <qdbusservicewatcher.h>
+#include <qlogging.h>
+#include <qloggingcategory.h>
+#include <qobject.h>
+#include <qstring.h>
+
+#include "../../core/model.hpp"
+#include "player.hpp"
+
+Q_LOGGING_CATEGORY(logMprisWatcher, "quickshell.service.mpris.watcher", QtWarningMsg);
+
+namespace qs::service::mpris {
+
+namespace {
+constexpr const char* PLAYER_PREFIX = "org.mpris.MediaPlayer2.";
+}
+
+MprisWatcher::MprisWatcher(const QDBusConnection& connection, QObject* parent)
+    : QObject(parent)
+    , connection(connection) {
+	if (!connection.isConnected()) {
+		qCWarning(logMprisWatcher) << "Could not connect to DBus. Mpris service will not work.";
+		return;
+	}
+
+	// a single match on the whole namespace instead of polling ListNames
+	this->serviceWatcher.setWatchMode(QDBusServiceWatcher::WatchForOwnerChange);
+	this->serviceWatcher.addWatchedService("org.mpris.MediaPlayer2.*");
+	this->serviceWatcher.setConnection(connection);
+
+	QObject::connect(
+	    &this->serviceWatcher,
+	    &QDBusServiceWatcher::serviceOwnerChanged,
+	    this,
+	    &MprisWatcher::onServiceOwnerChanged
+	);
+
+	auto pendingCall = connection.interface()->asyncCall("ListNames");
+	auto* call = new QDBusPendingCallWatcher(pendingCall, this);
+
+	auto responseCallback = [this](QDBusPendingCallWatcher* call) {
+		const QDBusPendingReply<QStringList> reply = *call;
+
+		if (reply.isError()) {
+			qCWarning(logMprisWatcher) << "Failed to list bus names:" << reply.error().message();
+		} else {
+			for (const auto& service: reply.value()) {
+				if (service.startsWith(PLAYER_PREFIX)) this->registerPlayer(service);
+			}
+		}
+
+		delete call;
+	};
+
+	QObject::connect(call, &QDBusPendingCallWatcher::finished, this, responseCallback);
+}
+
+void MprisWatcher::onServiceOwnerChanged(
+    const QString& service,
+    const QString& oldOwner,
+    const QString& newOwner
+) {
+	if (!service.startsWith(PLAYER_PREFIX)) return;
+
+	// a new owner is a different player, even though the name is the same
+	if (!oldOwner.isEmpty()) this->removePlayer(service);
+	if (!newOwner.isEmpty()) this->registerPlayer(service);
+}
+
+void MprisWatcher::onPlayerReady() {
+	auto* player = qobject_cast<MprisPlayer*>(this->sender());
+	if (player == nullptr || this->mPlayers.value(player->dbusName()) != player) return;
+
+	this->players.insertObject(player);
+}
+
+void MprisWatcher::registerPlayer(const QString& service) {
+	if (this->mPlayers.contains(service)) return;
+
+	auto* player = new MprisPlayer(this->connection, service, this);
+
+	if (!player->isValid()) {
+		delete player;
+		return;
+	}
+
+	qCDebug(logMprisWatcher) << "Player" << service << "registered.";
+	this->mPlayers.insert(service, player);
+
+	// players are only shown once they have something to show
+	QObject::connect(player, &MprisPlayer::readyChanged, this, &MprisWatcher::onPlayerReady);
+}
+
+void MprisWatcher::removePlayer(const QString& service) {
+	auto* player = this->mPlayers.take(service);
+	if (player == nullptr) return;
+
+	qCDebug(logMprisWatcher) << "Player" << service << "unregistered.";
+	this->players.removeObject(player);
+	delete player;
+}
+
+MprisWatcher* MprisWatcher::instance() {
+	static MprisWatcher* instance = nullptr; // NOLINT
+	if (instance == nullptr) instance = new MprisWatcher(QDBusConnection::sessionBus());
+	return instance;
+}
+
+} // namespace qs::service::mpris
+
+UntypedObjectModel* MprisQml::players() const {
+	return &qs::service::mpris::MprisWatcher::instance()->players;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <qdbusconnection.h>
+#include <qdbusservicewatcher.h>
+#include <qhash.h>
+#include <qloggingcategory.h>
+#include <qobject.h>
+#include <qqmlintegration.h>
+#include <qtmetamacros.h>
+
+#include "../../core/model.hpp"
+#include "player.hpp"
+
+Q_DECLARE_LOGGING_CATEGORY(logMprisWatcher);
+
+namespace qs::service::mpris {
+
+// Tracks every bus name under org.mpris.MediaPlayer2, shared by every engine generation.
+//
+// Players are found once with ListNames, then followed through NameOwnerChanged.
+class MprisWatcher: public QObject {
+	Q_OBJECT;
+
+public:
+	explicit MprisWatcher(const QDBusConnection& connection, QObject* parent = nullptr);
+
+	// uses the session bus
+	static MprisWatcher* instance();
+
+	ObjectModel<MprisPlayer> players {this};
+
+private slots:
+	void onServiceOwnerChanged(
+	    const QString& service,
+	    const QString& oldOwner,
+	    const QString& newOwner
+	);
+
+	void onPlayerReady();
+
+private:
+	void registerPlayer(const QString& service);
+	void removePlayer(const QString& service);
+
+	QDBusConnection connection;
+	QDBusServiceWatcher serviceWatcher;
+	// includes players which are still reading their initial properties
+	QHash<QString, MprisPlayer*> mPlayers;
+};
+
+} // namespace qs::service::mpris
+
+///! Provides access to MprisPlayers.
+/// Media players exposed over [MPRIS].
+///
+/// Players are added and removed as they appear and disappear on the session bus.
+///
+/// [MPRIS]: https://specifications.freedesktop.org/mpris-spec/latest/
+class MprisQml: public QObject {
+	Q_OBJECT;
+	/// All connected MPRIS players.
+	Q_PROPERTY(UntypedObjectModel* players READ players CONSTANT);
+	QML_NAMED_ELEMENT(Mpris);
+	QML_SINGLETON;
+
+public:
+	explicit MprisQml(QObject* parent = nullptr): QObject(parent) {}
+
+	[[nodiscard]] UntypedObjectModel* players() const;
+};
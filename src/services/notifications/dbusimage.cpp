@@ -0,0 +1,73 @@
+#include "dbusimage.hpp"
+
+#include <qdbusargument.h>
+#include <qdebug.h>
+#include <qimage.h>
+#include <qtypes.h>
+
+QImage DBusNotificationImage::createImage() const {
+	// unlike the ARGB32 pixmaps of StatusNotifierItems, image-data is in byte order,
+	// which QImage can use in place on any host byte order
+	if (this->bitsPerSample != 8) return QImage();
+
+	QImage::Format format; // NOLINT
+	if (this->hasAlpha && this->channels == 4) format = QImage::Format_RGBA8888;
+	else if (!this->hasAlpha && this->channels == 3) format = QImage::Format_RGB888;
+	else return QImage();
+
+	if (this->width <= 0 || this->height <= 0) return QImage();
+
+	// sizes come from the sender, so they are computed wide enough not to overflow
+	auto rowBytes = static_cast<qsizetype>(this->width) * this->channels;
+	if (this->rowStride < rowBytes) return QImage();
+
+	auto required = static_cast<qsizetype>(this->rowStride) * (this->height - 1) + rowBytes;
+
+	if (this->data.size() < required) return QImage();
+
+	// holds a reference to the implicitly shared buffer until the image is destroyed
+	auto* buffer = new QByteArray(this->data);
+
+	return QImage(
+	    reinterpret_cast<const uchar*>(buffer->constData()), // NOLINT
+	    this->width,
+	    this->height,
+	    this->rowStride,
+	    format,
+	    [](void* ptr) { delete reinterpret_cast<QByteArray*>(ptr); }, // NOLINT
+	    buffer
+	);
+}
+
+const QDBusArgument& operator>>(const QDBusArgument& argument, DBusNotificationImage& image) {
+	argument.beginStructure();
+	argument >> image.width;
+	argument >> image.height;
+	argument >> image.rowStride;
+	argument >> image.hasAlpha;
+	argument >> image.bitsPerSample;
+	argument >> image.channels;
+	argument >> image.data;
+	argument.endStructure();
+	return argument;
+}
+
+const QDBusArgument& operator<<(QDBusArgument& argument, const DBusNotificationImage& image) {
+	argument.beginStructure();
+	argument << image.width;
+	argument << image.height;
+	argument << image.rowStride;
+	argument << image.hasAlpha;
+	argument << image.bitsPerSample;
+	argument << image.channels;
+	argument << image.data;
+	argument.endStructure();
+	return argument;
+}
+
+QDebug operator<<(QDebug debug, const DBusNotificationImage& image) {
+	debug.nospace() << "DBusNotificationImage(width=" << image.width << ", height=" << image.height
+	                << ", channels=" << image.channels << ", hasAlpha=" << image.hasAlpha << ")";
+
+	return debug;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <qdbusargument.h>
+#include <qdebug.h>
+#include <qimage.h>
+#include <qmetatype.h>
+#include <qtypes.h>
+
+// Image sent in the `image-data` hint of a notification.
+struct DBusNotificationImage {
+	qint32 width = 0;
+	qint32 height = 0;
+	qint32 rowStride = 0;
+	bool hasAlpha = false;
+	qint32 bitsPerSample = 0;
+	qint32 channels = 0;
+	QByteArray data;
+
+	// The image shares the buffer of `data` instead of copying it, and keeps it alive
+	// on its own. Returns a null image if the format is unsupported or the data is short.
+	[[nodiscard]] QImage createImage() const;
+};
+
+const QDBusArgument& operator>>(const QDBusArgument& argument, DBusNotificationImage& image);
+const QDBusArgument& operator<<(QDBusArgument& argument, const DBusNotificationImage& image);
+
+QDebug operator<<(QDebug debug, const DBusNotificationImage& image);
+
+Q_DECLARE_METATYPE(DBusNotificationImage);
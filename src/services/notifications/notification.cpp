@@ -0,0 +1,231 @@
+#include "notification.hpp"
+
+#include <qcontainerfwd.h>
+#include <qdbusargument.h>
+#include <qimage.h>
+#include <qlogging.h>
+#include <qloggingcategory.h>
+#include <qnamespace.h>
+#include <qobject.h>
+#include <qqmllist.h>
+#include <qsize.h>
+#include <qstring.h>
+#include <qtypes.h>
+#include <qvariant.h>
+
+#include "dbusimage.hpp"
+#include "server.hpp"
+
+namespace qs::service::notifications {
+
+QImage NotificationImage::requestImage(
+    const QString& /*unused*/,
+    QSize* size,
+    const QSize& requestedSize
+) {
+	auto image = this->image;
+
+	if (!image.isNull() && requestedSize.isValid() && requestedSize != image.size()) {
+		image = image.scaled(requestedSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+	}
+
+	if (size != nullptr) *size = image.size();
+	return image;
+}
+
+void NotificationAction::invoke() { emit this->invoked(this->mIdentifier); }
+
+Notification::Notification(quint32 id, NotificationServer* server)
+    : QObject(server)
+    , mId(id)
+    , server(server) {
+	this->expireTimer.setSingleShot(true);
+	QObject::connect(&this->expireTimer, &QTimer::timeout, this, &Notification::expire);
+}
+
+void Notification::dismiss() { this->server->close(this, NotificationCloseReason::Dismissed); }
+void Notification::expire() { this->server->close(this, NotificationCloseReason::Expired); }
+
+void Notification::update(
+    const QString& appName,
+    const QString& appIcon,
+    const QString& summary,
+    const QString& body,
+    const QStringList& actions,
+    const QVariantMap& hints,
+    qint32 expireTimeout
+) {
+	if (appName != this->mAppName) {
+		this->mAppName = appName;
+		emit this->appNameChanged();
+	}
+
+	if (appIcon != this->mAppIcon) {
+		this->mAppIcon = appIcon;
+		emit this->appIconChanged();
+	}
+
+	if (summary != this->mSummary) {
+		this->mSummary = summary;
+		emit this->summaryChanged();
+	}
+
+	if (body != this->mBody) {
+		this->mBody = body;
+		emit this->bodyChanged();
+	}
+
+	if (expireTimeout != this->mExpireTimeout) {
+		this->mExpireTimeout = expireTimeout;
+		emit this->expireTimeoutChanged();
+	}
+
+	// replacing a notification restarts its timeout
+	if (expireTimeout > 0) this->expireTimer.start(expireTimeout);
+	else this->expireTimer.stop();
+
+	auto urgency = NotificationUrgency::Normal;
+	if (hints.contains("urgency")) {
+		auto value = hints.value("urgency").toUInt();
+		if (value <= NotificationUrgency::Critical) {
+			urgency = static_cast<NotificationUrgency::Enum>(value);
+		}
+	}
+
+	if (urgency != this->mUrgency) {
+		this->mUrgency = urgency;
+		emit this->urgencyChanged();
+	}
+
+	auto desktopEntry = hints.value("desktop-entry").toString();
+	if (desktopEntry != this->mDesktopEntry) {
+		this->mDesktopEntry = desktopEntry;
+		emit this->desktopEntryChanged();
+	}
+
+	auto resident = hints.value("resident").toBool();
+	if (resident != this->mResident) {
+		this->mResident = resident;
+		emit this->residentChanged();
+	}
+
+	auto transient = hints.value("transient").toBool();
+	if (transient != this->mTransient) {
+		this->mTransient = transient;
+		emit this->transientChanged();
+	}
+
+	this->updateImage(hints);
+
+	// structured hints are only useful through the properties above
+	auto simpleHints = QVariantMap();
+	for (auto [key, value]: hints.asKeyValueRange()) {
+		if (value.metaType() != QMetaType::fromType<QDBusArgument>()) simpleHints.insert(key, value);
+	}
+
+	if (simpleHints != this->mHints) {
+		this->mHints = simpleHints;
+		emit this->hintsChanged();
+	}
+
+	auto actionsChanged = actions.length() / 2 != this->mActions.length();
+	if (!actionsChanged) {
+		for (auto i = 0; i != this->mActions.length(); i++) {
+			auto* action = this->mActions.at(i);
+			if (action->identifier() != actions.at(i * 2) || action->text() != actions.at(i * 2 + 1)) {
+				actionsChanged = true;
+				break;
+			}
+		}
+	}
+
+	if (actionsChanged) {
+		auto oldActions = this->mActions;
+		this->mActions.clear();
+
+		for (auto i = 0; i + 1 < actions.length(); i += 2) {
+			auto* action = new NotificationAction(actions.at(i), actions.at(i + 1), this);
+			QObject::connect(action, &NotificationAction::invoked, this, &Notification::onActionInvoked);
+			this->mActions.push_back(action);
+		}
+
+		emit this->actionsChanged();
+
+		for (auto* action: oldActions) {
+			action->deleteLater();
+		}
+	}
+}
+
+void Notification::updateImage(const QVariantMap& hints) {
+	QImage image;
+
+	// the spec renamed image-data twice, older names are kept for older clients
+	for (const auto* key: {"image-data", "image_data", "icon_data"}) {
+		auto hint = hints.value(key);
+		if (hint.metaType() != QMetaType::fromType<QDBusArgument>()) continue;
+
+		auto argument = hint.value<QDBusArgument>();
+		if (argument.currentSignature() != "(iiibiiay)") {
+			qCWarning(logNotifications) << "Ignoring" << key << "hint with signature"
+			                            << argument.currentSignature() << "for notification" << this->mId;
+			continue;
+		}
+
+		auto data = qdbus_cast<DBusNotificationImage>(argument);
+		image = data.createImage();
+
+		if (image.isNull()) {
+			qCWarning(logNotifications) << "Ignoring unsupported" << key << data << "for notification"
+			                            << this->mId;
+			continue;
+		}
+
+		break;
+	}
+
+	auto imagePath = hints.value("image-path", hints.value("image_path")).toString();
+
+	auto changed = imagePath != this->mImagePath;
+	this->mImagePath = imagePath;
+
+	if (!image.isNull() || !this->mImage.image.isNull()) {
+		this->mImage.image = image;
+		this->imageIndex++;
+		changed = true;
+	}
+
+	if (changed) emit this->imageChanged();
+}
+
+QString Notification::image() const {
+	if (!this->mImage.image.isNull()) {
+		return this->mImage.url() + "/" + QString::number(this->imageIndex);
+	}
+
+	return this->mImagePath;
+}
+
+QQmlListProperty<NotificationAction> Notification::actions() {
+	return QQmlListProperty<NotificationAction>(
+	    this,
+	    nullptr,
+	    &Notification::actionsCount,
+	    &Notification::actionAt
+	);
+}
+
+qsizetype Notification::actionsCount(QQmlListProperty<NotificationAction>* property) {
+	return reinterpret_cast<Notification*>(property->object)->mActions.count(); // NOLINT
+}
+
+NotificationAction*
+Notification::actionAt(QQmlListProperty<NotificationAction>* property, qsizetype index) {
+	return reinterpret_cast<Notification*>(property->object)->mActions.at(index); // NOLINT
+}
+
+void Notification::onActionInvoked(const QString& identifier) {
+	this->server->invokeAction(this, identifier);
+}
+
+} // namespace qs::service::notifications
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <utility>
+
+#include <qcontainerfwd.h>
+#include <qimage.h>
+#include <qlist.h>
+#include <qobject.h>
+#include <qqmlintegration.h>
+#include <qqmllist.h>
+#include <qtimer.h>
+#include <qtmetamacros.h>
+#include <qtypes.h>
+
+#include "../../core/imageprovider.hpp"
+
+namespace qs::service::notifications {
+
+class NotificationServer;
+
+namespace NotificationUrgency { // NOLINT
+Q_NAMESPACE;
+QML_ELEMENT;
+
+enum Enum {
+	Low = 0,
+	Normal = 1,
+	Critical = 2,
+};
+Q_ENUM_NS(Enum);
+
+} // namespace NotificationUrgency
+
+namespace NotificationCloseReason { // NOLINT
+Q_NAMESPACE;
+QML_ELEMENT;
+
+enum Enum {
+	/// The notification's timeout ran out.
+	Expired = 1,
+	/// The notification was dismissed by the user.
+	Dismissed = 2,
+	/// The application closed the notification.
+	CloseRequested = 3,
+};
+Q_ENUM_NS(Enum);
+
+} // namespace NotificationCloseReason
+
+class NotificationImage: public QsImageHandle {
+public:
+	explicit NotificationImage(QObject* parent = nullptr)
+	    : QsImageHandle(QQmlImageProviderBase::Image, parent) {}
+
+	QImage requestImage(const QString& id, QSize* size, const QSize& requestedSize) override;
+
+	QImage image;
+};
+
+///! An action button of a notification.
+class NotificationAction: public QObject {
+	Q_OBJECT;
+	/// The key the application uses to identify the action.
+	Q_PROPERTY(QString identifier READ identifier CONSTANT);
+	/// The text to show for the action.
+	Q_PROPERTY(QString text READ text CONSTANT);
+	QML_ELEMENT;
+	QML_UNCREATABLE("NotificationActions can only be acquired from a Notification");
+
+public:
+	explicit NotificationAction(QString identifier, QString text, QObject* parent = nullptr)
+	    : QObject(parent)
+	    , mIdentifier(std::move(identifier))
+	    , mText(std::move(text)) {}
+
+	/// Tell the application the action was chosen.
+	///
+	/// Unless the notification is `resident`, this also dismisses it.
+	Q_INVOKABLE void invoke();
+
+	[[nodiscard]] QString identifier() const { return this->mIdentifier; }
+	[[nodiscard]] QString text() const { return this->mText; }
+
+signals:
+	void invoked(const QString& identifier);
+
+private:
+	QString mIdentifier;
+	QString mText;
+};
+
+///! A notification sent to the notification server.
+/// A notification as described by the [desktop notifications spec].
+///
+/// An application sending a notification with the same id again updates this
+/// object in place, so delegates showing it are kept.
+///
+/// [desktop notifications spec]: https://specifications.freedesktop.org/notification-spec/latest/
+class Notification: public QObject {
+	Q_OBJECT;
+	// clang-format off
+	/// The id of the notification, unique until the server stops.
+	Q_PROPERTY(quint32 id READ id CONSTANT);
+	/// The name of the application which sent the notification.
+	Q_PROPERTY(QString appName READ appName NOTIFY appNameChanged);
+	/// An icon name or `file://` url for the sending application. May be empty.
+	Q_PROPERTY(QString appIcon READ appIcon NOTIFY appIconChanged);
+	Q_PROPERTY(QString summary READ summary NOTIFY summaryChanged);
+	/// The body of the notification, which may contain the simple markup allowed by the spec.
+	Q_PROPERTY(QString body READ body NOTIFY bodyChanged);
+	Q_PROPERTY(qs::service::notifications::NotificationUrgency::Enum urgency READ urgency NOTIFY urgencyChanged);
+	/// The time in milliseconds the application asked for the notification to be shown,
+	/// 0 if it should stay until dismissed, or -1 to leave it up to the shell.
+	///
+	/// The notification expires on its own if this is positive.
+	Q_PROPERTY(qint32 expireTimeout READ expireTimeout NOTIFY expireTimeoutChanged);
+	Q_PROPERTY(QQmlListProperty<qs::service::notifications::NotificationAction> actions READ actions NOTIFY actionsChanged);
+	/// An image to show with the notification, usable as an Image source, or an empty string.
+	///
+	/// Pixel data sent by the application is shown without being copied.
+	Q_PROPERTY(QString image READ image NOTIFY imageChanged);
+	/// The desktop entry of the sending application, without the `.desktop` extension.
+	Q_PROPERTY(QString desktopEntry READ desktopEntry NOTIFY desktopEntryChanged);
+	/// If the notification should not be dismissed when an action is invoked.
+	Q_PROPERTY(bool resident READ resident NOTIFY residentChanged);
+	/// If the notification should not be kept after it is shown.
+	Q_PROPERTY(bool transient READ transient NOTIFY transientChanged);
+	/// All hints sent with the notification which have simple values.
+	Q_PROPERTY(QVariantMap hints READ hints NOTIFY hintsChanged);
+	// clang-format on
+	QML_ELEMENT;
+	QML_UNCREATABLE("Notifications can only be acquired from the NotificationServer");
+
+public:
+	explicit Notification(quint32 id, NotificationServer* server);
+
+	/// Remove the notification as if the user dismissed it.
+	Q_INVOKABLE void dismiss();
+	/// Remove the notification as if it timed out.
+	Q_INVOKABLE void expire();
+
+	void update(
+	    const QString& appName,
+	    const QString& appIcon,
+	    const QString& summary,
+	    const QString& body,
+	    const QStringList& actions,
+	    const QVariantMap& hints,
+	    qint32 expireTimeout
+	);
+
+	[[nodiscard]] quint32 id() const { return this->mId; }
+	[[nodiscard]] QString appName() const { return this->mAppName; }
+	[[nodiscard]] QString appIcon() const { return this->mAppIcon; }
+	[[nodiscard]] QString summary() const { return this->mSummary; }
+	[[nodiscard]] QString body() const { return this->mBody; }
+	[[nodiscard]] NotificationUrgency::Enum urgency() const { return this->mUrgency; }
+	[[nodiscard]] qint32 expireTimeout() const { return this->mExpireTimeout; }
+	[[nodiscard]] QQmlListProperty<NotificationAction> actions();
+	[[nodiscard]] QList<NotificationAction*> actionList() const { return this->mActions; }
+	[[nodiscard]] QString image() const;
+	[[nodiscard]] QImage imageData() const { return this->mImage.image; }
+	[[nodiscard]] QString desktopEntry() const { return this->mDesktopEntry; }
+	[[nodiscard]] bool resident() const { return this->mResident; }
+	[[nodiscard]] bool transient() const { return this->mTransient; }
+	[[nodiscard]] QVariantMap hints() const { return this->mHints; }
+
+signals:
+	/// Sent once the notification has been removed. The object is destroyed afterwards.
+	void closed(qs::service::notifications::NotificationCloseReason::Enum reason);
+
+	void appNameChanged();
+	void appIconChanged();
+	void summaryChanged();
+	void bodyChanged();
+	void urgencyChanged();
+	void expireTimeoutChanged();
+	void actionsChanged();
+	void imageChanged();
+	void desktopEntryChanged();
+	void residentChanged();
+	void transientChanged();
+	void hintsChanged();
+
+private slots:
+	void onActionInvoked(const QString& identifier);
+
+private:
+	void updateImage(const QVariantMap& hints);
+
+	static qsizetype actionsCount(QQmlListProperty<NotificationAction>* property);
+	static NotificationAction*
+	actionAt(QQmlListProperty<NotificationAction>* property, qsizetype index);
+
+	quint32 mId;
+	NotificationServer* server;
+	QString mAppName;
+	QString mAppIcon;
+	QString mSummary;
+	QString mBody;
+	NotificationUrgency::Enum mUrgency = NotificationUrgency::Normal;
+	qint32 mExpireTimeout = -1;
+	QList<NotificationAction*> mActions;
+	// url or path from the image-path hint, used when there is no image data
+	QString mImagePath;
+	NotificationImage mImage {this};
+	// changes the image url when the image changes, as QML caches images by url
+	quint32 imageIndex = 0;
+	QString mDesktopEntry;
+	bool mResident = false;
+	bool mTransient = false;
+	QVariantMap mHints;
+	QTimer expireTimer;
+};
+
+} // namespace qs::service::notifications
@@ -0,0 +1,160 @@
+#include "server.hpp"
+
+#include <qcontainerfwd.h>
+#include <qcoreapplication.h>
+#include <qdbusconnection.h>
+#include <qdbusmetatype.h>
+#include <qlogging.h>
+#include <qloggingcategory.h>
+#include <qobject.h>
+#include <qstring.h>
+#include <qtypes.h>
+
+#include "../../core/model.hpp"
+#include "dbus_notifications.h"
+#include "dbusimage.hpp"
+#include "notification.hpp"
+
+Q_LOGGING_CATEGORY(logNotifications, "quickshell.service.notifications", QtWarningMsg);
+
+namespace qs::service::notifications {
+
+NotificationServer::NotificationServer(const QDBusConnection& connection, QObject* parent)
+    : QObject(parent)
+    , connection(connection) {
+	qDBusRegisterMetaType<DBusNotificationImage>();
+
+	new DBusNotificationServer(this);
+
+	if (!connection.isConnected()) {
+		qCWarning(logNotifications)
+		    << "Could not connect to DBus. Notification service will not work.";
+		return;
+	}
+
+	if (!this->connection.registerObject("/org/freedesktop/Notifications", this)) {
+		qCWarning(logNotifications) << "Could not register notification server object with DBus. "
+		                               "Notification service will not work.";
+		return;
+	}
+
+	if (!this->connection.registerService("org.freedesktop.Notifications")) {
+		qCWarning(logNotifications)
+		    << "Could not register org.freedesktop.Notifications, presumably because another "
+		       "notification daemon is running. Notification service will not work.";
+
+		this->connection.unregisterObject("/org/freedesktop/Notifications");
+		return;
+	}
+
+	qCDebug(logNotifications) << "Registered notification server.";
+	this->registered = true;
+}
+
+NotificationServer::~NotificationServer() {
+	if (!this->registered) return;
+	this->connection.unregisterService("org.freedesktop.Notifications");
+	this->connection.unregisterObject("/org/freedesktop/Notifications");
+}
+
+NotificationServer* NotificationServer::instance() {
+	static NotificationServer* instance = nullptr; // NOLINT
+	if (instance == nullptr) instance = new NotificationServer(QDBusConnection::sessionBus());
+	return instance;
+}
+
+void NotificationServer::close(Notification* notification, NotificationCloseReason::Enum reason) {
+	if (this->mNotifications.take(notification->id()) == nullptr) return;
+
+	qCDebug(logNotifications) << "Closing notification" << notification->id() << "with reason"
+	                          << reason;
+
+	this->notifications.removeObject(notification);
+	emit notification->closed(reason);
+	emit this->NotificationClosed(notification->id(), reason);
+	notification->deleteLater();
+}
+
+void NotificationServer::invokeAction(Notification* notification, const QString& identifier) {
+	if (!this->mNotifications.contains(notification->id())) return;
+
+	emit this->ActionInvoked(notification->id(), identifier);
+
+	if (!notification->resident()) {
+		this->close(notification, NotificationCloseReason::Dismissed);
+	}
+}
+
+QStringList NotificationServer::GetCapabilities() const {
+	return {"actions", "body", "body-markup", "icon-static", "persistence"};
+}
+
+quint32 NotificationServer::Notify(
+    const QString& appName,
+    quint32 replacesId,
+    const QString& appIcon,
+    const QString& summary,
+    const QString& body,
+    const QStringList& actions,
+    const QVariantMap& hints,
+    qint32 expireTimeout
+) {
+	// a replacement updates the existing object, so only its changed properties are reported
+	if (auto* notification = this->mNotifications.value(replacesId)) {
+		qCDebug(logNotifications) << "Replacing notification" << replacesId << "from" << appName;
+		notification->update(appName, appIcon, summary, body, actions, hints, expireTimeout);
+		return replacesId;
+	}
+
+	auto id = this->nextId++;
+	if (this->nextId == 0) this->nextId = 1; // 0 is never a valid id
+
+	qCDebug(logNotifications) << "New notification" << id << "from" << appName;
+
+	auto* notification = new Notification(id, this);
+	notification->update(appName, appIcon, summary, body, actions, hints, expireTimeout);
+
+	this->mNotifications.insert(id, notification);
+	this->notifications.insertObject(notification);
+	emit this->notification(notification);
+
+	return id;
+}
+
+void NotificationServer::CloseNotification(quint32 id) {
+	auto* notification = this->mNotifications.value(id);
+	if (notification == nullptr) return;
+
+	this->close(notification, NotificationCloseReason::CloseRequested);
+}
+
+QString NotificationServer::GetServerInformation(
+    QString& vendor,
+    QString& version,
+    QString& specVersion
+) const {
+	vendor = "quickshell";
+	version = QCoreApplication::applicationVersion();
+	specVersion = "1.2";
+	return "quickshell";
+}
+
+} // namespace qs::service::notifications
+
+using qs::service::notifications::NotificationServer;
+
+NotificationServerQml::NotificationServerQml(QObject* parent): QObject(parent) {
+	auto* server = NotificationServer::instance();
+
+	// clang-format off
+	QObject::connect(server, &NotificationServer::notification, this, &NotificationServerQml::notification);
+	// clang-format on
+}
+
+UntypedObjectModel* NotificationServerQml::notifications() const {
+	return &NotificationServer::instance()->notifications;
+}
+
+bool NotificationServerQml::isRegistered() const {
+	return NotificationServer::instance()->isRegistered();
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <qcontainerfwd.h>
+#include <qdbusconnection.h>
+#include <qhash.h>
+#include <qloggingcategory.h>
+#include <qobject.h>
+#include <qqmlintegration.h>
+#include <qtmetamacros.h>
+#include <qtypes.h>
+
+#include "../../core/model.hpp"
+#include "notification.hpp"
+
+Q_DECLARE_LOGGING_CATEGORY(logNotifications);
+
+namespace qs::service::notifications {
+
+// org.freedesktop.Notifications implementation, shared by every engine generation.
+class NotificationServer: public QObject {
+	Q_OBJECT;
+
+public:
+	explicit NotificationServer(const QDBusConnection& connection, QObject* parent = nullptr);
+	~NotificationServer() override;
+	Q_DISABLE_COPY_MOVE(NotificationServer);
+
+	// uses the session bus
+	static NotificationServer* instance();
+
+	[[nodiscard]] bool isRegistered() const { return this->registered; }
+
+	void close(Notification* notification, NotificationCloseReason::Enum reason);
+	void invokeAction(Notification* notification, const QString& identifier);
+
+	ObjectModel<Notification> notifications {this};
+
+	// NOLINTBEGIN
+	[[nodiscard]] QStringList GetCapabilities() const;
+
+	quint32 Notify(
+	    const QString& appName,
+	    quint32 replacesId,
+	    const QString& appIcon,
+	    const QString& summary,
+	    const QString& body,
+	    const QStringList& actions,
+	    const QVariantMap& hints,
+	    qint32 expireTimeout
+	);
+
+	void CloseNotification(quint32 id);
+	QString GetServerInformation(QString& vendor, QString& version, QString& specVersion) const;
+	// NOLINTEND
+
+signals:
+	void notification(Notification* notification);
+
+	// NOLINTBEGIN
+	void NotificationClosed(quint32 id, quint32 reason);
+	void ActionInvoked(quint32 id, const QString& actionKey);
+	// NOLINTEND
+
+private:
+	QDBusConnection connection;
+	bool registered = false;
+	quint32 nextId = 1;
+	QHash<quint32, Notification*> mNotifications;
+};
+
+} // namespace qs::service::notifications
+
+///! Desktop notification server.
+/// Receives notifications from applications, as described by the [desktop notifications spec].
+///
+/// Referencing the NotificationServer singleton makes quickshell take over the
+/// `org.freedesktop.Notifications` bus name, unless another notification daemon already
+/// holds it.
+///
+/// [desktop notifications spec]: https://specifications.freedesktop.org/notification-spec/latest/
+class NotificationServerQml: public QObject {
+	Q_OBJECT;
+	/// All notifications which have not been closed, oldest first.
+	Q_PROPERTY(UntypedObjectModel* notifications READ notifications CONSTANT);
+	/// If the server holds the `org.freedesktop.Notifications` bus name.
+	Q_PROPERTY(bool registered READ isRegistered CONSTANT);
+	QML_NAMED_ELEMENT(NotificationServer);
+	QML_SINGLETON;
+
+public:
+	explicit NotificationServerQml(QObject* parent = nullptr);
+
+	[[nodiscard]] UntypedObjectModel* notifications() const;
+	[[nodiscard]] bool isRegistered() const;
+
+signals:
+	/// Sent when a new notification arrives. Replacements of existing notifications
+	/// update the existing object instead.
+	void notification(qs::service::notifications::Notification* notification);
+};
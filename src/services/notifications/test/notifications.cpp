@@ -0,0 +1,282 @@
+#include "notifications.hpp"
+
+#include <qcolor.h>
+#include <qcontainerfwd.h>
+#include <qdbusconnection.h>
+#include <qdbusmessage.h>
+#include <qdbuspendingcall.h>
+#include <qdbuspendingreply.h>
+#include <qimage.h>
+#include <qobject.h>
+#include <qprocess.h>
+#include <qsignalspy.h>
+#include <qsize.h>
+#include <qstandardpaths.h>
+#include <qtest.h>
+#include <qtestcase.h>
+#include <qtypes.h>
+#include <qvariant.h>
+
+#include "../dbusimage.hpp"
+#include "../notification.hpp"
+#include "../server.hpp"
+
+using namespace qs::service::notifications;
+
+namespace {
+
+QDBusConnection serverConnection() {
+	static auto connection = [] {
+		auto address = qEnvironmentVariable("DBUS_SESSION_BUS_ADDRESS");
+		return QDBusConnection::connectToBus(address, "quickshell-test-server");
+	}();
+
+	return connection;
+}
+
+// The server runs on the same thread, so calls to it can't block.
+QDBusPendingReply<quint32> sendNotify(
+    const QString& summary,
+    quint32 replacesId = 0,
+    const QStringList& actions = {},
+    const QVariantMap& hints = {},
+    qint32 expireTimeout = -1
+) {
+	auto message = QDBusMessage::createMethodCall(
+	    "org.freedesktop.Notifications",
+	    "/org/freedesktop/Notifications",
+	    "org.freedesktop.Notifications",
+	    "Notify"
+	);
+
+	message << QString("test-app") << replacesId << QString("test-icon") << summary
+	        << QString("Body") << actions << hints << expireTimeout;
+
+	return QDBusConnection::sessionBus().asyncCall(message);
+}
+
+void sendClose(quint32 id) {
+	auto message = QDBusMessage::createMethodCall(
+	    "org.freedesktop.Notifications",
+	    "/org/freedesktop/Notifications",
+	    "org.freedesktop.Notifications",
+	    "CloseNotification"
+	);
+
+	message << id;
+	QDBusConnection::sessionBus().asyncCall(message);
+}
+
+// 2x1 RGBA image with padded rows.
+DBusNotificationImage testImage() {
+	auto image = DBusNotificationImage();
+	image.width = 2;
+	image.height = 1;
+	image.rowStride = 12;
+	image.hasAlpha = true;
+	image.bitsPerSample = 8;
+	image.channels = 4;
+	image.data = QByteArray("\xff\x00\x00\xff\x00\x00\xff\x80\x00\x00\x00\x00", 12);
+	return image;
+}
+
+} // namespace
+
+void TestNotifications::initTestCase() { // NOLINT
+	auto daemonPath = QStandardPaths::findExecutable("dbus-daemon");
+	if (daemonPath.isEmpty()) QSKIP("dbus-daemon is not installed");
+
+	this->daemon.start(daemonPath, {"--session", "--nofork", "--print-address"});
+	QVERIFY(this->daemon.waitForStarted());
+	QTRY_VERIFY(this->daemon.canReadLine());
+
+	auto address = QString::fromUtf8(this->daemon.readLine()).trimmed();
+
+	// must be set before anything connects to the session bus
+	qputenv("DBUS_SESSION_BUS_ADDRESS", address.toUtf8());
+	QVERIFY(QDBusConnection::sessionBus().isConnected());
+	QVERIFY(serverConnection().isConnected());
+}
+
+void TestNotifications::cleanupTestCase() { // NOLINT
+	QDBusConnection::disconnectFromBus("quickshell-test-server");
+	this->daemon.kill();
+	this->daemon.waitForFinished();
+}
+
+void TestNotifications::notify() { // NOLINT
+	auto server = NotificationServer(serverConnection());
+	QVERIFY(server.isRegistered());
+
+	auto hints = QVariantMap {
+	    {"urgency", QVariant::fromValue(static_cast<uchar>(2))},
+	    {"desktop-entry", "test-app"},
+	    {"x-custom", "value"},
+	};
+
+	auto reply = sendNotify("Summary", 0, {"default", "Open", "later", "Later"}, hints);
+	QTRY_VERIFY(reply.isFinished());
+	QVERIFY(reply.isValid());
+
+	QCOMPARE(server.notifications.valueList().length(), static_cast<qsizetype>(1));
+	auto* notification = server.notifications.valueList().at(0);
+
+	QCOMPARE(notification->id(), reply.value());
+	QCOMPARE(notification->appName(), QString("test-app"));
+	QCOMPARE(notification->appIcon(), QString("test-icon"));
+	QCOMPARE(notification->summary(), QString("Summary"));
+	QCOMPARE(notification->body(), QString("Body"));
+	QCOMPARE(notification->urgency(), NotificationUrgency::Critical);
+	QCOMPARE(notification->desktopEntry(), QString("test-app"));
+	QCOMPARE(notification->hints().value("x-custom"), QVariant("value"));
+	QVERIFY(notification->image().isEmpty());
+
+	auto actions = notification->actionList();
+	QCOMPARE(actions.length(), static_cast<qsizetype>(2));
+	QCOMPARE(actions.at(0)->identifier(), QString("default"));
+	QCOMPARE(actions.at(1)->text(), QString("Later"));
+}
+
+void TestNotifications::replace() { // NOLINT
+	auto server = NotificationServer(serverConnection());
+
+	auto reply = sendNotify("First");
+	QTRY_VERIFY(reply.isFinished());
+	auto id = reply.value();
+	auto* notification = server.notifications.valueList().at(0);
+
+	auto inserted = QSignalSpy(&server.notifications, &UntypedObjectModel::rowsInserted);
+	auto newNotifications = QSignalSpy(&server, &NotificationServer::notification);
+	auto summaryChanged = QSignalSpy(notification, &Notification::summaryChanged);
+	auto appNameChanged = QSignalSpy(notification, &Notification::appNameChanged);
+
+	reply = sendNotify("Second", id);
+	QTRY_VERIFY(reply.isFinished());
+
+	// the same object is updated in place, so views keep their delegate
+	QCOMPARE(reply.value(), id);
+	QCOMPARE(server.notifications.valueList().length(), static_cast<qsizetype>(1));
+	QCOMPARE(server.notifications.valueList().at(0), notification);
+	QCOMPARE(notification->summary(), QString("Second"));
+	QCOMPARE(inserted.count(), 0);
+	QCOMPARE(newNotifications.count(), 0);
+	QCOMPARE(summaryChanged.count(), 1);
+	QCOMPARE(appNameChanged.count(), 0);
+
+	// unknown ids get a new notification
+	reply = sendNotify("Third", 12345);
+	QTRY_VERIFY(reply.isFinished());
+	QVERIFY(reply.value() != 12345);
+	QCOMPARE(server.notifications.valueList().length(), static_cast<qsizetype>(2));
+}
+
+void TestNotifications::createImage() { // NOLINT
+	auto data = testImage();
+	auto image = data.createImage();
+
+	QVERIFY(!image.isNull());
+	QCOMPARE(image.size(), QSize(2, 1));
+	QCOMPARE(image.pixelColor(0, 0), QColor(255, 0, 0, 255));
+	QCOMPARE(image.pixelColor(1, 0), QColor(0, 0, 255, 128));
+
+	// the pixels are used from the received buffer, not copied
+	QCOMPARE(image.constBits(), reinterpret_cast<const uchar*>(data.data.constData())); // NOLINT
+
+	// and the image keeps the buffer alive on its own
+	data.data.clear();
+	QCOMPARE(image.pixelColor(0, 0), QColor(255, 0, 0, 255));
+
+	auto rgb = testImage();
+	rgb.hasAlpha = false;
+	rgb.channels = 3;
+	rgb.rowStride = 6;
+	rgb.data = QByteArray("\x00\xff\x00\x00\x00\xff", 6);
+	image = rgb.createImage();
+	QCOMPARE(image.pixelColor(0, 0), QColor(0, 255, 0));
+
+	auto shortData = testImage();
+	shortData.data.truncate(6);
+	QVERIFY(shortData.createImage().isNull());
+
+	auto wideSamples = testImage();
+	wideSamples.bitsPerSample = 16;
+	QVERIFY(wideSamples.createImage().isNull());
+}
+
+void TestNotifications::imageHint() { // NOLINT
+	auto server = NotificationServer(serverConnection());
+
+	auto reply = sendNotify("Image", 0, {}, {{"image-data", QVariant::fromValue(testImage())}});
+	QTRY_VERIFY(reply.isFinished());
+	QVERIFY(reply.isValid());
+
+	auto* notification = server.notifications.valueList().at(0);
+	QVERIFY(notification->image().startsWith("image://qsimage/"));
+	QCOMPARE(notification->imageData().pixelColor(1, 0), QColor(0, 0, 255, 128));
+	QVERIFY(!notification->hints().contains("image-data"));
+
+	// a changed image gets a new url so QML doesn't show the cached one
+	auto url = notification->image();
+	auto hints = QVariantMap {{"image-data", QVariant::fromValue(testImage())}};
+	reply = sendNotify("Image", reply.value(), {}, hints);
+	QTRY_VERIFY(reply.isFinished());
+	QVERIFY(notification->image() != url);
+
+	// image-path is used without image data
+	reply = sendNotify("Image", reply.value(), {}, {{"image-path", "/tmp/image.png"}});
+	QTRY_VERIFY(reply.isFinished());
+	QCOMPARE(notification->image(), QString("/tmp/image.png"));
+	QVERIFY(notification->imageData().isNull());
+}
+
+void TestNotifications::closeNotification() { // NOLINT
+	auto server = NotificationServer(serverConnection());
+	auto closedSpy = QSignalSpy(&server, &NotificationServer::NotificationClosed);
+
+	auto reply = sendNotify("Close");
+	QTRY_VERIFY(reply.isFinished());
+	auto* notification = server.notifications.valueList().at(0);
+	auto objectClosed = QSignalSpy(notification, &Notification::closed);
+
+	sendClose(reply.value());
+
+	QTRY_COMPARE(closedSpy.count(), 1);
+	QCOMPARE(closedSpy.at(0).at(0).toUInt(), reply.value());
+	QCOMPARE(closedSpy.at(0).at(1).toUInt(), static_cast<quint32>(3));
+	QCOMPARE(objectClosed.count(), 1);
+	QVERIFY(server.notifications.valueList().isEmpty());
+
+	// expiry reports its own reason
+	reply = sendNotify("Expire", 0, {}, {}, 10);
+	QTRY_VERIFY(reply.isFinished());
+	QTRY_COMPARE(closedSpy.count(), 2);
+	QCOMPARE(closedSpy.at(1).at(1).toUInt(), static_cast<quint32>(1));
+}
+
+void TestNotifications::invokeAction() { // NOLINT
+	auto server = NotificationServer(serverConnection());
+	auto invokedSpy = QSignalSpy(&server, &NotificationServer::ActionInvoked);
+	auto closedSpy = QSignalSpy(&server, &NotificationServer::NotificationClosed);
+
+	auto reply = sendNotify("Action", 0, {"default", "Open"}, {{"resident", true}});
+	QTRY_VERIFY(reply.isFinished());
+	auto* notification = server.notifications.valueList().at(0);
+
+	// resident notifications stay after an action
+	notification->actionList().at(0)->invoke();
+	QCOMPARE(invokedSpy.count(), 1);
+	QCOMPARE(invokedSpy.at(0).at(0).toUInt(), reply.value());
+	QCOMPARE(invokedSpy.at(0).at(1).toString(), QString("default"));
+	QCOMPARE(closedSpy.count(), 0);
+
+	reply = sendNotify("Action", reply.value(), {"default", "Open"});
+	QTRY_VERIFY(reply.isFinished());
+	QVERIFY(!notification->resident());
+
+	notification->actionList().at(0)->invoke();
+	QCOMPARE(invokedSpy.count(), 2);
+	QCOMPARE(closedSpy.count(), 1);
+	QCOMPARE(closedSpy.at(0).at(1).toUInt(), static_cast<quint32>(2));
+}
+
+QTEST_MAIN(TestNotifications);
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <qobject.h>
+#include <qprocess.h>
+#include <qtmetamacros.h>
+
+class TestNotifications: public QObject {
+	Q_OBJECT;
+
+private slots:
+	void initTestCase();
+	void cleanupTestCase();
+	void notify();
+	void replace();
+	void createImage();
+	void imageHint();
+	void closeNotification();
+	void invokeAction();
+
+private:
+	QProcess daemon;
+};
@@ -53,27 +53,34 @@ StatusNotifierItem::StatusNotifierItem(const QString& address, QObject* parent)
 		return;
 	}
 
-	// clang-format off
-	QObject::connect(this->item, &DBusStatusNotifierItem::NewTitle, &this->title, &AbstractDBusProperty::update);
-	QObject::connect(this->item, &DBusStatusNotifierItem::NewIcon, &this->iconName, &AbstractDBusProperty::update);
-	QObject::connect(this->item, &DBusStatusNotifierItem::NewIcon, &this->iconPixmaps, &AbstractDBusProperty::update);
-	QObject::connect(this->item, &DBusStatusNotifierItem::NewIcon, &this->iconThemePath, &AbstractDBusProperty::update);
-	QObject::connect(this->item, &DBusStatusNotifierItem::NewOverlayIcon, &this->overlayIconName, &AbstractDBusProperty::update);
-	QObject::connect(this->item, &DBusStatusNotifierItem::NewOverlayIcon, &this->overlayIconPixmaps, &AbstractDBusProperty::update);
-	QObject::connect(this->item, &DBusStatusNotifierItem::NewOverlayIcon, &this->iconThemePath, &AbstractDBusProperty::update);
-	QObject::connect(this->item, &DBusStatusNotifierItem::NewAttentionIcon, &this->attentionIconName, &AbstractDBusProperty::update);
-	QObject::connect(this->item, &DBusStatusNotifierItem::NewAttentionIcon, &this->attentionIconPixmaps, &AbstractDBusProperty::update);
-	QObject::connect(this->item, &DBusStatusNotifierItem::NewAttentionIcon, &this->iconThemePath, &AbstractDBusProperty::update);
-	QObject::connect(this->item, &DBusStatusNotifierItem::NewToolTip, &this->tooltip, &AbstractDBusProperty::update);
-
-	QObject::connect(&this->iconThemePath, &AbstractDBusProperty::changed, this, &StatusNotifierItem::updateIcon);
-	QObject::connect(&this->iconName, &AbstractDBusProperty::changed, this, &StatusNotifierItem::updateIcon);
-	QObject::connect(&this->attentionIconName, &AbstractDBusProperty::changed, this, &StatusNotifierItem::updateIcon);
-	QObject::connect(&this->overlayIconName, &AbstractDBusProperty::changed, this, &StatusNotifierItem::updateIcon);
-	QObject::connect(&this->iconPixmaps, &AbstractDBusProperty::changed, this, &StatusNotifierItem::updateIcon);
-	QObject::connect(&this->attentionIconPixmaps, &AbstractDBusProperty::changed, this, &StatusNotifierItem::updateIcon);
-	QObject::connect(&this->overlayIconPixmaps, &AbstractDBusProperty::changed, this, &StatusNotifierItem::updateIcon);
+	QObject::connect(this->item, &DBusStatusNotifierItem::NewTitle, this, [this]() {
+		this->title.update();
+	});
+
+	QObject::connect(this->item, &DBusStatusNotifierItem::NewIcon, this, [this]() {
+		this->iconName.update();
+		this->iconPixmaps.update();
+		this->iconThemePath.update();
+	});
+
+	QObject::connect(this->item, &DBusStatusNotifierItem::NewOverlayIcon, this, [this]() {
+		this->overlayIconName.update();
+		this->overlayIconPixmaps.update();
+		this->iconThemePath.update();
+	});
+
+	QObject::connect(this->item, &DBusStatusNotifierItem::NewAttentionIcon, this, [this]() {
+		this->attentionIconName.update();
+		this->attentionIconPixmaps.update();
+		this->iconThemePath.update();
+	});
+
+	QObject::connect(this->item, &DBusStatusNotifierItem::NewToolTip, this, [this]() {
+		this->tooltip.update();
+	});
 
+	// clang-format off
+	QObject::connect(&this->properties, &DBusPropertyGroup::changed, this, &StatusNotifierItem::onPropertiesChanged);
 	QObject::connect(&this->properties, &DBusPropertyGroup::getAllFinished, this, &StatusNotifierItem::onGetAllFinished);
 	// clang-format on
 
@@ -230,6 +237,15 @@ void StatusNotifierItem::updateIcon() {
 	emit this->iconChanged();
 }
 
+void StatusNotifierItem::onPropertiesChanged(quint64 cells) {
+	auto iconCells = this->iconThemePath.bit() | this->iconName.bit() | this->iconPixmaps.bit()
+	               | this->overlayIconName.bit() | this->overlayIconPixmaps.bit()
+	               | this->attentionIconName.bit() | this->attentionIconPixmaps.bit();
+
+	// a GetAll or change set touching several icon properties only invalidates the icon once
+	if ((cells & iconCells) != 0) this->updateIcon();
+}
+
 DBusMenu* StatusNotifierItem::createMenu() const {
 	auto path = this->menuPath.get().path();
 	if (!path.isEmpty()) {
@@ -49,22 +49,22 @@ public:
 
 	// clang-format off
 	dbus::DBusPropertyGroup properties;
-	dbus::DBusProperty<QString> id {this->properties, "Id"};
-	dbus::DBusProperty<QString> title {this->properties, "Title"};
-	dbus::DBusProperty<QString> status {this->properties, "Status"};
-	dbus::DBusProperty<QString> category {this->properties, "Category"};
-	dbus::DBusProperty<quint32> windowId {this->properties, "WindowId"};
-	dbus::DBusProperty<QString> iconThemePath {this->properties, "IconThemePath"};
-	dbus::DBusProperty<QString> iconName {this->properties, "IconName"};
-	dbus::DBusProperty<DBusSniIconPixmapList> iconPixmaps {this->properties, "IconPixmap"};
-	dbus::DBusProperty<QString> overlayIconName {this->properties, "OverlayIconName"};
-	dbus::DBusProperty<DBusSniIconPixmapList> overlayIconPixmaps {this->properties, "OverlayIconPixmap"};
-	dbus::DBusProperty<QString> attentionIconName {this->properties, "AttentionIconName"};
-	dbus::DBusProperty<DBusSniIconPixmapList> attentionIconPixmaps {this->properties, "AttentionIconPixmap"};
-	dbus::DBusProperty<QString> attentionMovieName {this->properties, "AttentionMovieName"};
-	dbus::DBusProperty<DBusSniTooltip> tooltip {this->properties, "ToolTip"};
-	dbus::DBusProperty<bool> isMenu {this->properties, "ItemIsMenu"};
-	dbus::DBusProperty<QDBusObjectPath> menuPath {this->properties, "Menu"};
+	dbus::DBusPropertyCell<QString> id {this->properties, "Id"};
+	dbus::DBusPropertyCell<QString> title {this->properties, "Title"};
+	dbus::DBusPropertyCell<QString> status {this->properties, "Status"};
+	dbus::DBusPropertyCell<QString> category {this->properties, "Category"};
+	dbus::DBusPropertyCell<quint32> windowId {this->properties, "WindowId"};
+	dbus::DBusPropertyCell<QString> iconThemePath {this->properties, "IconThemePath"};
+	dbus::DBusPropertyCell<QString> iconName {this->properties, "IconName"};
+	dbus::DBusPropertyCell<DBusSniIconPixmapList> iconPixmaps {this->properties, "IconPixmap"};
+	dbus::DBusPropertyCell<QString> overlayIconName {this->properties, "OverlayIconName"};
+	dbus::DBusPropertyCell<DBusSniIconPixmapList> overlayIconPixmaps {this->properties, "OverlayIconPixmap"};
+	dbus::DBusPropertyCell<QString> attentionIconName {this->properties, "AttentionIconName"};
+	dbus::DBusPropertyCell<DBusSniIconPixmapList> attentionIconPixmaps {this->properties, "AttentionIconPixmap"};
+	dbus::DBusPropertyCell<QString> attentionMovieName {this->properties, "AttentionMovieName"};
+	dbus::DBusPropertyCell<DBusSniTooltip> tooltip {this->properties, "ToolTip"};
+	dbus::DBusPropertyCell<bool> isMenu {this->properties, "ItemIsMenu"};
+	dbus::DBusPropertyCell<QDBusObjectPath> menuPath {this->properties, "Menu"};
 	// clang-format on
 
 signals:
@@ -73,6 +73,7 @@ signals:
 
 private slots:
 	void updateIcon();
+	void onPropertiesChanged(quint64 cells);
 	void onGetAllFinished();
 
 private:
@@ -22,17 +22,24 @@ SystemTrayItem::SystemTrayItem(qs::service::sni::StatusNotifierItem* item, QObje
     : QObject(parent)
     , item(item) {
 	// clang-format off
-	QObject::connect(&this->item->id, &AbstractDBusProperty::changed, this, &SystemTrayItem::idChanged);
-	QObject::connect(&this->item->title, &AbstractDBusProperty::changed, this, &SystemTrayItem::titleChanged);
-	QObject::connect(&this->item->status, &AbstractDBusProperty::changed, this, &SystemTrayItem::statusChanged);
-	QObject::connect(&this->item->category, &AbstractDBusProperty::changed, this, &SystemTrayItem::categoryChanged);
+	QObject::connect(&this->item->properties, &DBusPropertyGroup::changed, this, &SystemTrayItem::onPropertiesChanged);
 	QObject::connect(this->item, &StatusNotifierItem::iconChanged, this, &SystemTrayItem::iconChanged);
-	QObject::connect(&this->item->tooltip, &AbstractDBusProperty::changed, this, &SystemTrayItem::tooltipTitleChanged);
-	QObject::connect(&this->item->tooltip, &AbstractDBusProperty::changed, this, &SystemTrayItem::tooltipDescriptionChanged);
-	QObject::connect(&this->item->isMenu, &AbstractDBusProperty::changed, this, &SystemTrayItem::onlyMenuChanged);
 	// clang-format on
 }
 
+void SystemTrayItem::onPropertiesChanged(quint64 cells) {
+	if ((cells & this->item->id.bit()) != 0) emit this->idChanged();
+	if ((cells & this->item->title.bit()) != 0) emit this->titleChanged();
+	if ((cells & this->item->status.bit()) != 0) emit this->statusChanged();
+	if ((cells & this->item->category.bit()) != 0) emit this->categoryChanged();
+	if ((cells & this->item->isMenu.bit()) != 0) emit this->onlyMenuChanged();
+
+	if ((cells & this->item->tooltip.bit()) != 0) {
+		emit this->tooltipTitleChanged();
+		emit this->tooltipDescriptionChanged();
+	}
+}
+
 QString SystemTrayItem::id() const {
 	if (this->item == nullptr) return "";
 	return this->item->id.get();
@@ -154,6 +161,7 @@ void SystemTrayMenuWatcher::setTrayItem(SystemTrayItem* item) {
 
 	if (this->item != nullptr) {
 		QObject::disconnect(this->item, nullptr, this, nullptr);
+		QObject::disconnect(&this->item->item->properties, nullptr, this, nullptr);
 	}
 
 	this->item = item;
@@ -162,10 +170,12 @@ void SystemTrayMenuWatcher::setTrayItem(SystemTrayItem* item) {
 		QObject::connect(item, &QObject::destroyed, this, &SystemTrayMenuWatcher::onItemDestroyed);
 
 		QObject::connect(
-		    &item->item->menuPath,
-		    &AbstractDBusProperty::changed,
+		    &item->item->properties,
+		    &DBusPropertyGroup::changed,
 		    this,
-		    &SystemTrayMenuWatcher::onMenuPathChanged
+		    [this, menuPathBit = item->item->menuPath.bit()](quint64 cells) {
+			    if ((cells & menuPathBit) != 0) this->onMenuPathChanged();
+		    }
 		);
 	}
 
@@ -99,6 +99,9 @@ signals:
 	void tooltipTitleChanged();
 	void tooltipDescriptionChanged();
 	void onlyMenuChanged();
+
+private slots:
+	void onPropertiesChanged(quint64 cells);
 };
 
 ///! System tray
@@ -0,0 +1,194 @@
+#include "core.hpp"
+
+#include <qdbusconnection.h>
+#include <qdbusextratypes.h>
+#include <qdbuspendingcall.h>
+#include <qdbuspendingreply.h>
+#include <qdbusservicewatcher.h>
+#include <qlist.h>
+#include <qlogging.h>
+#include <qloggingcategory.h>
+#include <qobject.h>
+#include <qstring.h>
+
+#include "../../core/model.hpp"
+#include "../../dbus/properties.hpp"
+#include "dbus_service.h"
+#include "device.hpp"
+
+using namespace qs::dbus;
+
+Q_LOGGING_CATEGORY(logUPower, "quickshell.service.upower", QtWarningMsg);
+
+namespace qs::service::upower {
+
+UPower::UPower(const QDBusConnection& connection, QObject* parent)
+    : QObject(parent)
+    , connection(connection) {
+	if (!connection.isConnected()) {
+		qCWarning(logUPower) << "Could not connect to DBus. UPower service will not work.";
+		return;
+	}
+
+	// clang-format off
+	QObject::connect(&this->serviceWatcher, &QDBusServiceWatcher::serviceRegistered, this, &UPower::onServiceRegistered);
+	QObject::connect(&this->serviceWatcher, &QDBusServiceWatcher::serviceUnregistered, this, &UPower::onServiceUnregistered);
+	// clang-format on
+
+	this->serviceWatcher.addWatchedService("org.freedesktop.UPower");
+	this->serviceWatcher.setConnection(connection);
+
+	this->service =
+	    new DBusUPowerService("org.freedesktop.UPower", "/org/freedesktop/UPower", connection, this);
+
+	// clang-format off
+	QObject::connect(this->service, &DBusUPowerService::DeviceAdded, this, &UPower::onDeviceAdded);
+	QObject::connect(this->service, &DBusUPowerService::DeviceRemoved, this, &UPower::onDeviceRemoved);
+	QObject::connect(&this->pOnBattery, &AbstractDBusProperty::changed, this, &UPower::onBatteryChanged);
+	// clang-format on
+
+	this->serviceProperties.setInterface(this->service);
+
+	if (!this->service->isValid()) {
+		qCWarning(logUPower)
+		    << "UPower is not running. UPower service will not work until it is started.";
+		return;
+	}
+
+	this->init();
+}
+
+void UPower::init() {
+	this->serviceProperties.updateAllViaGetAll();
+
+	auto devicesCall = this->service->EnumerateDevices();
+	auto* call = new QDBusPendingCallWatcher(devicesCall, this);
+
+	auto devicesCallback = [this](QDBusPendingCallWatcher* call) {
+		const QDBusPendingReply<QList<QDBusObjectPath>> reply = *call;
+
+		if (reply.isError()) {
+			qCWarning(logUPower) << "Failed to enumerate devices:" << reply.error().message();
+		} else {
+			for (const auto& path: reply.value()) {
+				this->registerDevice(path.path());
+			}
+		}
+
+		delete call;
+	};
+
+	QObject::connect(call, &QDBusPendingCallWatcher::finished, this, devicesCallback);
+
+	auto displayCall = this->service->GetDisplayDevice();
+	call = new QDBusPendingCallWatcher(displayCall, this);
+
+	auto displayCallback = [this](QDBusPendingCallWatcher* call) {
+		const QDBusPendingReply<QDBusObjectPath> reply = *call;
+
+		if (reply.isError()) {
+			qCWarning(logUPower) << "Failed to get display device:" << reply.error().message();
+		} else if (this->mDisplayDevice == nullptr) {
+			auto* device = new UPowerDevice(this->connection, reply.value().path(), this);
+
+			if (!device->isValid()) {
+				delete device;
+			} else {
+				this->mDisplayDevice = device;
+				emit this->displayDeviceChanged();
+			}
+		}
+
+		delete call;
+	};
+
+	QObject::connect(call, &QDBusPendingCallWatcher::finished, this, displayCallback);
+}
+
+void UPower::onServiceRegistered() {
+	qCInfo(logUPower) << "UPower service started.";
+	this->clearDevices();
+	this->init();
+}
+
+void UPower::onServiceUnregistered() {
+	qCInfo(logUPower) << "UPower service stopped.";
+	this->clearDevices();
+}
+
+void UPower::onDeviceAdded(const QDBusObjectPath& path) { this->registerDevice(path.path()); }
+
+void UPower::onDeviceRemoved(const QDBusObjectPath& path) {
+	auto* device = this->mDevices.take(path.path());
+	if (device == nullptr) return;
+
+	qCDebug(logUPower) << "Device" << path.path() << "removed.";
+	this->devices.removeObject(device);
+	delete device;
+}
+
+void UPower::onDeviceReady() {
+	auto* device = qobject_cast<UPowerDevice*>(this->sender());
+	if (device == nullptr || !this->mDevices.contains(device->path())) return;
+
+	this->devices.insertObject(device);
+}
+
+void UPower::registerDevice(const QString& path) {
+	if (this->mDevices.contains(path)) return;
+
+	auto* device = new UPowerDevice(this->connection, path, this);
+
+	if (!device->isValid()) {
+		delete device;
+		return;
+	}
+
+	qCDebug(logUPower) << "Device" << path << "added.";
+	this->mDevices.insert(path, device);
+
+	// devices are only shown once they have something to show
+	QObject::connect(device, &UPowerDevice::readyChanged, this, &UPower::onDeviceReady);
+}
+
+void UPower::clearDevices() {
+	for (auto* device: this->mDevices) {
+		this->devices.removeObject(device);
+		delete device;
+	}
+
+	this->mDevices.clear();
+
+	if (this->mDisplayDevice != nullptr) {
+		delete this->mDisplayDevice;
+		this->mDisplayDevice = nullptr;
+		emit this->displayDeviceChanged();
+	}
+}
+
+UPowerDevice* UPower::displayDevice() const { return this->mDisplayDevice; }
+bool UPower::onBattery() const { return this->pOnBattery.get(); }
+
+UPower* UPower::instance() {
+	static UPower* instance = nullptr; // NOLINT
+	if (instance == nullptr) instance = new UPower(QDBusConnection::systemBus());
+	return instance;
+}
+
+} // namespace qs::service::upower
+
+using qs::service::upower::UPower;
+using qs::service::upower::UPowerDevice;
+
+UPowerQml::UPowerQml(QObject* parent): QObject(parent) {
+	auto* upower = UPower::instance();
+
+	// clang-format off
+	QObject::connect(upower, &UPower::displayDeviceChanged, this, &UPowerQml::displayDeviceChanged);
+	QObject::connect(upower, &UPower::onBatteryChanged, this, &UPowerQml::onBatteryChanged);
+	// clang-format on
+}
+
+UPowerDevice* UPowerQml::displayDevice() const { return UPower::instance()->displayDevice(); }
+UntypedObjectModel* UPowerQml::devices() const { return &UPower::instance()->devices; }
+bool UPowerQml::onBattery() const { return UPower::instance()->onBattery(); }
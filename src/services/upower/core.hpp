@@ -0,0 +1,103 @@
+#pragma once
+
+#include <qdbusconnection.h>
+#include <qdbusextratypes.h>
+#include <qdbusservicewatcher.h>
+#include <qhash.h>
+#include <qloggingcategory.h>
+#include <qobject.h>
+#include <qqmlintegration.h>
+#include <qtmetamacros.h>
+
+#include "../../core/model.hpp"
+#include "../../dbus/properties.hpp"
+#include "device.hpp"
+
+class DBusUPowerService;
+
+Q_DECLARE_LOGGING_CATEGORY(logUPower);
+
+namespace qs::service::upower {
+
+// Connection to the UPower daemon, shared by every engine generation.
+//
+// Devices are discovered with EnumerateDevices once, then tracked with the
+// DeviceAdded and DeviceRemoved signals. Device state is only ever read again
+// when UPower reports a change.
+class UPower: public QObject {
+	Q_OBJECT;
+
+public:
+	explicit UPower(const QDBusConnection& connection, QObject* parent = nullptr);
+
+	// uses the system bus
+	static UPower* instance();
+
+	[[nodiscard]] UPowerDevice* displayDevice() const;
+	[[nodiscard]] bool onBattery() const;
+
+	ObjectModel<UPowerDevice> devices {this};
+
+	dbus::DBusPropertyGroup serviceProperties;
+	dbus::DBusProperty<bool> pOnBattery {this->serviceProperties, "OnBattery"};
+
+signals:
+	void displayDeviceChanged();
+	void onBatteryChanged();
+
+private slots:
+	void onServiceRegistered();
+	void onServiceUnregistered();
+	void onDeviceAdded(const QDBusObjectPath& path);
+	void onDeviceRemoved(const QDBusObjectPath& path);
+	void onDeviceReady();
+
+private:
+	void init();
+	void registerDevice(const QString& path);
+	void clearDevices();
+
+	QDBusConnection connection;
+	QDBusServiceWatcher serviceWatcher;
+	DBusUPowerService* service = nullptr;
+	// includes devices which are still reading their initial properties
+	QHash<QString, UPowerDevice*> mDevices;
+	UPowerDevice* mDisplayDevice = nullptr;
+};
+
+} // namespace qs::service::upower
+
+///! UPower power management service
+/// Battery and power supply state from the [UPower] system service.
+///
+/// All properties follow UPower's change notifications, so bindings update
+/// as soon as UPower does, without any polling.
+///
+/// [UPower]: https://upower.freedesktop.org/
+class UPowerQml: public QObject {
+	Q_OBJECT;
+	// clang-format off
+	/// UPower's combined view of the batteries which power the computer.
+	/// Use this for a laptop battery indicator.
+	///
+	/// Null until UPower has reported it.
+	Q_PROPERTY(qs::service::upower::UPowerDevice* displayDevice READ displayDevice NOTIFY displayDeviceChanged);
+	/// All devices tracked by UPower, excluding the display device.
+	Q_PROPERTY(UntypedObjectModel* devices READ devices CONSTANT);
+	/// If the computer is currently running on battery power.
+	Q_PROPERTY(bool onBattery READ onBattery NOTIFY onBatteryChanged);
+	// clang-format on
+	QML_NAMED_ELEMENT(UPower);
+	QML_SINGLETON;
+
+public:
+	explicit UPowerQml(QObject* parent = nullptr);
+
+	[[nodiscard]] qs::service::upower::UPowerDevice* displayDevice() const;
+	[[nodiscard]] UntypedObjectModel* devices() const;
+	[[nodiscard]] bool onBattery() const;
+
+signals:
+	void displayDeviceChanged();
+	void onBatteryChanged();
+};
@@ -0,0 +1,91 @@
+#include "device.hpp"
+
+#include <qdbusconnection.h>
+#include <qlogging.h>
+#include <qloggingcategory.h>
+#include <qobject.h>
+#include <qstring.h>
+#include <qtypes.h>
+
+#include "../../dbus/properties.hpp"
+#include "dbus_device.h"
+
+using namespace qs::dbus;
+
+Q_LOGGING_CATEGORY(logUPowerDevice, "quickshell.service.upower.device", QtWarningMsg);
+
+namespace qs::service::upower {
+
+UPowerDevice::UPowerDevice(const QDBusConnection& connection, const QString& path, QObject* parent)
+    : QObject(parent) {
+	this->device = new DBusUPowerDevice("org.freedesktop.UPower", path, connection, this);
+
+	if (!this->device->isValid()) {
+		qCWarning(logUPowerDevice) << "Cannot create UPowerDevice for" << path;
+		return;
+	}
+
+	// clang-format off
+	QObject::connect(&this->pType, &AbstractDBusProperty::changed, this, &UPowerDevice::typeChanged);
+	QObject::connect(&this->pType, &AbstractDBusProperty::changed, this, &UPowerDevice::isLaptopBatteryChanged);
+	QObject::connect(&this->pPowerSupply, &AbstractDBusProperty::changed, this, &UPowerDevice::powerSupplyChanged);
+	QObject::connect(&this->pPowerSupply, &AbstractDBusProperty::changed, this, &UPowerDevice::isLaptopBatteryChanged);
+	QObject::connect(&this->pIsPresent, &AbstractDBusProperty::changed, this, &UPowerDevice::isPresentChanged);
+	QObject::connect(&this->pState, &AbstractDBusProperty::changed, this, &UPowerDevice::stateChanged);
+	QObject::connect(&this->pPercentage, &AbstractDBusProperty::changed, this, &UPowerDevice::percentageChanged);
+	QObject::connect(&this->pEnergy, &AbstractDBusProperty::changed, this, &UPowerDevice::energyChanged);
+	QObject::connect(&this->pEnergyFull, &AbstractDBusProperty::changed, this, &UPowerDevice::energyCapacityChanged);
+	QObject::connect(&this->pEnergyRate, &AbstractDBusProperty::changed, this, &UPowerDevice::changeRateChanged);
+	QObject::connect(&this->pTimeToEmpty, &AbstractDBusProperty::changed, this, &UPowerDevice::timeToEmptyChanged);
+	QObject::connect(&this->pTimeToFull, &AbstractDBusProperty::changed, this, &UPowerDevice::timeToFullChanged);
+	QObject::connect(&this->pIconName, &AbstractDBusProperty::changed, this, &UPowerDevice::iconNameChanged);
+	QObject::connect(&this->pModel, &AbstractDBusProperty::changed, this, &UPowerDevice::modelChanged);
+	QObject::connect(&this->pNativePath, &AbstractDBusProperty::changed, this, &UPowerDevice::nativePathChanged);
+
+	QObject::connect(&this->properties, &DBusPropertyGroup::getAllFinished, this, &UPowerDevice::onGetAllFinished);
+	// clang-format on
+
+	// Everything after the initial read arrives through PropertiesChanged.
+	this->properties.setInterface(this->device);
+	this->properties.updateAllViaGetAll();
+}
+
+bool UPowerDevice::isValid() const { return this->device->isValid(); }
+bool UPowerDevice::isReady() const { return this->mReady; }
+QString UPowerDevice::path() const { return this->device->path(); }
+
+void UPowerDevice::onGetAllFinished() {
+	if (this->mReady) return;
+
+	qCDebug(logUPowerDevice) << "UPowerDevice" << this->device->path() << "is ready.";
+	this->mReady = true;
+	emit this->readyChanged();
+}
+
+UPowerDeviceType::Enum UPowerDevice::type() const {
+	return static_cast<UPowerDeviceType::Enum>(this->pType.get());
+}
+
+bool UPowerDevice::powerSupply() const { return this->pPowerSupply.get(); }
+
+bool UPowerDevice::isLaptopBattery() const {
+	return this->pType.get() == UPowerDeviceType::Battery && this->pPowerSupply.get();
+}
+
+bool UPowerDevice::isPresent() const { return this->pIsPresent.get(); }
+
+UPowerDeviceState::Enum UPowerDevice::state() const {
+	return static_cast<UPowerDeviceState::Enum>(this->pState.get());
+}
+
+qreal UPowerDevice::percentage() const { return this->pPercentage.get(); }
+qreal UPowerDevice::energy() const { return this->pEnergy.get(); }
+qreal UPowerDevice::energyCapacity() const { return this->pEnergyFull.get(); }
+qreal UPowerDevice::changeRate() const { return this->pEnergyRate.get(); }
+qreal UPowerDevice::timeToEmpty() const { return static_cast<qreal>(this->pTimeToEmpty.get()); }
+qreal UPowerDevice::timeToFull() const { return static_cast<qreal>(this->pTimeToFull.get()); }
+QString UPowerDevice::iconName() const { return this->pIconName.get(); }
+QString UPowerDevice::model() const { return this->pModel.get(); }
+QString UPowerDevice::nativePath() const { return this->pNativePath.get(); }
+
+} // namespace qs::service::upower
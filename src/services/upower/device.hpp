@@ -0,0 +1,189 @@
+#pragma once
+
+#include <qdbusconnection.h>
+#include <qloggingcategory.h>
+#include <qobject.h>
+#include <qqmlintegration.h>
+#include <qtmetamacros.h>
+#include <qtypes.h>
+
+#include "../../dbus/properties.hpp"
+
+class DBusUPowerDevice;
+
+Q_DECLARE_LOGGING_CATEGORY(logUPowerDevice);
+
+namespace qs::service::upower {
+
+namespace UPowerDeviceState { // NOLINT
+Q_NAMESPACE;
+QML_ELEMENT;
+
+enum Enum {
+	Unknown = 0,
+	Charging = 1,
+	Discharging = 2,
+	Empty = 3,
+	FullyCharged = 4,
+	/// The device is waiting to be charged after it was plugged in.
+	PendingCharge = 5,
+	/// The device is waiting to be discharged after being unplugged.
+	PendingDischarge = 6,
+};
+Q_ENUM_NS(Enum);
+
+} // namespace UPowerDeviceState
+
+namespace UPowerDeviceType { // NOLINT
+Q_NAMESPACE;
+QML_ELEMENT;
+
+enum Enum {
+	Unknown = 0,
+	LinePower = 1,
+	Battery = 2,
+	Ups = 3,
+	Monitor = 4,
+	Mouse = 5,
+	Keyboard = 6,
+	Pda = 7,
+	Phone = 8,
+	MediaPlayer = 9,
+	Tablet = 10,
+	Computer = 11,
+	GamingInput = 12,
+	Pen = 13,
+	Touchpad = 14,
+	Modem = 15,
+	Network = 16,
+	Headset = 17,
+	Speakers = 18,
+	Headphones = 19,
+	Video = 20,
+	OtherAudio = 21,
+	RemoteControl = 22,
+	Printer = 23,
+	Scanner = 24,
+	Camera = 25,
+	Wearable = 26,
+	Toy = 27,
+	BluetoothGeneric = 28,
+};
+Q_ENUM_NS(Enum);
+
+} // namespace UPowerDeviceType
+
+///! A device exposed through the UPower system service.
+/// A power source or battery powered device tracked by UPower.
+///
+/// Properties are updated from UPower's change notifications as they happen,
+/// they are never polled.
+class UPowerDevice: public QObject {
+	Q_OBJECT;
+	// clang-format off
+	/// The kind of device.
+	Q_PROPERTY(qs::service::upower::UPowerDeviceType::Enum type READ type NOTIFY typeChanged);
+	/// If the device supplies power to the computer, such as a laptop battery.
+	Q_PROPERTY(bool powerSupply READ powerSupply NOTIFY powerSupplyChanged);
+	/// If the device is a battery which powers the computer. Shorthand for checking
+	/// `type` and `powerSupply`.
+	Q_PROPERTY(bool isLaptopBattery READ isLaptopBattery NOTIFY isLaptopBatteryChanged);
+	/// If a battery is currently present in the device's bay.
+	Q_PROPERTY(bool isPresent READ isPresent NOTIFY isPresentChanged);
+	Q_PROPERTY(qs::service::upower::UPowerDeviceState::Enum state READ state NOTIFY stateChanged);
+	/// The charge level of the device, from 0 to 100.
+	Q_PROPERTY(qreal percentage READ percentage NOTIFY percentageChanged);
+	/// The energy currently stored in the device, in watt-hours.
+	Q_PROPERTY(qreal energy READ energy NOTIFY energyChanged);
+	/// The energy stored in the device when it is fully charged, in watt-hours.
+	Q_PROPERTY(qreal energyCapacity READ energyCapacity NOTIFY energyCapacityChanged);
+	/// The rate energy is being drawn from or supplied to the device, in watts.
+	Q_PROPERTY(qreal changeRate READ changeRate NOTIFY changeRateChanged);
+	/// Estimated seconds until the device is empty, or 0 if unknown or not discharging.
+	Q_PROPERTY(qreal timeToEmpty READ timeToEmpty NOTIFY timeToEmptyChanged);
+	/// Estimated seconds until the device is full, or 0 if unknown or not charging.
+	Q_PROPERTY(qreal timeToFull READ timeToFull NOTIFY timeToFullChanged);
+	/// Name of the icon UPower suggests for the device's state.
+	/// Prefix it with `image://icon/` to use it as an Image source.
+	Q_PROPERTY(QString iconName READ iconName NOTIFY iconNameChanged);
+	/// The model name of the device.
+	Q_PROPERTY(QString model READ model NOTIFY modelChanged);
+	/// The sysfs path of the device, or an empty string for the display device.
+	Q_PROPERTY(QString nativePath READ nativePath NOTIFY nativePathChanged);
+	/// The UPower object path of the device.
+	Q_PROPERTY(QString path READ path CONSTANT);
+	/// If all properties have been read from UPower at least once.
+	Q_PROPERTY(bool ready READ isReady NOTIFY readyChanged);
+	// clang-format on
+	QML_ELEMENT;
+	QML_UNCREATABLE("UPowerDevices can only be acquired from UPower");
+
+public:
+	explicit UPowerDevice(
+	    const QDBusConnection& connection,
+	    const QString& path,
+	    QObject* parent = nullptr
+	);
+
+	[[nodiscard]] bool isValid() const;
+	[[nodiscard]] bool isReady() const;
+	[[nodiscard]] QString path() const;
+
+	[[nodiscard]] UPowerDeviceType::Enum type() const;
+	[[nodiscard]] bool powerSupply() const;
+	[[nodiscard]] bool isLaptopBattery() const;
+	[[nodiscard]] bool isPresent() const;
+	[[nodiscard]] UPowerDeviceState::Enum state() const;
+	[[nodiscard]] qreal percentage() const;
+	[[nodiscard]] qreal energy() const;
+	[[nodiscard]] qreal energyCapacity() const;
+	[[nodiscard]] qreal changeRate() const;
+	[[nodiscard]] qreal timeToEmpty() const;
+	[[nodiscard]] qreal timeToFull() const;
+	[[nodiscard]] QString iconName() const;
+	[[nodiscard]] QString model() const;
+	[[nodiscard]] QString nativePath() const;
+
+	// clang-format off
+	dbus::DBusPropertyGroup properties;
+	dbus::DBusProperty<QString> pNativePath {this->properties, "NativePath"};
+	dbus::DBusProperty<QString> pModel {this->properties, "Model"};
+	dbus::DBusProperty<quint32> pType {this->properties, "Type"};
+	dbus::DBusProperty<bool> pPowerSupply {this->properties, "PowerSupply"};
+	dbus::DBusProperty<bool> pIsPresent {this->properties, "IsPresent"};
+	dbus::DBusProperty<quint32> pState {this->properties, "State"};
+	dbus::DBusProperty<qreal> pPercentage {this->properties, "Percentage"};
+	dbus::DBusProperty<qreal> pEnergy {this->properties, "Energy"};
+	dbus::DBusProperty<qreal> pEnergyFull {this->properties, "EnergyFull"};
+	dbus::DBusProperty<qreal> pEnergyRate {this->properties, "EnergyRate"};
+	dbus::DBusProperty<qlonglong> pTimeToEmpty {this->properties, "TimeToEmpty"};
+	dbus::DBusProperty<qlonglong> pTimeToFull {this->properties, "TimeToFull"};
+	dbus::DBusProperty<QString> pIconName {this->properties, "IconName"};
+	// clang-format on
+
+signals:
+	void typeChanged();
+	void powerSupplyChanged();
+	void isLaptopBatteryChanged();
+	void isPresentChanged();
+	void stateChanged();
+	void percentageChanged();
+	void energyChanged();
+	void energyCapacityChanged();
+	void changeRateChanged();
+	void timeToEmptyChanged();
+	void timeToFullChanged();
+	void iconNameChanged();
+	void modelChanged();
+	void nativePathChanged();
+	void readyChanged();
+
+private slots:
+	void onGetAllFinished();
+
+private:
+	DBusUPowerDevice* device = nullptr;
+	bool mReady = false;
+};
+
+} // namespace qs::service::upower
@@ -0,0 +1,200 @@
+#include "upower.hpp"
+
+#include <qdbusconnection.h>
+#include <qdbusextratypes.h>
+#include <qdbusmessage.h>
+#include <qlist.h>
+#include <qobject.h>
+#include <qprocess.h>
+#include <qsignalspy.h>
+#include <qstandardpaths.h>
+#include <qtest.h>
+#include <qtestcase.h>
+#include <qtypes.h>
+#include <qvariant.h>
+
+#include "../../../core/model.hpp"
+#include "../core.hpp"
+#include "../device.hpp"
+
+using namespace qs::service::upower;
+
+namespace {
+
+constexpr const char* SERVICE = "org.freedesktop.UPower";
+constexpr const char* PATH = "/org/freedesktop/UPower";
+constexpr const char* DISPLAY_DEVICE = "/org/freedesktop/UPower/devices/DisplayDevice";
+constexpr const char* BATTERY = "/org/freedesktop/UPower/devices/battery_BAT0";
+constexpr const char* MOUSE = "/org/freedesktop/UPower/devices/mouse_0";
+
+QDBusConnection serverConnection() {
+	static auto connection = [] {
+		auto address = qEnvironmentVariable("DBUS_SESSION_BUS_ADDRESS");
+		return QDBusConnection::connectToBus(address, "quickshell-test-server");
+	}();
+
+	return connection;
+}
+
+void sendPropertiesChanged(
+    const QString& path,
+    const QString& interface,
+    const QVariantMap& changed
+) {
+	auto signal =
+	    QDBusMessage::createSignal(path, "org.freedesktop.DBus.Properties", "PropertiesChanged");
+
+	signal << interface << changed << QStringList();
+	serverConnection().send(signal);
+}
+
+// Exports the mock service with a battery and the display device.
+class MockSession {
+public:
+	MockSession() {
+		this->battery.nativePath = "BAT0";
+		this->upower.devices.append(QDBusObjectPath(BATTERY));
+
+		auto connection = serverConnection();
+		auto flags = QDBusConnection::ExportAllContents;
+		connection.registerObject(PATH, &this->upower, flags);
+		connection.registerObject(DISPLAY_DEVICE, &this->displayDevice, flags);
+		connection.registerObject(BATTERY, &this->battery, flags);
+		connection.registerService(SERVICE);
+	}
+
+	~MockSession() {
+		auto connection = serverConnection();
+		connection.unregisterService(SERVICE);
+		connection.unregisterObject(PATH);
+		connection.unregisterObject(DISPLAY_DEVICE);
+		connection.unregisterObject(BATTERY);
+	}
+
+	Q_DISABLE_COPY_MOVE(MockSession);
+
+	MockUPower upower;
+	MockUPowerDevice displayDevice;
+	MockUPowerDevice battery;
+};
+
+} // namespace
+
+QList<QDBusObjectPath> MockUPower::EnumerateDevices() { return this->devices; } // NOLINT
+
+QDBusObjectPath MockUPower::GetDisplayDevice() { // NOLINT
+	return QDBusObjectPath(DISPLAY_DEVICE);
+}
+
+void TestUPower::initTestCase() { // NOLINT
+	auto daemonPath = QStandardPaths::findExecutable("dbus-daemon");
+	if (daemonPath.isEmpty()) QSKIP("dbus-daemon is not installed");
+
+	this->daemon.start(daemonPath, {"--session", "--nofork", "--print-address"});
+	QVERIFY(this->daemon.waitForStarted());
+	QTRY_VERIFY(this->daemon.canReadLine());
+
+	auto address = QString::fromUtf8(this->daemon.readLine()).trimmed();
+
+	// must be set before anything connects to the session bus
+	qputenv("DBUS_SESSION_BUS_ADDRESS", address.toUtf8());
+	QVERIFY(QDBusConnection::sessionBus().isConnected());
+	QVERIFY(serverConnection().isConnected());
+}
+
+void TestUPower::cleanupTestCase() { // NOLINT
+	QDBusConnection::disconnectFromBus("quickshell-test-server");
+	this->daemon.kill();
+	this->daemon.waitForFinished();
+}
+
+void TestUPower::initialState() { // NOLINT
+	auto mock = MockSession();
+	auto upower = UPower(QDBusConnection::sessionBus());
+
+	QTRY_COMPARE(upower.devices.valueList().length(), static_cast<qsizetype>(1));
+	QTRY_VERIFY(upower.displayDevice() != nullptr);
+	QTRY_VERIFY(upower.displayDevice()->isReady());
+	QTRY_VERIFY(upower.onBattery());
+
+	auto* battery = upower.devices.valueList().at(0);
+	QCOMPARE(battery->path(), QString(BATTERY));
+	QCOMPARE(battery->nativePath(), QString("BAT0"));
+	QCOMPARE(battery->type(), UPowerDeviceType::Battery);
+	QCOMPARE(battery->state(), UPowerDeviceState::Discharging);
+	QCOMPARE(battery->percentage(), 50.0);
+	QCOMPARE(battery->timeToEmpty(), 3600.0);
+	QVERIFY(battery->isLaptopBattery());
+
+	QCOMPARE(upower.displayDevice()->iconName(), QString("battery-good-symbolic"));
+}
+
+void TestUPower::propertiesChanged() { // NOLINT
+	auto mock = MockSession();
+	auto upower = UPower(QDBusConnection::sessionBus());
+
+	QTRY_VERIFY(upower.displayDevice() != nullptr);
+	QTRY_VERIFY(upower.displayDevice()->isReady());
+	QTRY_VERIFY(upower.onBattery());
+
+	auto* device = upower.displayDevice();
+	auto percentageSpy = QSignalSpy(device, &UPowerDevice::percentageChanged);
+	auto stateSpy = QSignalSpy(device, &UPowerDevice::stateChanged);
+	auto onBatterySpy = QSignalSpy(&upower, &UPower::onBatteryChanged);
+
+	// the values only exist in the signals, so they can't have been read any other way
+	sendPropertiesChanged(
+	    DISPLAY_DEVICE,
+	    "org.freedesktop.UPower.Device",
+	    {{"Percentage", 80.0}, {"State", 1u}}
+	);
+
+	sendPropertiesChanged(PATH, "org.freedesktop.UPower", {{"OnBattery", false}});
+
+	QTRY_COMPARE(device->percentage(), 80.0);
+	QTRY_COMPARE(device->state(), UPowerDeviceState::Charging);
+	QTRY_VERIFY(!upower.onBattery());
+	QCOMPARE(percentageSpy.count(), 1);
+	QCOMPARE(stateSpy.count(), 1);
+	QCOMPARE(onBatterySpy.count(), 1);
+
+	// changes for other interfaces on the same object are not ours
+	sendPropertiesChanged(
+	    DISPLAY_DEVICE,
+	    "org.freedesktop.UPower.KbdBacklight",
+	    {{"Percentage", 0.0}}
+	);
+
+	QTest::qWait(100);
+	QCOMPARE(device->percentage(), 80.0);
+}
+
+void TestUPower::deviceHotplug() { // NOLINT
+	auto mock = MockSession();
+	auto upower = UPower(QDBusConnection::sessionBus());
+
+	QTRY_COMPARE(upower.devices.valueList().length(), static_cast<qsizetype>(1));
+
+	auto mouse = MockUPowerDevice();
+	mouse.type = UPowerDeviceType::Mouse;
+	mouse.powerSupply = false;
+	mouse.nativePath = "hid-mouse";
+
+	auto connection = serverConnection();
+	QVERIFY(connection.registerObject(MOUSE, &mouse, QDBusConnection::ExportAllContents));
+	emit mock.upower.DeviceAdded(QDBusObjectPath(MOUSE));
+
+	QTRY_COMPARE(upower.devices.valueList().length(), static_cast<qsizetype>(2));
+	auto* device = upower.devices.valueList().at(1);
+	QCOMPARE(device->type(), UPowerDeviceType::Mouse);
+	QCOMPARE(device->nativePath(), QString("hid-mouse"));
+	QVERIFY(!device->isLaptopBattery());
+
+	emit mock.upower.DeviceRemoved(QDBusObjectPath(MOUSE));
+	QTRY_COMPARE(upower.devices.valueList().length(), static_cast<qsizetype>(1));
+	QCOMPARE(upower.devices.valueList().at(0)->path(), QString(BATTERY));
+
+	connection.unregisterObject(MOUSE);
+}
+
+QTEST_MAIN(TestUPower);
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <qcontainerfwd.h>
+#include <qdbusextratypes.h>
+#include <qlist.h>
+#include <qobject.h>
+#include <qprocess.h>
+#include <qtmetamacros.h>
+#include <qtypes.h>
+
+// Stands in for org.freedesktop.UPower on the private bus.
+class MockUPower: public QObject {
+	Q_OBJECT;
+	Q_CLASSINFO("D-Bus Interface", "org.freedesktop.UPower");
+	Q_PROPERTY(bool OnBattery MEMBER onBattery);
+
+public:
+	bool onBattery = true;
+	QList<QDBusObjectPath> devices;
+
+public slots:
+	QList<QDBusObjectPath> EnumerateDevices(); // NOLINT
+	QDBusObjectPath GetDisplayDevice();        // NOLINT
+
+signals:
+	void DeviceAdded(const QDBusObjectPath& device);   // NOLINT
+	void DeviceRemoved(const QDBusObjectPath& device); // NOLINT
+};
+
+// Stands in for an org.freedesktop.UPower.Device on the private bus.
+class MockUPowerDevice: public QObject {
+	Q_OBJECT;
+	Q_CLASSINFO("D-Bus Interface", "org.freedesktop.UPower.Device");
+	Q_PROPERTY(QString NativePath MEMBER nativePath);
+	Q_PROPERTY(uint Type MEMBER type);
+	Q_PROPERTY(bool PowerSupply MEMBER powerSupply);
+	Q_PROPERTY(bool IsPresent MEMBER isPresent);
+	Q_PROPERTY(uint State MEMBER state);
+	Q_PROPERTY(double Percentage MEMBER percentage);
+	Q_PROPERTY(qlonglong TimeToEmpty MEMBER timeToEmpty);
+	Q_PROPERTY(QString IconName MEMBER iconName);
+
+public:
+	QString nativePath;
+	uint type = 2;
+	bool powerSupply = true;
+	bool isPresent = true;
+	uint state = 2;
+	double percentage = 50;
+	qlonglong timeToEmpty = 3600;
+	QString iconName = "battery-good-symbolic";
+};
+
+class TestUPower: public QObject {
+	Q_OBJECT;
+
+private slots:
+	void initTestCase();
+	void cleanupTestCase();
+	void initialState();
+	void propertiesChanged();
+	void deviceHotplug();
+
+private:
+	QProcess daemon;
+};